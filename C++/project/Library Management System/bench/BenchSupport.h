@@ -0,0 +1,64 @@
+#pragma once
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <nlohmann/json.hpp>
+
+// Set by bench/CMakeLists.txt; points at bench/fixtures in the source tree.
+#ifndef BENCH_FIXTURE_DIR
+#define BENCH_FIXTURE_DIR "fixtures"
+#endif
+
+namespace bench {
+
+// Reads a canned Open Library response from bench/fixtures.
+inline std::string loadFixture(const std::string& name) {
+    std::ifstream in(std::string(BENCH_FIXTURE_DIR) + "/" + name, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Missing benchmark fixture: " + name);
+    }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+// The default search fixture, with its docs repeated until there are `docs` of
+// them, so parse cost can be measured at different page sizes.
+inline std::string searchPayload(size_t docs) {
+    auto payload = nlohmann::json::parse(loadFixture("search_tolkien.json"));
+    const auto original = payload["docs"];
+    auto& out = payload["docs"];
+    out = nlohmann::json::array();
+    for (size_t i = 0; i < docs; ++i) {
+        out.push_back(original[i % original.size()]);
+    }
+    return payload.dump();
+}
+
+// Fresh database file in the system temp directory (any old copy is removed).
+inline std::string tempDbPath(const std::string& name) {
+    auto path = std::filesystem::temp_directory_path() / ("library_bench_" + name + ".db");
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::filesystem::remove(path.string() + suffix);
+    }
+    return path.string();
+}
+
+// Silences std::cout while in scope. LoanService reports every refused borrow
+// there; without this the benchmark would mostly time the terminal.
+class QuietStdout {
+public:
+    QuietStdout() : saved_(std::cout.rdbuf(nullptr)) {}
+    ~QuietStdout() { std::cout.rdbuf(saved_); }
+
+    QuietStdout(const QuietStdout&) = delete;
+    QuietStdout& operator=(const QuietStdout&) = delete;
+
+private:
+    std::streambuf* saved_;
+};
+
+} // namespace bench
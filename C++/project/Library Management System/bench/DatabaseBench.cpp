@@ -0,0 +1,136 @@
+#include "BenchSupport.h"
+#include "LoanRequestDB.h"
+#include "ReadListDB.h"
+#include "CatalogSnapshot.h"
+#include <benchmark/benchmark.h>
+
+static OnlineBook makeBook(int64_t n) {
+    OnlineBook b;
+    b.title = "Benchmark Book " + std::to_string(n);
+    b.author = "Bench Author";
+    b.publishYear = "1999";
+    b.subjects = {"Fantasy", "Fiction", "Adventure", "Dragons"};
+    b.workKey = "OL" + std::to_string(n) + "W";
+    return b;
+}
+
+// Inserts into the read list (row + FTS index). The argument is the number of
+// rows per transaction: 1 is the interactive "save one book" path, larger
+// values go through beginBatch()/commitBatch() like the UI's multi-save.
+static void BM_ReadListInsert(benchmark::State& state) {
+    ReadListDB db(bench::tempDbPath("read_list"));
+    const int64_t perTxn = state.range(0);
+    int64_t n = 0;
+    for (auto _ : state) {
+        if (perTxn == 1) {
+            db.insertBook(makeBook(n++));
+            continue;
+        }
+        db.beginBatch();
+        for (int64_t i = 0; i < perTxn; ++i) {
+            db.insertBook(makeBook(n++));
+        }
+        db.commitBatch();
+    }
+    state.SetItemsProcessed(n);
+}
+BENCHMARK(BM_ReadListInsert)->Arg(1)->Arg(100);
+
+// Same for loan requests; batches use insertLoans().
+static void BM_LoanInsert(benchmark::State& state) {
+    LoanRequestDB db(bench::tempDbPath("loans"));
+    const int64_t perTxn = state.range(0);
+    std::vector<LoanRecord> records;
+    for (int64_t i = 0; i < perTxn; ++i) {
+        LoanRecord record;
+        record.bookTitle = "Benchmark Book " + std::to_string(i);
+        record.borrowDay = util::toEpochDay(2024, 1, 1);
+        record.dueDay = record.borrowDay + 21;
+        records.push_back(std::move(record));
+    }
+    for (auto _ : state) {
+        if (perTxn == 1) {
+            db.insertLoan(records[0]);
+        } else {
+            db.insertLoans(records);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * perTxn);
+}
+BENCHMARK(BM_LoanInsert)->Arg(1)->Arg(100);
+
+// A ledger of `rows` loans, 90% already returned, with due dates spread over
+// two years from `firstDue`. Built once: the framework calls a benchmark
+// function several times while it settles on an iteration count.
+static LoanRequestDB& ledger(int64_t rows, util::EpochDay firstDue) {
+    static LoanRequestDB db(bench::tempDbPath("ledger"));
+    static bool filled = false;
+    if (!filled) {
+        std::vector<LoanRecord> records;
+        records.reserve(static_cast<size_t>(rows));
+        for (int64_t i = 0; i < rows; ++i) {
+            LoanRecord record;
+            record.bookTitle = "Ledger Book " + std::to_string(i);
+            record.dueDay = firstDue + static_cast<util::EpochDay>(i % 730);
+            record.borrowDay = record.dueDay - 21;
+            records.push_back(std::move(record));
+        }
+        db.insertLoans(records);
+        db.beginBatch();
+        for (int64_t id = 1; id <= rows; ++id) {
+            if (id % 10 != 0) db.markReturned(id, firstDue);
+        }
+        db.commitBatch();
+        filled = true;
+    }
+    return db;
+}
+
+// Overdue sweep: pages through every overdue loan with the keyset cursor,
+// 1000 at a time. The argument is the total ledger size.
+static void BM_OverdueSweep(benchmark::State& state) {
+    const util::EpochDay firstDue = util::toEpochDay(2023, 1, 1);
+    LoanRequestDB& db = ledger(state.range(0), firstDue);
+
+    const util::EpochDay asOf = firstDue + 365; // Half of the active loans are overdue
+    size_t swept = 0;
+    for (auto _ : state) {
+        std::optional<LoanCursor> cursor;
+        do {
+            LoanPage page = db.getOverdueLoans(asOf, 1000, cursor);
+            swept += page.loans.size();
+            cursor = page.next;
+        } while (cursor);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(swept));
+    state.counters["overdue"] = static_cast<double>(db.countOverdue(asOf));
+}
+BENCHMARK(BM_OverdueSweep)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+// Borrow-check lookup in a mapped catalog snapshot of `rows` titles, half of
+// the probes hitting. Includes the watcher's shared_ptr load, as LoanService does.
+static void BM_SnapshotLookup(benchmark::State& state) {
+    const int64_t rows = state.range(0);
+    const std::string path = bench::tempDbPath("snapshot");
+    std::vector<OnlineBook> books;
+    books.reserve(static_cast<size_t>(rows));
+    for (int64_t i = 0; i < rows; ++i) {
+        books.push_back(makeBook(i));
+    }
+    std::string error;
+    CatalogSnapshot::write(path, books, error);
+    SnapshotWatcher watcher(path);
+
+    std::vector<std::string> probes;
+    for (int64_t i = 0; i < 1024; ++i) {
+        probes.push_back((i % 2 ? "benchmark book " : "missing book ") + std::to_string(i * 7919 % rows));
+    }
+    size_t n = 0, found = 0;
+    for (auto _ : state) {
+        auto snapshot = watcher.current();
+        found += snapshot->contains(probes[n++ % probes.size()]);
+    }
+    benchmark::DoNotOptimize(found);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SnapshotLookup)->Arg(1000000);
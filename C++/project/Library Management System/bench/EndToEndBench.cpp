@@ -0,0 +1,77 @@
+#include "BenchSupport.h"
+#include "HttpClient.h"
+#include "LoanService.h"
+#include "OnlineBookService.h"
+#include "RecommenderService.h"
+#include "SearchCache.h"
+#include "StubServer.h"
+#include <benchmark/benchmark.h>
+
+// One stub server for the whole run, and a client pointed at it. The client is
+// constructed second, so it is destroyed first, while the server still runs.
+static HttpClient& stubClient() {
+    static StubServer server(bench::loadFixture("search_tolkien.json"));
+    static HttpClient client([] {
+        HttpClientOptions options;
+        options.baseUrl = server.baseUrl();
+        options.http2 = false; // Plain-text loopback; there is no TLS to negotiate
+        options.rateLimit.requestsPerSecond = 0; // Measure our code, not the politeness limit
+        return options;
+    }());
+    return client;
+}
+
+// These spend most of their time waiting on a socket, so wall time is reported.
+
+static void BM_SearchEndToEnd(benchmark::State& state) {
+    OnlineBookService service(nullptr, &stubClient());
+    for (auto _ : state) {
+        auto books = service.search("tolkien", 20);
+        benchmark::DoNotOptimize(books.data());
+    }
+}
+BENCHMARK(BM_SearchEndToEnd)->UseRealTime();
+
+// Repeated query served from the in-memory cache tier: no request at all.
+static void BM_SearchCachedEndToEnd(benchmark::State& state) {
+    SearchCache cache(""); // Memory-only
+    OnlineBookService service(&cache, &stubClient());
+    service.search("tolkien", 20); // Warm the cache
+    for (auto _ : state) {
+        auto books = service.search("tolkien", 20);
+        benchmark::DoNotOptimize(books.data());
+    }
+}
+BENCHMARK(BM_SearchCachedEndToEnd)->UseRealTime();
+
+// Argument selects the mode: 0 = AllSubjects (one request), 1 = AnySubject
+// (one request per subject, fanned out and merged). A service per call, so
+// AnySubject builds its ranking every time rather than paging a cached one.
+static void BM_RecommendEndToEnd(benchmark::State& state) {
+    const auto mode = state.range(0) == 0 ? RecommendMode::AllSubjects : RecommendMode::AnySubject;
+    const std::vector<std::string> subjects = {"Fantasy", "Dragons", "Adventure"};
+    for (auto _ : state) {
+        RecommenderService service(&stubClient());
+        auto books = service.recommend(subjects, 5, 0, mode);
+        benchmark::DoNotOptimize(books.data());
+    }
+}
+BENCHMARK(BM_RecommendEndToEnd)->Arg(0)->Arg(1)->UseRealTime();
+
+// Catalog check plus one loan row written to SQLite. Arg 0 expires catalog
+// answers at once, so every borrow asks over HTTP; arg 1 answers repeats from
+// the catalog existence cache.
+static void BM_BorrowBookEndToEnd(benchmark::State& state) {
+    bench::QuietStdout quiet;
+    OnlineBookService onlineService(nullptr, &stubClient());
+    CatalogCacheOptions cacheOptions;
+    if (state.range(0) == 0) {
+        cacheOptions.foundTtl = cacheOptions.missingTtl = std::chrono::milliseconds(0);
+    }
+    LoanService loans(onlineService, bench::tempDbPath("borrow"), cacheOptions);
+    for (auto _ : state) {
+        auto result = loans.borrowBook("The Hobbit");
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_BorrowBookEndToEnd)->Arg(0)->Arg(1)->UseRealTime();
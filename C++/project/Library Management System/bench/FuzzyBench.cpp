@@ -0,0 +1,56 @@
+#include "FuzzyTitleIndex.h"
+#include <benchmark/benchmark.h>
+#include <random>
+
+// `count` titles of two to five words drawn from a 5000-word vocabulary of
+// made-up words, so word and trigram frequencies are skewed as in a real catalog.
+static std::vector<std::string> syntheticTitles(size_t count) {
+    std::mt19937 rng(7);
+    std::vector<std::string> vocabulary;
+    std::uniform_int_distribution<int> letter(0, 25), wordLength(3, 9);
+    for (int i = 0; i < 5000; ++i) {
+        std::string word(static_cast<size_t>(wordLength(rng)), 'a');
+        for (auto& c : word) c = static_cast<char>('a' + letter(rng));
+        vocabulary.push_back(std::move(word));
+    }
+    std::geometric_distribution<size_t> pick(0.002); // Low ranks are common words
+    std::uniform_int_distribution<int> words(2, 5);
+    std::vector<std::string> titles;
+    titles.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string title;
+        for (int w = words(rng); w > 0; --w) {
+            if (!title.empty()) title += ' ';
+            title += vocabulary[pick(rng) % vocabulary.size()];
+        }
+        titles.push_back(std::move(title));
+    }
+    return titles;
+}
+
+// Built once: the framework calls a benchmark function several times.
+static const FuzzyTitleIndex& millionTitles() {
+    static const FuzzyTitleIndex index(syntheticTitles(1000000));
+    return index;
+}
+
+// Top-5 lookup of a catalog title with two typos (a substitution and a
+// deletion) over a million titles.
+static void BM_FuzzyMatch(benchmark::State& state) {
+    const FuzzyTitleIndex& index = millionTitles();
+    std::vector<std::string> queries;
+    for (uint32_t i = 0; queries.size() < 256; ++i) {
+        std::string q = index.title(static_cast<uint32_t>(i * 3911ull % index.size()));
+        if (q.size() < 8) continue;
+        q[q.size() / 3] = q[q.size() / 3] == 'x' ? 'y' : 'x';
+        q.erase(q.size() * 2 / 3, 1);
+        queries.push_back(std::move(q));
+    }
+    size_t n = 0, found = 0;
+    for (auto _ : state) {
+        found += index.match(queries[n++ % queries.size()]).size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["found"] = static_cast<double>(found) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_FuzzyMatch)->Unit(benchmark::kMicrosecond);
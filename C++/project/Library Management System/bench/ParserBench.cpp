@@ -0,0 +1,50 @@
+#include "BenchSupport.h"
+#include "OpenLibraryParser.h"
+#include <benchmark/benchmark.h>
+
+using json = nlohmann::json;
+
+// The production path: streaming SAX parse straight into OnlineBook.
+static void BM_ParseSearchSax(benchmark::State& state) {
+    const std::string body = bench::searchPayload(static_cast<size_t>(state.range(0)));
+    const OpenLibraryParser parser(4);
+    for (auto _ : state) {
+        std::vector<OnlineBook> books;
+        parser.parse(body, books);
+        benchmark::DoNotOptimize(books.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseSearchSax)->Arg(20)->Arg(100)->Arg(1000);
+
+// Baseline: build the full json DOM first, then copy fields out of it.
+// Kept to show what the SAX parser saves; not used by the app.
+static void BM_ParseSearchDom(benchmark::State& state) {
+    const std::string body = bench::searchPayload(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::vector<OnlineBook> books;
+        auto j = json::parse(body, nullptr, false);
+        for (const auto& doc : j["docs"]) {
+            OnlineBook b;
+            b.title = doc.value("title", "N/A");
+            b.author = doc.contains("author_name") && !doc["author_name"].empty()
+                     ? doc["author_name"][0].get<std::string>() : "Unknown Author";
+            b.publishYear = doc.contains("first_publish_year")
+                          ? std::to_string(doc["first_publish_year"].get<int>()) : "N/A";
+            b.coverId = doc.value("cover_i", 0);
+            if (doc.contains("subject")) {
+                for (const auto& sub : doc["subject"]) {
+                    if (b.subjects.size() == 4) break;
+                    b.subjects.push_back(sub.get<std::string>());
+                }
+            }
+            b.workKey = OnlineBook::workKeyFromUrl(doc.value("key", ""));
+            books.push_back(std::move(b));
+        }
+        benchmark::DoNotOptimize(books.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseSearchDom)->Arg(20)->Arg(100)->Arg(1000);
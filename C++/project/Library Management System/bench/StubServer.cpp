@@ -0,0 +1,111 @@
+#include "StubServer.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstring>
+#include <stdexcept>
+
+StubServer::StubServer(std::string body)
+    : listenFd_(-1), port_(0), stopping_(false), requests_(0) {
+    response_ = "HTTP/1.1 200 OK\r\n"
+                "Content-Type: application/json\r\n"
+                "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                "Connection: keep-alive\r\n"
+                "\r\n" + body;
+
+    listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd_ < 0) {
+        throw std::runtime_error("StubServer: socket() failed");
+    }
+    int yes = 1;
+    ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0; // Let the kernel pick a free port
+    socklen_t len = sizeof(addr);
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listenFd_, 64) != 0 ||
+        ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        ::close(listenFd_);
+        throw std::runtime_error("StubServer: cannot listen on 127.0.0.1");
+    }
+    port_ = ntohs(addr.sin_port);
+
+    acceptThread_ = std::thread(&StubServer::acceptLoop, this);
+}
+
+StubServer::~StubServer() {
+    stopping_ = true;
+    ::shutdown(listenFd_, SHUT_RDWR); // Wakes the blocked accept()
+    acceptThread_.join();
+    ::close(listenFd_);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int fd : clientFds_) {
+        ::shutdown(fd, SHUT_RDWR); // Wakes a blocked recv()
+    }
+    for (auto& t : clientThreads_) {
+        t.join();
+    }
+    // Closed only here, after every serve() returned, so no fd is reused under us.
+    for (int fd : clientFds_) {
+        ::close(fd);
+    }
+}
+
+std::string StubServer::baseUrl() const {
+    return "http://127.0.0.1:" + std::to_string(port_);
+}
+
+void StubServer::acceptLoop() {
+    while (!stopping_) {
+        int fd = ::accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) {
+            continue; // Shut down, or a transient error
+        }
+        int yes = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            ::close(fd);
+            break;
+        }
+        clientFds_.push_back(fd);
+        clientThreads_.emplace_back(&StubServer::serve, this, fd);
+    }
+}
+
+// Reads requests off one connection and answers each with the canned response.
+// Only the end of the header block matters; GET requests carry no body.
+void StubServer::serve(int fd) {
+    std::string pending;
+    char buf[4096];
+    while (true) {
+        ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) {
+            break; // Client closed, or the destructor shut the socket down
+        }
+        pending.append(buf, static_cast<size_t>(n));
+
+        size_t end;
+        while ((end = pending.find("\r\n\r\n")) != std::string::npos) {
+            pending.erase(0, end + 4);
+            const char* p = response_.data();
+            size_t left = response_.size();
+            while (left > 0) {
+                ssize_t sent = ::send(fd, p, left, MSG_NOSIGNAL);
+                if (sent <= 0) {
+                    return;
+                }
+                p += sent;
+                left -= static_cast<size_t>(sent);
+            }
+            ++requests_;
+        }
+    }
+}
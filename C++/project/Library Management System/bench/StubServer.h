@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Minimal HTTP/1.1 server on 127.0.0.1 that answers every GET with the same
+// canned JSON body. It stands in for openlibrary.org so end-to-end benchmarks
+// measure our own code (plus loopback TCP), not the internet.
+//
+// Connections are kept alive, like the real server, so a pooled HttpClient
+// reuses its sockets. One thread per connection; meant for a handful of clients.
+class StubServer {
+public:
+    // Binds an ephemeral port and starts accepting. Throws std::runtime_error
+    // if the socket cannot be set up.
+    explicit StubServer(std::string body);
+
+    // Stops accepting, closes every open connection and joins all threads.
+    ~StubServer();
+
+    StubServer(const StubServer&) = delete;
+    StubServer& operator=(const StubServer&) = delete;
+
+    // "http://127.0.0.1:<port>", suitable for HttpClientOptions::baseUrl.
+    std::string baseUrl() const;
+
+    // Number of requests answered so far.
+    uint64_t requestCount() const { return requests_.load(); }
+
+private:
+    std::string response_; // Full HTTP response, headers included, built once
+    int listenFd_;
+    uint16_t port_;
+    std::atomic<bool> stopping_;
+    std::atomic<uint64_t> requests_;
+
+    std::mutex mutex_; // Guards the two vectors below
+    std::vector<int> clientFds_;
+    std::vector<std::thread> clientThreads_;
+    std::thread acceptThread_;
+
+    void acceptLoop();
+    void serve(int fd);
+};
@@ -0,0 +1,40 @@
+#include "StringUtils.h"
+#include <benchmark/benchmark.h>
+#include <random>
+
+// Catalog-like titles: capitalized words, some punctuation and a subtitle.
+static const std::vector<std::string>& sampleTitles() {
+    static const std::vector<std::string> titles = [] {
+        std::mt19937 rng(11);
+        std::uniform_int_distribution<int> letter(0, 25), wordLength(2, 10), words(2, 9), punctuation(0, 5);
+        std::vector<std::string> out;
+        for (int i = 0; i < 100000; ++i) {
+            std::string title;
+            for (int w = words(rng); w > 0; --w) {
+                if (!title.empty()) title += punctuation(rng) == 0 ? ": " : " ";
+                title += static_cast<char>('A' + letter(rng));
+                for (int n = wordLength(rng); n > 1; --n) title += static_cast<char>('a' + letter(rng));
+            }
+            out.push_back(std::move(title));
+        }
+        return out;
+    }();
+    return titles;
+}
+
+// util::normalizeTitles over 100k titles with the kernel width forced to
+// scalar (0), SSE2 (1) or AVX2 (2); widths the CPU lacks run the next best.
+static void BM_NormalizeTitles(benchmark::State& state) {
+    const auto& titles = sampleTitles();
+    const util::SimdLevel previous = util::simdLevel();
+    const util::SimdLevel used = util::setSimdLevel(static_cast<util::SimdLevel>(state.range(0)));
+    size_t bytes = 0;
+    for (const auto& t : titles) bytes += t.size();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(util::normalizeTitles(titles));
+    }
+    util::setSimdLevel(previous);
+    state.SetLabel(util::simdLevelName(used));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+BENCHMARK(BM_NormalizeTitles)->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,66 @@
+#ifndef CANCELLATION_TOKEN_H
+#define CANCELLATION_TOKEN_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+// Thrown (through the future, for the *Async calls) when an operation stops
+// because its token was cancelled or its deadline passed.
+class OperationCancelled : public std::runtime_error {
+public:
+    OperationCancelled() : std::runtime_error("operation cancelled or deadline exceeded") {}
+};
+
+// Lets the caller of a long-running service call stop it early.
+//
+// Copies share one state, so the caller keeps a copy and hands another to the
+// operation. The token is "cancelled" once cancel() is called on any copy or
+// its deadline (if any) has passed. Operations check it between steps and
+// bound each network request by the time remaining; a request already on the
+// wire runs to its timeout or the deadline, whichever comes first.
+class CancellationToken {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // A token with no deadline that is only cancelled by cancel().
+    CancellationToken() : state_(std::make_shared<State>()) {}
+
+    // A token that cancels itself `timeout` from now.
+    static CancellationToken withTimeout(std::chrono::milliseconds timeout) {
+        CancellationToken token;
+        token.state_->deadline = Clock::now() + timeout;
+        return token;
+    }
+
+    void cancel() const { state_->cancelled.store(true, std::memory_order_relaxed); }
+
+    bool cancelled() const {
+        return state_->cancelled.load(std::memory_order_relaxed) ||
+               (state_->deadline && Clock::now() >= *state_->deadline);
+    }
+
+    void throwIfCancelled() const {
+        if (cancelled()) throw OperationCancelled();
+    }
+
+    // Time left before the deadline (zero once passed); empty if there is none.
+    std::optional<std::chrono::milliseconds> remaining() const {
+        if (!state_->deadline) return std::nullopt;
+        // Rounded up, so a timeout set from it does not fire just before the deadline
+        auto left = std::chrono::ceil<std::chrono::milliseconds>(*state_->deadline - Clock::now());
+        return std::max(left, std::chrono::milliseconds(0));
+    }
+
+private:
+    struct State {
+        std::atomic<bool> cancelled{false};
+        std::optional<Clock::time_point> deadline; // Set once, before the token is shared
+    };
+    std::shared_ptr<State> state_;
+};
+
+#endif // CANCELLATION_TOKEN_H
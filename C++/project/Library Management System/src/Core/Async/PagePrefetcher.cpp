@@ -0,0 +1,40 @@
+#include "PagePrefetcher.h"
+
+// Two workers so a newer prefetch does not queue behind an abandoned request
+// that is still waiting on the network.
+PagePrefetcher::PagePrefetcher() : pool_(2) {}
+
+void PagePrefetcher::prefetch(const std::string& sessionKey, size_t offset, FetchFn fetch) {
+    if (pending_ && pending_->sessionKey == sessionKey && pending_->offset == offset) {
+        return; // Already on its way
+    }
+    cancel();
+
+    CancellationToken token;
+    auto result = pool_.submit([token, fetch = std::move(fetch)]() -> Page {
+        if (token.cancelled()) return {}; // Abandoned before it started
+        return fetch(token);
+    });
+    pending_ = Pending{sessionKey, offset, std::move(token), std::move(result)};
+}
+
+std::optional<PagePrefetcher::Page> PagePrefetcher::take(const std::string& sessionKey, size_t offset) {
+    if (!pending_) return std::nullopt;
+
+    if (pending_->sessionKey != sessionKey || pending_->offset != offset) {
+        cancel(); // Stale prefetch for some other page
+        return std::nullopt;
+    }
+
+    Page page = pending_->result.get();
+    pending_.reset();
+    return page;
+}
+
+void PagePrefetcher::cancel() {
+    if (!pending_) return;
+    // Futures from packaged_task do not block on destruction, so dropping it
+    // here returns immediately; the worker finishes (or skips) on its own.
+    pending_->token.cancel();
+    pending_.reset();
+}
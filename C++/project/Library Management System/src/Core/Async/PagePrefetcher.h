@@ -0,0 +1,50 @@
+#ifndef PAGE_PREFETCHER_H
+#define PAGE_PREFETCHER_H
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "OnlineBookService.h" // For the OnlineBook struct
+#include "ThreadPool.h"
+#include "CancellationToken.h"
+
+// Fetches the next page of a paginated session in the background while the
+// current page is on screen. At most one page is outstanding at a time.
+//
+// Pages are identified by a session key (the query, or the chosen subjects)
+// plus the page offset. Starting a prefetch for a different page, or calling
+// cancel(), abandons the outstanding one: its token is cancelled, so it is
+// skipped if it has not started and stops before its next request otherwise.
+class PagePrefetcher {
+public:
+    using Page = std::vector<OnlineBook>;
+    using FetchFn = std::function<Page(const CancellationToken&)>;
+
+    PagePrefetcher();
+
+    // Starts fetching the page at `offset` for `sessionKey` in the background.
+    void prefetch(const std::string& sessionKey, size_t offset, FetchFn fetch);
+
+    // Returns the prefetched page if it matches the requested one, waiting for
+    // it to finish if it is still in flight. Returns empty optional otherwise.
+    std::optional<Page> take(const std::string& sessionKey, size_t offset);
+
+    // Abandons any outstanding prefetch (e.g. when the query or subjects change).
+    void cancel();
+
+private:
+    struct Pending {
+        std::string sessionKey;
+        size_t offset;
+        CancellationToken token;
+        std::future<Page> result;
+    };
+
+    std::optional<Pending> pending_;
+    ThreadPool pool_; // Declared last so workers are joined before pending_ goes away
+};
+
+#endif // PAGE_PREFETCHER_H
@@ -0,0 +1,89 @@
+#ifndef SINGLE_FLIGHT_H
+#define SINGLE_FLIGHT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+#include "CancellationToken.h"
+
+// Coalesces concurrent identical calls: while a call for a key is in flight,
+// further calls for that key wait for its result instead of starting their own.
+// Nothing is kept once the call completes; this is not a cache.
+//
+// Every waiting caller gets a copy of the value, or the exception it threw.
+// A waiting caller still honours its own token. If the call it waits on was
+// cancelled by *its* caller, a waiter that is still live runs the call again.
+template <class Key, class Value, class Hash = std::hash<Key>>
+class SingleFlight {
+public:
+    template <class Fn>
+    Value run(const Key& key, const CancellationToken& token, Fn&& fn);
+
+    // Calls that were answered by another caller's in-flight call.
+    uint64_t coalesced() const { return coalesced_.load(std::memory_order_relaxed); }
+
+private:
+    std::mutex mutex_; // Guards inflight_
+    std::unordered_map<Key, std::shared_future<Value>, Hash> inflight_;
+    std::atomic<uint64_t> coalesced_{0};
+
+    void finish(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        inflight_.erase(key);
+    }
+};
+
+template <class Key, class Value, class Hash>
+template <class Fn>
+Value SingleFlight<Key, Value, Hash>::run(const Key& key, const CancellationToken& token, Fn&& fn) {
+    for (;;) {
+        std::promise<Value> promise;
+        std::shared_future<Value> result;
+        bool leader = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = inflight_.find(key);
+            if (it == inflight_.end()) {
+                result = promise.get_future().share();
+                inflight_.emplace(key, result);
+                leader = true;
+            } else {
+                result = it->second;
+                coalesced_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        if (leader) {
+            // The key leaves the table before waiters are released, so a call
+            // arriving after completion starts afresh rather than reusing this one.
+            try {
+                Value value = fn();
+                finish(key);
+                promise.set_value(value);
+                return value;
+            } catch (...) {
+                finish(key);
+                promise.set_exception(std::current_exception());
+                throw;
+            }
+        }
+
+        // Wait in short slices so our own cancellation or deadline still applies.
+        while (result.wait_for(std::chrono::milliseconds(20)) != std::future_status::ready) {
+            token.throwIfCancelled();
+        }
+        try {
+            return result.get();
+        } catch (const OperationCancelled&) {
+            token.throwIfCancelled();
+            // The leader's caller gave up, not us: go again, most likely as the leader.
+        }
+    }
+}
+
+#endif // SINGLE_FLIGHT_H
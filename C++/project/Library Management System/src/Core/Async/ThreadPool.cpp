@@ -0,0 +1,41 @@
+#include "ThreadPool.h"
+
+// Constructor: Starts the worker threads.
+ThreadPool::ThreadPool(size_t threads) : stopping_(false) {
+    if (threads == 0) threads = 1;
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+// Destructor: Lets the workers finish the queue, then joins them.
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool(kSharedThreads);
+    return pool;
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) return; // Stopping and nothing left to run
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task(); // Exceptions are captured by the packaged_task into the future
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed-size pool of worker threads fed from a FIFO queue.
+// The destructor runs every task that was already queued, then joins the workers.
+class ThreadPool {
+public:
+    // Starts `threads` workers (at least one).
+    explicit ThreadPool(size_t threads);
+
+    // Destructor: Drains the queue and joins all workers.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Process-wide pool that runs the services' *Async calls. Its workers spend
+    // most of their time waiting on the network, so it is sized for concurrent
+    // requests rather than for cores; calls beyond that wait in the queue.
+    // Its tasks must not wait on other tasks of this pool (fan-outs use a local pool).
+    static ThreadPool& shared();
+
+    static constexpr size_t kSharedThreads = 16;
+
+    // Queues a callable and returns a future for its result.
+    template <class F>
+    auto submit(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>>;
+
+    // Number of worker threads.
+    size_t size() const { return workers_.size(); }
+
+private:
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_;
+
+    void workerLoop();
+};
+
+template <class F>
+auto ThreadPool::submit(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+    using Result = std::invoke_result_t<std::decay_t<F>>;
+
+    // std::function needs a copyable target, so the packaged_task lives behind a shared_ptr.
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(f));
+    std::future<Result> future = task->get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.emplace_back([task]() { (*task)(); });
+    }
+    cv_.notify_one();
+    return future;
+}
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,155 @@
+#include "BatchRunner.h"
+#include "OnlineBookService.h"
+#include "RecommenderService.h"
+#include "LoanService.h"
+#include "ReadListDB.h"
+#include "ThreadPool.h"
+#include "CancellationToken.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+using json = nlohmann::json;
+
+// Same field names as ReadListDB::exportJson.
+static json toJson(const OnlineBook& b) {
+    return {
+        {"title", b.title},
+        {"author", b.author},
+        {"publishYear", b.publishYear},
+        {"subjects", b.subjects},
+        {"workKey", b.workKey},
+        {"coverId", b.coverId},
+        {"url", b.openLibraryUrl()}
+    };
+}
+
+static json toJson(const std::vector<OnlineBook>& books) {
+    json arr = json::array();
+    for (const auto& b : books) {
+        arr.push_back(toJson(b));
+    }
+    return arr;
+}
+
+static OnlineBook bookFromJson(const json& j) {
+    OnlineBook b;
+    b.title = j.at("title").get<std::string>();
+    b.author = j.value("author", "");
+    b.publishYear = j.value("publishYear", "");
+    b.subjects = j.value("subjects", std::vector<std::string>{});
+    b.workKey = j.value("workKey", "");
+    b.coverId = j.value("coverId", int64_t{0});
+    return b;
+}
+
+BatchRunner::BatchRunner(OnlineBookService& search, RecommenderService& recommender, LoanService& loans,
+                         std::shared_ptr<ReadListDB> readList, const BatchOptions& options)
+    : search_(search), recommender_(recommender), loans_(loans), readList_(std::move(readList)), options_(options)
+{
+    if (options_.workers == 0) options_.workers = 1;
+    if (options_.maxQueued == 0) options_.maxQueued = 4 * options_.workers;
+}
+
+json BatchRunner::execute(const json& command) {
+    json response = json::object();
+    if (command.contains("id")) {
+        response["id"] = command["id"];
+    }
+    const std::string op = command.is_object() ? command.value("op", "") : "";
+    response["op"] = op;
+
+    try {
+        if (!command.is_object()) throw std::invalid_argument("command must be a JSON object");
+        response["result"] = dispatch(op, command);
+        response["ok"] = true;
+    } catch (const OperationCancelled&) {
+        response["ok"] = false;
+        response["error"] = "deadline exceeded";
+    } catch (const std::exception& e) { // Bad arguments (json type/out_of_range errors included)
+        response["ok"] = false;
+        response["error"] = e.what();
+    }
+    return response;
+}
+
+json BatchRunner::dispatch(const std::string& op, const json& command) {
+    CancellationToken token;
+    if (command.contains("timeoutMs")) {
+        token = CancellationToken::withTimeout(std::chrono::milliseconds(command["timeoutMs"].get<int64_t>()));
+    }
+    const size_t limit = command.value("limit", size_t{5});
+    const size_t offset = command.value("offset", size_t{0});
+
+    if (op == "search") {
+        return toJson(search_.search(command.at("query").get<std::string>(), limit, offset, token));
+    }
+    if (op == "recommend") {
+        const std::string mode = command.value("mode", "all");
+        if (mode != "all" && mode != "any") throw std::invalid_argument("mode must be \"all\" or \"any\"");
+        return toJson(recommender_.recommend(command.at("subjects").get<std::vector<std::string>>(), limit, offset,
+                                             mode == "any" ? RecommendMode::AnySubject : RecommendMode::AllSubjects,
+                                             token));
+    }
+    if (op == "borrow") {
+        auto loan = loans_.borrowBook(command.at("title").get<std::string>(), token);
+        if (!loan) return {{"borrowed", false}};
+        return {{"borrowed", true}, {"borrowDate", loan->borrowDate}, {"dueDate", loan->dueDate}};
+    }
+    if (op == "addToReadList") {
+        const OnlineBook book = bookFromJson(command.at("book"));
+        if (!book.workKey.empty() && readList_->exists(book.workKey)) {
+            return {{"added", false}, {"reason", "already in read list"}};
+        }
+        if (!readList_->insertBook(book)) throw std::runtime_error("failed to save book");
+        return {{"added", true}};
+    }
+    throw std::invalid_argument(op.empty() ? "missing \"op\"" : "unknown op \"" + op + "\"");
+}
+
+BatchStats BatchRunner::run(std::istream& in, std::ostream& out) {
+    BatchStats stats;
+    std::mutex mutex;                 // Guards out, stats and queued
+    std::condition_variable slotFree;
+    size_t queued = 0;                // Read but not yet answered
+
+    {
+        ThreadPool pool(options_.workers);
+        std::string line;
+        size_t lineNo = 0;
+        while (std::getline(in, line)) {
+            ++lineNo;
+            if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+            // Reading ahead is capped, so a huge replay file is not loaded into the queue at once.
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                slotFree.wait(lock, [&]() { return queued < options_.maxQueued; });
+                ++queued;
+            }
+
+            pool.submit([this, &out, &stats, &mutex, &slotFree, &queued, lineNo, line = std::move(line)]() {
+                json command = json::parse(line, nullptr, false);
+                json response;
+                if (command.is_discarded()) {
+                    response = {{"ok", false}, {"error", "invalid JSON"}};
+                } else {
+                    response = execute(command);
+                }
+                response["line"] = lineNo;
+                // Titles from the network are not guaranteed valid UTF-8.
+                const std::string text = response.dump(-1, ' ', false, json::error_handler_t::replace);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                out << text << '\n' << std::flush; // Results stream out as they finish
+                ++stats.commands;
+                if (!response["ok"].get<bool>()) ++stats.failed;
+                --queued;
+                slotFree.notify_one();
+            });
+        }
+    } // The pool's destructor waits for the remaining commands
+    return stats;
+}
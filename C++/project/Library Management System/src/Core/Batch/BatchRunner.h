@@ -0,0 +1,66 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <nlohmann/json.hpp>
+
+class OnlineBookService;
+class RecommenderService;
+class LoanService;
+class ReadListDB;
+
+// Settings for a headless batch run.
+struct BatchOptions {
+    size_t workers = 8;     // Commands executed at the same time
+    size_t maxQueued = 0;   // Commands read ahead of the workers; 0 = 4 per worker
+};
+
+// Totals for one run.
+struct BatchStats {
+    size_t commands = 0; // Non-blank input lines
+    size_t failed = 0;   // Lines answered with "ok": false
+};
+
+// Drives the service layer from newline-delimited JSON commands instead of the
+// interactive menus, e.g. to replay recorded traffic or load-test the services.
+//
+// One command per line; blank lines are skipped. Every command may carry an
+// "id" (echoed back) and "timeoutMs" (a deadline for the whole command):
+//   {"op":"search","query":"dune","limit":5,"offset":0}
+//   {"op":"recommend","subjects":["Fantasy","Horror"],"mode":"any","limit":5,"offset":0}
+//   {"op":"borrow","title":"The Hobbit"}
+//   {"op":"addToReadList","book":{"title":"...","author":"...","workKey":"OL262758W",...}}
+//
+// Each command produces exactly one JSON line on the output, written as soon as
+// it completes (so in completion order, not input order):
+//   {"line":3,"id":...,"op":"search","ok":true,"result":[...books...]}
+//   {"line":4,"op":"borrow","ok":false,"error":"..."}
+// Books use the field names of ReadListDB::exportJson.
+class BatchRunner {
+public:
+    // None of the services are owned; all must outlive the runner.
+    BatchRunner(OnlineBookService& search, RecommenderService& recommender, LoanService& loans,
+                std::shared_ptr<ReadListDB> readList, const BatchOptions& options = {});
+
+    // Reads commands from `in` until EOF and runs them on a pool of
+    // options.workers threads, streaming one result line per command to `out`.
+    // Returns once every command has been answered.
+    BatchStats run(std::istream& in, std::ostream& out);
+
+    // Runs one parsed command and returns its result line (without "line").
+    nlohmann::json execute(const nlohmann::json& command);
+
+private:
+    OnlineBookService& search_;
+    RecommenderService& recommender_;
+    LoanService& loans_;
+    std::shared_ptr<ReadListDB> readList_;
+    BatchOptions options_;
+
+    nlohmann::json dispatch(const std::string& op, const nlohmann::json& command);
+};
+
+#endif // BATCH_RUNNER_H
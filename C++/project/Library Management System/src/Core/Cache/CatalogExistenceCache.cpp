@@ -0,0 +1,153 @@
+#include "CatalogExistenceCache.h"
+#include "StringUtils.h"
+#include <algorithm>
+#include <functional>
+#include <unordered_set>
+
+BloomFilter::BloomFilter(size_t capacity)
+    : words_((std::max<size_t>(capacity, 1) * 10 + 63) / 64, 0),
+      bitCount_(words_.size() * 64)
+{}
+
+void BloomFilter::hashes(const std::string& key, uint64_t& h1, uint64_t& h2) const {
+    h1 = std::hash<std::string>{}(key);
+    // FNV-1a as the second, independent hash; odd so every probe lands on a new bit.
+    h2 = 14695981039346656037ull;
+    for (unsigned char c : key) {
+        h2 = (h2 ^ c) * 1099511628211ull;
+    }
+    h2 |= 1;
+}
+
+void BloomFilter::add(const std::string& key) {
+    uint64_t h1, h2;
+    hashes(key, h1, h2);
+    for (unsigned i = 0; i < kProbes; ++i) {
+        const uint64_t bit = (h1 + i * h2) % bitCount_;
+        words_[bit / 64] |= uint64_t{1} << (bit % 64);
+    }
+}
+
+bool BloomFilter::mightContain(const std::string& key) const {
+    uint64_t h1, h2;
+    hashes(key, h1, h2);
+    for (unsigned i = 0; i < kProbes; ++i) {
+        const uint64_t bit = (h1 + i * h2) % bitCount_;
+        if (!(words_[bit / 64] & (uint64_t{1} << (bit % 64)))) return false;
+    }
+    return true;
+}
+
+void BloomFilter::clear() {
+    std::fill(words_.begin(), words_.end(), 0);
+}
+
+size_t CatalogExistenceCache::TtlSet::insert(const std::string& key, Clock::time_point expiry, size_t capacity,
+                                             Clock::time_point now) {
+    if (expiresAt.insert_or_assign(key, expiry).second) {
+        order.push_back(key);
+    }
+
+    // Drop expired keys from the front, then the oldest live ones if still over capacity.
+    // A refreshed key keeps its old place in `order`, so it may go a little early.
+    size_t dropped = 0;
+    while (!order.empty()) {
+        auto front = expiresAt.find(order.front());
+        if (front == expiresAt.end()) { // Erased since: nothing to drop, but it must not block the rest
+            order.pop_front();
+            continue;
+        }
+        if (front->second > now && expiresAt.size() <= capacity) break;
+        expiresAt.erase(front);
+        ++dropped;
+        order.pop_front();
+    }
+
+    // Keys erased behind a live front leave entries the loop above cannot reach yet.
+    if (order.size() > 2 * expiresAt.size() + 16) {
+        compact();
+    }
+    return dropped;
+}
+
+// Rebuilds `order` from the live keys, each at its latest insertion.
+void CatalogExistenceCache::TtlSet::compact() {
+    std::unordered_set<std::string> seen;
+    std::deque<std::string> live;
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        if (expiresAt.count(*it) && seen.insert(*it).second) {
+            live.push_front(std::move(*it));
+        }
+    }
+    order = std::move(live);
+}
+
+bool CatalogExistenceCache::TtlSet::contains(const std::string& key, Clock::time_point now) const {
+    auto it = expiresAt.find(key);
+    return it != expiresAt.end() && it->second > now;
+}
+
+void CatalogExistenceCache::TtlSet::erase(const std::string& key) {
+    expiresAt.erase(key); // Its `order` entry is skipped when it reaches the front
+}
+
+CatalogExistenceCache::CatalogExistenceCache(const CatalogCacheOptions& options)
+    : options_(options), missingFilter_(options.capacity)
+{}
+
+std::string CatalogExistenceCache::normalize(const std::string& title) {
+    return util::toLower(util::trim(title));
+}
+
+CatalogExistenceCache::Status CatalogExistenceCache::lookup(const std::string& title) {
+    const std::string key = normalize(title);
+    const auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (found_.contains(key, now)) {
+        ++stats_.foundHits;
+        return Status::Found;
+    }
+    if (missingFilter_.mightContain(key) && missing_.contains(key, now)) {
+        ++stats_.missingHits;
+        return Status::Missing;
+    }
+    ++stats_.misses;
+    return Status::Unknown;
+}
+
+void CatalogExistenceCache::recordFound(const std::string& title) {
+    const std::string key = normalize(title);
+    const auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    found_.insert(key, now + options_.foundTtl, options_.capacity, now);
+    missing_.erase(key); // Its filter bits stay until the next rebuild; the map decides
+}
+
+void CatalogExistenceCache::recordMissing(const std::string& title) {
+    const std::string key = normalize(title);
+    const auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    found_.erase(key);
+    droppedSinceRebuild_ += missing_.insert(key, now + options_.missingTtl, options_.capacity, now);
+    missingFilter_.add(key);
+
+    // Dropped keys leave bits behind and push the false-positive rate up;
+    // once enough have gone, rebuild the filter from the keys still live.
+    if (droppedSinceRebuild_ > options_.capacity / 2) {
+        rebuildFilter();
+    }
+}
+
+void CatalogExistenceCache::rebuildFilter() {
+    missingFilter_.clear();
+    for (const auto& entry : missing_.expiresAt) {
+        missingFilter_.add(entry.first);
+    }
+    droppedSinceRebuild_ = 0;
+}
+
+CatalogCacheStats CatalogExistenceCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Fixed-size Bloom filter over strings: mightContain() never misses an added
+// key, and wrongly says yes for about 1% of other keys at the sized capacity.
+// Keys cannot be removed; clear() and re-add the live set instead.
+class BloomFilter {
+public:
+    // Sized for `capacity` keys at a ~1% false-positive rate (10 bits, 7 probes per key).
+    explicit BloomFilter(size_t capacity);
+
+    void add(const std::string& key);
+    bool mightContain(const std::string& key) const;
+    void clear();
+
+private:
+    static constexpr unsigned kProbes = 7;
+    std::vector<uint64_t> words_;
+    uint64_t bitCount_;
+
+    // Double hashing: probe i is (h1 + i * h2) mod bitCount_.
+    void hashes(const std::string& key, uint64_t& h1, uint64_t& h2) const;
+};
+
+// Tunables for the catalog existence cache.
+struct CatalogCacheOptions {
+    std::chrono::milliseconds foundTtl = std::chrono::hours(24);     // Titles seen in the catalog
+    std::chrono::milliseconds missingTtl = std::chrono::minutes(10); // Titles the catalog had no match for
+    size_t capacity = 4096; // Max titles remembered per kind; the oldest are dropped first
+};
+
+// Hit/miss counters.
+struct CatalogCacheStats {
+    uint64_t foundHits = 0;
+    uint64_t missingHits = 0;
+    uint64_t misses = 0;
+};
+
+// Remembers which book titles the online catalog has (or lacks), so a repeat
+// borrow of the same title, including a mistyped one, skips the HTTP round trip.
+//
+// Titles are keyed after util::trim and util::toLower. Missing titles expire
+// sooner than found ones, since a new edition can appear in the catalog. The
+// missing set sits behind a Bloom filter: the usual lookup, for a title that
+// was never missing, is answered from the filter's bits without probing the map.
+// All methods are thread-safe.
+class CatalogExistenceCache {
+public:
+    enum class Status { Unknown, Found, Missing };
+
+    explicit CatalogExistenceCache(const CatalogCacheOptions& options = {});
+
+    // Normalized cache key for a title.
+    static std::string normalize(const std::string& title);
+
+    // What the catalog said about `title` within the TTL, or Unknown.
+    Status lookup(const std::string& title);
+
+    void recordFound(const std::string& title);
+    void recordMissing(const std::string& title);
+
+    CatalogCacheStats stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Keys with an expiry, dropped oldest-first when over capacity.
+    struct TtlSet {
+        std::unordered_map<std::string, Clock::time_point> expiresAt;
+        std::deque<std::string> order; // Insertion order (== expiry order, one TTL per set)
+
+        // Adds or refreshes `key`; returns how many keys were dropped to make room.
+        size_t insert(const std::string& key, Clock::time_point expiry, size_t capacity, Clock::time_point now);
+        bool contains(const std::string& key, Clock::time_point now) const;
+        void erase(const std::string& key);
+        void compact(); // Drops `order` entries for erased keys and repeats
+    };
+
+    CatalogCacheOptions options_;
+    mutable std::mutex mutex_; // Guards everything below
+    TtlSet found_;
+    TtlSet missing_;
+    BloomFilter missingFilter_;     // Superset of missing_'s keys
+    size_t droppedSinceRebuild_ = 0; // Stale filter bits; rebuilt past capacity / 2
+    CatalogCacheStats stats_;
+
+    void rebuildFilter();
+};
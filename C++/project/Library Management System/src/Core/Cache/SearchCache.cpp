@@ -0,0 +1,296 @@
+#include "SearchCache.h"
+#include "TimedSqlite.h"
+#include "Logger.h"
+#include "StringUtils.h"
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+// The pool is rebuilt from live entries once it holds this many strings and
+// has doubled since the last rebuild; evicted pages leave unused strings behind.
+static constexpr size_t kMinPoolSizeToCompact = 4096;
+
+// Helpers to (de)serialize a result set for the on-disk tier.
+static std::string serializeBooks(const std::vector<OnlineBook>& books) {
+    json arr = json::array();
+    for (const auto& b : books) {
+        arr.push_back({
+            {"title", b.title},
+            {"author", b.author},
+            {"publishYear", b.publishYear},
+            {"coverId", b.coverId},
+            {"subjects", b.subjects},
+            {"workKey", b.workKey}
+        });
+    }
+    return arr.dump();
+}
+
+static std::optional<std::vector<OnlineBook>> deserializeBooks(const std::string& payload) {
+    auto arr = json::parse(payload, nullptr, false);
+    if (!arr.is_array()) return std::nullopt;
+
+    std::vector<OnlineBook> books;
+    books.reserve(arr.size());
+    for (const auto& o : arr) {
+        // Rows written before books carried IDs (full URLs instead) count as misses.
+        if (!o.is_object() || !o.contains("workKey")) return std::nullopt;
+        OnlineBook b;
+        b.title       = o.value("title", "");
+        b.author      = o.value("author", "");
+        b.publishYear = o.value("publishYear", "");
+        b.coverId     = o.value("coverId", int64_t{0});
+        b.subjects    = o.value("subjects", std::vector<std::string>{});
+        b.workKey     = o.value("workKey", "");
+        books.push_back(std::move(b));
+    }
+    return books;
+}
+
+// Constructor: Opens the on-disk tier (if a path is given) and prepares its statements.
+SearchCache::SearchCache(const std::string& dbPath, const SearchCacheOptions& options)
+    : options_(options), dbPath_(dbPath), db_(nullptr), selectStmt_(nullptr), upsertStmt_(nullptr) {
+    if (dbPath_.empty()) {
+        return; // Memory-only cache
+    }
+
+    int rc = sqlite3_open(dbPath_.c_str(), &db_);
+    if (rc != SQLITE_OK) {
+        logError("Cannot open cache database: " + std::string(sqlite3_errmsg(db_)));
+        sqlite3_close(db_);
+        db_ = nullptr;
+        return;
+    }
+    if (!initializeSchema()) {
+        logError("Failed to initialize cache schema; continuing memory-only.");
+        sqlite3_finalize(selectStmt_);
+        sqlite3_finalize(upsertStmt_);
+        selectStmt_ = upsertStmt_ = nullptr;
+        sqlite3_close(db_);
+        db_ = nullptr;
+        return;
+    }
+    purgeExpiredLocked(now()); // Rows from earlier runs; no other thread has the cache yet
+}
+
+// Destructor: Finalizes statements and closes the database connection.
+SearchCache::~SearchCache() {
+    sqlite3_finalize(selectStmt_);
+    sqlite3_finalize(upsertStmt_);
+    if (db_) {
+        sqlite3_close(db_);
+    }
+}
+
+// Creates the 'search_cache' table and prepares the statements used on every lookup.
+bool SearchCache::initializeSchema() {
+    const char* sql = R"(
+        CREATE TABLE IF NOT EXISTS search_cache (
+            cache_key TEXT PRIMARY KEY,
+            payload TEXT NOT NULL,
+            expires_at INTEGER NOT NULL
+        ) WITHOUT ROWID;
+    )";
+
+    char* errMsg = nullptr;
+    int rc = sqlite3_exec(db_, sql, nullptr, nullptr, &errMsg);
+    if (rc != SQLITE_OK) {
+        logError("SQL error during cache schema initialization: " + std::string(errMsg));
+        sqlite3_free(errMsg);
+        return false;
+    }
+
+    rc = timedPrepare(db_,
+        "SELECT payload, expires_at FROM search_cache WHERE cache_key = ?;",
+        -1, &selectStmt_, nullptr);
+    if (rc != SQLITE_OK) {
+        logError("Failed to prepare cache lookup: " + std::string(sqlite3_errmsg(db_)));
+        return false;
+    }
+
+    rc = timedPrepare(db_,
+        "INSERT OR REPLACE INTO search_cache (cache_key, payload, expires_at) VALUES (?, ?, ?);",
+        -1, &upsertStmt_, nullptr);
+    if (rc != SQLITE_OK) {
+        logError("Failed to prepare cache insert: " + std::string(sqlite3_errmsg(db_)));
+        return false;
+    }
+    return true;
+}
+
+std::string SearchCache::makeKey(const std::string& query, size_t limit, size_t offset) {
+    // Fold case and collapse runs of whitespace so "the  hobbit", "The Hobbit "
+    // and "THE HOBBIT" share an entry ("Émile" and "émile" too).
+    std::string key = util::foldCase(query);
+    key.resize(util::normalizeQueryInPlace(key.data(), key.size()).size());
+    return key + "|" + std::to_string(limit) + "|" + std::to_string(offset);
+}
+
+std::optional<std::vector<OnlineBook>> SearchCache::get(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int64_t t = now();
+
+    // Tier 1: in-memory LRU
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        if (it->second->expiresAt > t) {
+            lru_.splice(lru_.begin(), lru_, it->second); // Mark as most recently used
+            ++stats_.memoryHits;
+            return it->second->books.expand(pool_);
+        }
+        // Stale: kept for getStale(); a fresher copy may still be on disk.
+    }
+
+    // Tier 2: on-disk table
+    int64_t expiresAt = 0;
+    auto books = getFromDisk(key, expiresAt);
+    if (books && expiresAt > t) {
+        ++stats_.diskHits;
+        putInMemory(key, *books, expiresAt);
+        return books;
+    }
+
+    ++stats_.misses;
+    return std::nullopt;
+}
+
+std::optional<std::vector<OnlineBook>> SearchCache::getStale(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int64_t t = now();
+    auto it = index_.find(key);
+    if (it != index_.end() && keptForStale(it->second->expiresAt, t)) {
+        ++stats_.staleHits;
+        return it->second->books.expand(pool_);
+    }
+    int64_t expiresAt = 0;
+    auto books = getFromDisk(key, expiresAt);
+    if (!books || !keptForStale(expiresAt, t)) {
+        return std::nullopt; // Not purged yet, but too old to serve
+    }
+    ++stats_.staleHits;
+    return books;
+}
+
+void SearchCache::put(const std::string& key, const std::vector<OnlineBook>& books) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int64_t t = now();
+    const int64_t expiresAt = t + options_.ttl.count();
+    putInMemory(key, books, expiresAt);
+    putOnDisk(key, books, expiresAt);
+    if (t >= nextPurgeAt_) {
+        purgeExpiredLocked(t);
+    }
+}
+
+void SearchCache::purgeExpired() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    purgeExpiredLocked(now());
+}
+
+// Every distinct query adds a row, so without this the table only grows.
+void SearchCache::purgeExpiredLocked(int64_t t) {
+    nextPurgeAt_ = t + options_.purgeInterval.count();
+    if (!db_) return;
+
+    const int64_t cutoff = t - options_.staleRetention.count();
+    std::string sql = "DELETE FROM search_cache WHERE expires_at <= " + std::to_string(cutoff) + ";";
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        logError("Failed to purge expired cache rows: " + std::string(errMsg));
+        sqlite3_free(errMsg);
+    }
+}
+
+SearchCacheStats SearchCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// Inserts or refreshes an entry at the front of the LRU, evicting from the back when full.
+void SearchCache::putInMemory(const std::string& key, const std::vector<OnlineBook>& books, int64_t expiresAt) {
+    if (options_.memoryCapacity == 0) return;
+
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        it->second->books = CompactBookList(books, pool_);
+        it->second->expiresAt = expiresAt;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return;
+    }
+
+    lru_.push_front(Entry{key, CompactBookList(books, pool_), expiresAt});
+    index_[key] = lru_.begin();
+
+    bool evicted = false;
+    while (lru_.size() > options_.memoryCapacity) {
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+        ++stats_.evictions;
+        evicted = true;
+    }
+    if (evicted) {
+        compactPoolIfBloated();
+    }
+}
+
+// Re-interns every live entry into a fresh pool, dropping strings only evicted
+// entries used. Amortized: it runs only after the pool has doubled.
+void SearchCache::compactPoolIfBloated() {
+    if (pool_.size() < kMinPoolSizeToCompact || pool_.size() < 2 * poolSizeAfterCompact_) {
+        return;
+    }
+    StringPool fresh;
+    for (auto& entry : lru_) {
+        entry.books = entry.books.rebased(pool_, fresh);
+    }
+    pool_ = std::move(fresh);
+    poolSizeAfterCompact_ = pool_.size();
+}
+
+std::optional<std::vector<OnlineBook>> SearchCache::getFromDisk(const std::string& key, int64_t& expiresAt) {
+    if (!db_) return std::nullopt;
+
+    sqlite3_reset(selectStmt_);
+    sqlite3_bind_text(selectStmt_, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+
+    std::optional<std::vector<OnlineBook>> books;
+    if (timedStep(selectStmt_) == SQLITE_ROW) {
+        auto payload = reinterpret_cast<const char*>(sqlite3_column_text(selectStmt_, 0));
+        expiresAt = sqlite3_column_int64(selectStmt_, 1);
+        if (payload) {
+            books = deserializeBooks(payload);
+        }
+    }
+    sqlite3_reset(selectStmt_);
+    return books;
+}
+
+void SearchCache::putOnDisk(const std::string& key, const std::vector<OnlineBook>& books, int64_t expiresAt) {
+    if (!db_) return;
+
+    const std::string payload = serializeBooks(books);
+    sqlite3_reset(upsertStmt_);
+    sqlite3_bind_text(upsertStmt_, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(upsertStmt_, 2, payload.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(upsertStmt_, 3, expiresAt);
+
+    if (timedStep(upsertStmt_) != SQLITE_DONE) {
+        logError("Failed to write cache entry: " + std::string(sqlite3_errmsg(db_)));
+    }
+    sqlite3_reset(upsertStmt_);
+}
+
+// Expired entries stay usable by getStale() for staleRetention past their TTL.
+bool SearchCache::keptForStale(int64_t expiresAt, int64_t t) const {
+    return expiresAt + options_.staleRetention.count() > t;
+}
+
+int64_t SearchCache::now() {
+    using namespace std::chrono;
+    return duration_cast<seconds>(system_clock::now().time_since_epoch()).count();
+}
+
+// Helper function to log errors.
+void SearchCache::logError(const std::string& message) const {
+    LOG_ERROR("SearchCache", "Database error", message);
+}
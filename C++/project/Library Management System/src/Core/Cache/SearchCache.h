@@ -0,0 +1,104 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sqlite3.h> // SQLite C interface header
+#include "OnlineBookService.h" // To use the OnlineBook struct definition
+#include "CompactBook.h"       // Memory-tier representation of a result set
+
+// Tunables for the two cache tiers.
+struct SearchCacheOptions {
+    size_t memoryCapacity = 256;                      // Max entries kept in the in-memory LRU
+    std::chrono::seconds ttl = std::chrono::hours(24); // How long an entry stays fresh (both tiers)
+    std::chrono::seconds staleRetention = std::chrono::hours(24 * 7); // How long past its TTL an entry is kept for getStale()
+    std::chrono::seconds purgeInterval = std::chrono::hours(1); // How often put() runs purgeExpired()
+};
+
+// Hit/miss counters, reported per tier.
+struct SearchCacheStats {
+    uint64_t memoryHits = 0;
+    uint64_t diskHits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0; // Entries pushed out of the in-memory LRU
+    uint64_t staleHits = 0; // Expired entries served by getStale()
+};
+
+// Two-tier cache for Open Library search results.
+// Tier 1 is an in-memory LRU; tier 2 is an SQLite table that survives restarts.
+// The memory tier keeps results as CompactBookLists whose authors, subjects and
+// years are interned in one pool shared by all entries.
+// Entries in both tiers expire after the configured TTL. All methods are thread-safe.
+class SearchCache {
+public:
+    // Constructor: Takes the database file path for the on-disk tier.
+    // An empty path disables the on-disk tier and keeps the cache memory-only.
+    explicit SearchCache(const std::string& dbPath, const SearchCacheOptions& options = {});
+
+    // Destructor: Closes the database connection.
+    ~SearchCache();
+
+    SearchCache(const SearchCache&) = delete;
+    SearchCache& operator=(const SearchCache&) = delete;
+
+    // Builds the cache key from a normalized query (trimmed, lowercased,
+    // inner whitespace collapsed) plus the page window.
+    static std::string makeKey(const std::string& query, size_t limit, size_t offset);
+
+    // Looks up a key in memory, then on disk. Disk hits are promoted to memory.
+    // Returns empty optional on a miss or when the entry has expired.
+    std::optional<std::vector<OnlineBook>> get(const std::string& key);
+
+    // Like get(), but also returns an entry up to staleRetention past its TTL.
+    // For when Open Library cannot be reached: an old answer beats none.
+    // Counted separately from get()'s hits and misses.
+    std::optional<std::vector<OnlineBook>> getStale(const std::string& key);
+
+    // Stores a result set in both tiers.
+    void put(const std::string& key, const std::vector<OnlineBook>& books);
+
+    // Deletes on-disk rows more than staleRetention past their TTL. Runs when
+    // the cache opens and then from put() every purgeInterval.
+    void purgeExpired();
+
+    // Returns a snapshot of the hit/miss counters.
+    SearchCacheStats stats() const;
+
+private:
+    struct Entry {
+        std::string key;
+        CompactBookList books;
+        int64_t expiresAt; // Unix seconds
+    };
+    using LruList = std::list<Entry>;
+
+    SearchCacheOptions options_;
+    std::string dbPath_;
+    sqlite3* db_; // Null when the on-disk tier is disabled or failed to open
+    sqlite3_stmt* selectStmt_;
+    sqlite3_stmt* upsertStmt_;
+
+    mutable std::mutex mutex_; // Guards everything below and the statements above
+    LruList lru_; // Most recently used at the front
+    std::unordered_map<std::string, LruList::iterator> index_;
+    SearchCacheStats stats_;
+    StringPool pool_;            // Strings referenced by the entries in lru_
+    size_t poolSizeAfterCompact_ = 0;
+    int64_t nextPurgeAt_ = 0;    // Unix seconds
+
+    bool initializeSchema();
+    void putInMemory(const std::string& key, const std::vector<OnlineBook>& books, int64_t expiresAt);
+    void compactPoolIfBloated();
+    std::optional<std::vector<OnlineBook>> getFromDisk(const std::string& key, int64_t& expiresAt);
+    void putOnDisk(const std::string& key, const std::vector<OnlineBook>& books, int64_t expiresAt);
+    void purgeExpiredLocked(int64_t t);
+    bool keptForStale(int64_t expiresAt, int64_t t) const;
+    static int64_t now();
+
+    // Private helper for error handling.
+    void logError(const std::string& message) const;
+};
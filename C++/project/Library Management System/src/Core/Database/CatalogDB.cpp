@@ -0,0 +1,172 @@
+#include "CatalogDB.h"
+#include "ReadListDB.h" // For toMatchExpression
+#include "TimedSqlite.h"
+#include "Logger.h"
+
+CatalogDB::CatalogDB(const std::string& dbPath, const DatabaseOptions& options)
+    : dbPath_(dbPath) {
+    // FULLMUTEX lets the connection be shared across threads, like the other databases.
+    int rc = sqlite3_open_v2(dbPath_.c_str(), &db_,
+                             SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr);
+    if (rc != SQLITE_OK) {
+        logError("Cannot open database: " + std::string(sqlite3_errmsg(db_)));
+        sqlite3_close(db_);
+        db_ = nullptr;
+        return;
+    }
+
+    LOG_DEBUG("CatalogDB", "Database opened", dbPath_);
+    std::string error;
+    if (!applyDatabaseOptions(db_, options, error)) {
+        logError("Failed to apply connection options: " + error);
+    }
+    if (!createSchema(db_, error)) {
+        logError("Catalog search unavailable: " + error);
+        return;
+    }
+
+    // bm25 weights: title 10, author 5, subjects 1. Lower bm25 means more relevant.
+    const char* searchSql = R"(
+        SELECT w.title, w.author, w.publish_year, w.cover_id, w.work_key, w.subjects
+        FROM works_fts
+        JOIN works w ON w.id = works_fts.rowid
+        WHERE works_fts MATCH ?
+        ORDER BY bm25(works_fts, 10.0, 5.0, 1.0)
+        LIMIT ? OFFSET ?;
+    )";
+    if (timedPrepare(db_, searchSql, -1, &searchStmt_, nullptr) != SQLITE_OK) {
+        logError("Failed to prepare search statement: " + std::string(sqlite3_errmsg(db_)));
+        return;
+    }
+    ftsEnabled_ = true;
+}
+
+CatalogDB::~CatalogDB() {
+    if (db_) {
+        sqlite3_finalize(searchStmt_);
+        sqlite3_close(db_);
+        LOG_DEBUG("CatalogDB", "Database closed", dbPath_);
+    }
+}
+
+// Indexes on work_key and authors.key are added by DumpIngester after a load,
+// not here: building them up front would slow every bulk insert.
+bool CatalogDB::createSchema(sqlite3* db, std::string& error) {
+    const char* sql = R"(
+        CREATE TABLE IF NOT EXISTS works (
+            id           INTEGER PRIMARY KEY,
+            work_key     TEXT NOT NULL,
+            title        TEXT NOT NULL,
+            author       TEXT,
+            author_key   TEXT,
+            publish_year TEXT,
+            cover_id     INTEGER,
+            subjects     TEXT
+        );
+        CREATE TABLE IF NOT EXISTS authors (
+            key  TEXT NOT NULL,
+            name TEXT NOT NULL
+        );
+        CREATE VIRTUAL TABLE IF NOT EXISTS works_fts USING fts5(
+            title, author, subjects,
+            content = 'works', content_rowid = 'id',
+            tokenize = 'unicode61 remove_diacritics 2'
+        );
+    )";
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        error = errMsg ? errMsg : "unknown error";
+        sqlite3_free(errMsg);
+        return false;
+    }
+    sqlite3_exec(db, ("PRAGMA user_version = " + std::to_string(kSchemaVersion) + ";").c_str(),
+                 nullptr, nullptr, nullptr);
+    return true;
+}
+
+std::vector<OnlineBook> CatalogDB::search(const std::string& query, size_t limit, size_t offset) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::string match = ReadListDB::toMatchExpression(query);
+    std::vector<OnlineBook> results;
+    if (!ftsEnabled_ || match.empty()) {
+        return results;
+    }
+
+    sqlite3_bind_text(searchStmt_, 1, match.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(searchStmt_, 2, static_cast<sqlite3_int64>(limit));
+    sqlite3_bind_int64(searchStmt_, 3, static_cast<sqlite3_int64>(offset));
+    auto text = [this](int col, const char* fallback) {
+        auto p = reinterpret_cast<const char*>(sqlite3_column_text(searchStmt_, col));
+        return p && *p ? std::string(p) : std::string(fallback);
+    };
+    int rc;
+    while ((rc = timedStep(searchStmt_)) == SQLITE_ROW) {
+        // Same defaults OpenLibraryParser uses for fields a search result lacks.
+        OnlineBook b;
+        b.title       = text(0, "N/A");
+        b.author      = text(1, "Unknown Author");
+        b.publishYear = text(2, "N/A");
+        b.coverId     = sqlite3_column_int64(searchStmt_, 3); // NULL reads as 0
+        b.workKey     = text(4, "");
+        const std::string subjects = text(5, "");
+        for (size_t start = 0; start < subjects.size();) {
+            size_t end = subjects.find('\n', start);
+            if (end == std::string::npos) end = subjects.size();
+            b.subjects.push_back(subjects.substr(start, end - start));
+            start = end + 1;
+        }
+        results.push_back(std::move(b));
+    }
+    if (rc != SQLITE_DONE) {
+        logError("Query failed: " + std::string(sqlite3_errmsg(db_)));
+    }
+    sqlite3_reset(searchStmt_);
+    return results;
+}
+
+size_t CatalogDB::countWorks() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    sqlite3_stmt* stmt = nullptr;
+    if (db_ && timedPrepare(db_, "SELECT COUNT(*) FROM works;", -1, &stmt, nullptr) == SQLITE_OK &&
+        timedStep(stmt) == SQLITE_ROW) {
+        count = static_cast<size_t>(sqlite3_column_int64(stmt, 0));
+    }
+    sqlite3_finalize(stmt);
+    return count;
+}
+
+std::vector<OnlineBook> CatalogDB::allWorks() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<OnlineBook> works;
+    sqlite3_stmt* stmt = nullptr;
+    const char* sql = "SELECT title, author, publish_year, cover_id, work_key FROM works ORDER BY id;";
+    if (!db_ || timedPrepare(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        return works;
+    }
+    auto text = [stmt](int col) {
+        auto p = reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
+        return p ? std::string(p) : std::string();
+    };
+    int rc;
+    while ((rc = timedStep(stmt)) == SQLITE_ROW) {
+        OnlineBook b;
+        b.title       = text(0);
+        b.author      = text(1);
+        b.publishYear = text(2);
+        b.coverId     = sqlite3_column_int64(stmt, 3);
+        b.workKey     = text(4);
+        works.push_back(std::move(b));
+    }
+    if (rc != SQLITE_DONE) {
+        logError("Query failed: " + std::string(sqlite3_errmsg(db_)));
+    }
+    sqlite3_finalize(stmt);
+    return works;
+}
+
+// Helper function to log errors.
+void CatalogDB::logError(const std::string& message) const {
+    LOG_ERROR("CatalogDB", "Database error", message);
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sqlite3.h> // SQLite C interface header
+#include "OnlineBookService.h" // To use the OnlineBook struct definition
+#include "DatabaseOptions.h"   // WAL / synchronous / cache settings
+
+// Read side of a local copy of the Open Library catalog, filled by DumpIngester
+// (see Ingest/DumpIngester.h) from the published data dumps. Lets searches and
+// borrow checks be answered without a round trip to openlibrary.org.
+//
+// Schema (version 1, tracked in PRAGMA user_version):
+//   works(id, work_key UNIQUE, title, author, author_key, publish_year, cover_id, subjects)
+//   authors(key UNIQUE, name)
+//   works_fts  -- FTS5 over works(title, author, subjects), external content
+// `author` is resolved from `author_key` via the authors table once both dumps
+// are in; `subjects` holds up to kMaxSubjects names separated by '\n'.
+class CatalogDB {
+public:
+    // Opens (or creates, empty) the catalog at `dbPath`.
+    explicit CatalogDB(const std::string& dbPath, const DatabaseOptions& options = {});
+    ~CatalogDB();
+
+    CatalogDB(const CatalogDB&) = delete;
+    CatalogDB& operator=(const CatalogDB&) = delete;
+
+    // Works matching every word of `query` (as a prefix) in title, author or
+    // subjects, most relevant first (title matches weigh most). Same matching
+    // rules as ReadListDB::searchLocal. Empty if nothing matches or the catalog
+    // is unavailable.
+    std::vector<OnlineBook> search(const std::string& query, size_t limit = 5, size_t offset = 0);
+
+    // Number of works in the catalog.
+    size_t countWorks();
+
+    // Every work, without subjects (for CatalogSnapshot::write).
+    std::vector<OnlineBook> allWorks();
+
+    // False if the file could not be opened, or has no search index (not yet
+    // ingested, or this SQLite lacks FTS5): search() then returns nothing.
+    bool available() const { return ftsEnabled_; }
+
+    // Schema shared with DumpIngester, which creates it on the write side.
+    static bool createSchema(sqlite3* db, std::string& error);
+
+    static constexpr int kSchemaVersion = 1;
+    static constexpr size_t kMaxSubjects = 4; // Same as OnlineBookService keeps per result
+
+private:
+    sqlite3* db_ = nullptr;
+    std::string dbPath_;
+    sqlite3_stmt* searchStmt_ = nullptr;
+    bool ftsEnabled_ = false;
+    std::mutex mutex_; // Serializes use of the connection and its statement
+
+    void logError(const std::string& message) const;
+};
@@ -0,0 +1,320 @@
+#include "CatalogSnapshot.h"
+#include "CatalogExistenceCache.h" // For the title normalization
+#include "FuzzyTitleIndex.h"
+#include "Logger.h"
+#include "StringUtils.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static constexpr char kMagic[8] = {'L', 'M', 'S', 'S', 'N', 'A', 'P', '1'};
+
+// magic[8], uint32 version, uint32 reserved, uint64 count, uint64 blobSize
+static constexpr size_t kHeaderSize = 32;
+
+// Per entry: the key's first kPrefixSize bytes (zero-padded), (uint32 offset,
+// uint32 length) for each field, then int64 coverId. Most binary-search steps
+// are decided by the inline prefix without touching the blob, which halves
+// the cache misses per lookup.
+enum Field : size_t { kKey, kTitle, kAuthor, kPublishYear, kWorkKey, kFieldCount };
+static constexpr size_t kPrefixSize = 8;
+static constexpr size_t kFieldsOffset = kPrefixSize;
+static constexpr size_t kCoverOffset = kFieldsOffset + kFieldCount * 8;
+static constexpr size_t kEntrySize = kCoverOffset + 8;
+
+template <class T>
+static T load(const unsigned char* p) {
+    T value;
+    std::memcpy(&value, p, sizeof value); // The mapping has no alignment guarantees for T
+    return value;
+}
+
+// Compares a stored (normalized) key with a trimmed title, lowercasing the latter on the fly.
+static int compareNormalized(std::string_view key, std::string_view title) {
+    const size_t n = std::min(key.size(), title.size());
+    for (size_t i = 0; i < n; ++i) {
+        const int a = static_cast<unsigned char>(key[i]);
+        const int b = static_cast<unsigned char>(util::toLowerAscii(title[i]));
+        if (a != b) return a < b ? -1 : 1;
+    }
+    return key.size() == title.size() ? 0 : key.size() < title.size() ? -1 : 1;
+}
+
+OnlineBook SnapshotBook::toOnlineBook() const {
+    OnlineBook b;
+    b.title = std::string(title);
+    b.author = author.empty() ? "Unknown Author" : std::string(author);
+    b.publishYear = publishYear.empty() ? "N/A" : std::string(publishYear);
+    b.workKey = std::string(workKey);
+    b.coverId = coverId;
+    return b;
+}
+
+std::shared_ptr<const CatalogSnapshot> CatalogSnapshot::open(const std::string& path, std::string& error) {
+    std::shared_ptr<CatalogSnapshot> snapshot(new CatalogSnapshot());
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "Cannot open " + path;
+        return nullptr;
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    HANDLE mapping = size.QuadPart > 0 ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    CloseHandle(file); // The mapping keeps the file open
+    void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!data) {
+        if (mapping) CloseHandle(mapping);
+        error = "Cannot map " + path;
+        return nullptr;
+    }
+    snapshot->mappingHandle_ = mapping;
+    snapshot->mappedSize_ = static_cast<size_t>(size.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "Cannot open " + path;
+        return nullptr;
+    }
+    struct stat st;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd); // The mapping keeps the file open
+    if (data == MAP_FAILED) {
+        error = "Cannot map " + path;
+        return nullptr;
+    }
+    snapshot->mappedSize_ = static_cast<size_t>(st.st_size);
+#endif
+    snapshot->data_ = static_cast<const unsigned char*>(data);
+
+    // Header checks only: O(1) whatever the size. Field bounds are checked per lookup.
+    const unsigned char* p = snapshot->data_;
+    const size_t size = snapshot->mappedSize_;
+    if (size < kHeaderSize || std::memcmp(p, kMagic, sizeof kMagic) != 0) {
+        error = path + " is not a catalog snapshot";
+        return nullptr;
+    }
+    if (load<uint32_t>(p + 8) != kVersion) {
+        error = path + " has an unsupported snapshot version";
+        return nullptr;
+    }
+    snapshot->count_ = load<uint64_t>(p + 16);
+    snapshot->blobSize_ = load<uint64_t>(p + 24);
+    if (snapshot->count_ > (size - kHeaderSize) / kEntrySize ||
+        snapshot->blobSize_ != size - kHeaderSize - snapshot->count_ * kEntrySize) {
+        error = path + " is truncated";
+        return nullptr;
+    }
+    snapshot->entries_ = p + kHeaderSize;
+    snapshot->blob_ = reinterpret_cast<const char*>(snapshot->entries_ + snapshot->count_ * kEntrySize);
+    return snapshot;
+}
+
+CatalogSnapshot::~CatalogSnapshot() {
+    if (!data_) return;
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(mappingHandle_);
+#else
+    munmap(const_cast<unsigned char*>(data_), mappedSize_);
+#endif
+}
+
+std::string_view CatalogSnapshot::field(const unsigned char* entry, size_t index) const {
+    const uint64_t offset = load<uint32_t>(entry + kFieldsOffset + index * 8);
+    const uint64_t length = load<uint32_t>(entry + kFieldsOffset + index * 8 + 4);
+    if (offset + length > blobSize_) {
+        return {}; // Corrupt entry: read as empty rather than past the mapping
+    }
+    return std::string_view(blob_ + offset, static_cast<size_t>(length));
+}
+
+SnapshotBook CatalogSnapshot::at(size_t index) const {
+    const unsigned char* entry = entries_ + index * kEntrySize;
+    SnapshotBook book;
+    book.title = field(entry, kTitle);
+    book.author = field(entry, kAuthor);
+    book.publishYear = field(entry, kPublishYear);
+    book.workKey = field(entry, kWorkKey);
+    book.coverId = load<int64_t>(entry + kCoverOffset);
+    return book;
+}
+
+std::optional<SnapshotBook> CatalogSnapshot::find(std::string_view title) const {
+    title = util::trimView(title); // As CatalogExistenceCache::normalize trims; lowercasing is done on the fly
+    unsigned char prefix[kPrefixSize] = {};
+    for (size_t i = 0; i < kPrefixSize && i < title.size(); ++i) {
+        prefix[i] = static_cast<unsigned char>(util::toLowerAscii(title[i]));
+    }
+
+    uint64_t low = 0, high = count_;
+    while (low < high) {
+        const uint64_t mid = low + (high - low) / 2;
+        const unsigned char* entry = entries_ + mid * kEntrySize;
+        // Zero padding keeps prefix order consistent with full-key order, so
+        // only equal prefixes need the key from the blob.
+        int order = std::memcmp(entry, prefix, kPrefixSize);
+        if (order == 0) {
+            order = compareNormalized(field(entry, kKey), title);
+        }
+        if (order < 0) {
+            low = mid + 1;
+        } else if (order > 0) {
+            high = mid;
+        } else {
+            return at(mid);
+        }
+    }
+    return std::nullopt;
+}
+
+bool CatalogSnapshot::write(const std::string& path, const std::vector<OnlineBook>& books, std::string& error) {
+    std::vector<std::string> keys;
+    keys.reserve(books.size());
+    for (const auto& b : books) {
+        keys.push_back(CatalogExistenceCache::normalize(b.title));
+    }
+    std::vector<size_t> order(books.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+    order.erase(std::unique(order.begin(), order.end(), [&keys](size_t a, size_t b) { return keys[a] == keys[b]; }),
+                order.end());
+    order.erase(std::remove_if(order.begin(), order.end(), [&keys](size_t i) { return keys[i].empty(); }),
+                order.end());
+
+    // Entries first, then the blob, which is appended as the entries are laid out.
+    std::vector<unsigned char> entries(order.size() * kEntrySize);
+    std::string blob;
+    for (size_t n = 0; n < order.size(); ++n) {
+        const OnlineBook& b = books[order[n]];
+        const std::string* fields[kFieldCount] = {&keys[order[n]], &b.title, &b.author, &b.publishYear, &b.workKey};
+        unsigned char* entry = entries.data() + n * kEntrySize;
+        std::memcpy(entry, keys[order[n]].data(), std::min(kPrefixSize, keys[order[n]].size()));
+        for (size_t f = 0; f < kFieldCount; ++f) {
+            if (blob.size() + fields[f]->size() > UINT32_MAX) {
+                error = "Catalog too large for a snapshot (4 GiB of text)";
+                return false;
+            }
+            const uint32_t offset = static_cast<uint32_t>(blob.size());
+            const uint32_t length = static_cast<uint32_t>(fields[f]->size());
+            std::memcpy(entry + kFieldsOffset + f * 8, &offset, 4);
+            std::memcpy(entry + kFieldsOffset + f * 8 + 4, &length, 4);
+            blob += *fields[f];
+        }
+        std::memcpy(entry + kCoverOffset, &b.coverId, 8);
+    }
+
+    unsigned char header[kHeaderSize] = {};
+    const uint32_t version = kVersion;
+    const uint64_t count = order.size();
+    const uint64_t blobSize = blob.size();
+    std::memcpy(header, kMagic, sizeof kMagic);
+    std::memcpy(header + 8, &version, 4);
+    std::memcpy(header + 16, &count, 8);
+    std::memcpy(header + 24, &blobSize, 8);
+
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(header), kHeaderSize);
+        out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size()));
+        out.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+        if (!out.flush()) {
+            error = "Cannot write " + tmpPath;
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec); // Atomic replace: readers see the old file or the new one
+    if (ec) {
+        error = "Cannot replace " + path + ": " + ec.message();
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+SnapshotWatcher::SnapshotWatcher(std::string path, std::chrono::milliseconds pollInterval, bool buildFuzzyIndex)
+    : path_(std::move(path)), pollInterval_(pollInterval), buildFuzzyIndex_(buildFuzzyIndex)
+{
+    reloadIfChanged();
+    thread_ = std::thread([this]() { run(); });
+}
+
+SnapshotWatcher::~SnapshotWatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+}
+
+bool SnapshotWatcher::reloadIfChanged() {
+    std::lock_guard<std::mutex> lock(reloadMutex_);
+    std::error_code ec;
+    const auto writeTime = std::filesystem::last_write_time(path_, ec);
+    if (ec || writeTime == loadedWriteTime_) {
+        return false; // Missing files keep the last good snapshot
+    }
+
+    std::string error;
+    auto snapshot = CatalogSnapshot::open(path_, error);
+    if (!snapshot) {
+        LOG_ERROR("SnapshotWatcher", "Cannot load catalog snapshot", error);
+        loadedWriteTime_ = writeTime; // Do not retry the same bad file every poll
+        return false;
+    }
+    std::atomic_store(&snapshot_, std::move(snapshot));
+    loadedWriteTime_ = writeTime;
+    ++loads_;
+    LOG_INFO("SnapshotWatcher", "Catalog snapshot loaded; titles", static_cast<int64_t>(current()->size()));
+    return true;
+}
+
+void SnapshotWatcher::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    do {
+        lock.unlock();
+        reloadIfChanged(); // The first pass finds the snapshot the constructor mapped
+        if (buildFuzzyIndex_) {
+            updateFuzzyIndex();
+        }
+        lock.lock();
+    } while (!wake_.wait_for(lock, pollInterval_, [this]() { return stopping_; }));
+}
+
+void SnapshotWatcher::updateFuzzyIndex() {
+    auto snapshot = current();
+    // Not a raw pointer: a new snapshot may be mapped at the address the old one was freed from.
+    if (!snapshot || snapshot == indexedSnapshot_.lock()) return;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> titles;
+    titles.reserve(snapshot->size());
+    for (size_t i = 0; i < snapshot->size(); ++i) {
+        titles.emplace_back(snapshot->at(i).title);
+    }
+    std::atomic_store(&fuzzyIndex_, std::shared_ptr<const FuzzyTitleIndex>(
+                                        std::make_shared<FuzzyTitleIndex>(std::move(titles))));
+    indexedSnapshot_ = snapshot;
+    LOG_INFO("SnapshotWatcher", "Fuzzy title index built; milliseconds",
+             static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::steady_clock::now() - start).count()));
+}
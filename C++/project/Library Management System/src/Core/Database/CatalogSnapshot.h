@@ -0,0 +1,132 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "OnlineBookService.h" // To use the OnlineBook struct definition
+
+class FuzzyTitleIndex; // See Fuzzy/FuzzyTitleIndex.h
+
+// One book in a snapshot. The views point into the mapped file and stay
+// valid as long as the CatalogSnapshot they came from.
+struct SnapshotBook {
+    std::string_view title;
+    std::string_view author;
+    std::string_view publishYear;
+    std::string_view workKey;
+    int64_t coverId = 0;
+
+    OnlineBook toOnlineBook() const;
+};
+
+// Read-only, memory-mapped list of catalog titles for existence checks.
+//
+// File layout (native byte order; written by write(), by catalog_ingest --snapshot):
+//   header   "LMSSNAP1", version, entry count, blob size         (32 bytes)
+//   entries  sorted by normalized title; each holds the key's first 8 bytes,
+//            (offset, length) pairs into the blob for the key and each field,
+//            and the cover ID (56 bytes)
+//   blob     the strings, back to back
+// Titles are normalized like CatalogExistenceCache::normalize (trimmed,
+// lowercased); one book is kept per normalized title.
+//
+// open() only maps the file and checks the header, so it costs the same for
+// any catalog size; pages are read in by the OS as lookups touch them. find()
+// is a binary search over the mapping that neither parses nor allocates.
+class CatalogSnapshot {
+public:
+    // Maps the snapshot at `path`; null (with `error` set) if it is missing or not a snapshot.
+    static std::shared_ptr<const CatalogSnapshot> open(const std::string& path, std::string& error);
+    ~CatalogSnapshot();
+
+    CatalogSnapshot(const CatalogSnapshot&) = delete;
+    CatalogSnapshot& operator=(const CatalogSnapshot&) = delete;
+
+    // The book stored under `title`'s normalized form, if any.
+    std::optional<SnapshotBook> find(std::string_view title) const;
+    bool contains(std::string_view title) const { return find(title).has_value(); }
+
+    size_t size() const { return count_; }
+
+    // Entry `index` (< size()), in normalized title order.
+    SnapshotBook at(size_t index) const;
+
+    // Writes `books` as a snapshot at `path`. Goes through a temporary file and
+    // a rename, so a process mapping the old file never sees a half-written one.
+    // Where two books share a normalized title, the first is kept.
+    static bool write(const std::string& path, const std::vector<OnlineBook>& books, std::string& error);
+
+    static constexpr uint32_t kVersion = 1;
+
+private:
+    CatalogSnapshot() = default;
+
+    const unsigned char* data_ = nullptr; // Start of the mapping
+    size_t mappedSize_ = 0;
+    uint64_t count_ = 0;
+    const unsigned char* entries_ = nullptr;
+    const char* blob_ = nullptr;
+    uint64_t blobSize_ = 0;
+#ifdef _WIN32
+    void* mappingHandle_ = nullptr;
+#endif
+
+    std::string_view field(const unsigned char* entry, size_t index) const;
+};
+
+// Keeps the newest snapshot at a path mapped. A background thread checks the
+// file every `pollInterval` and maps the replacement when it changes (e.g.
+// after catalog_ingest renames a new one into place); lookups in flight keep
+// the old mapping alive through their shared_ptr until they finish.
+//
+// With `buildFuzzyIndex`, the same thread also builds a FuzzyTitleIndex over
+// each snapshot's titles. That takes time proportional to the catalog, so it
+// never delays startup: until it is ready fuzzyIndex() returns the previous
+// index (or null), and exact lookups work meanwhile.
+class SnapshotWatcher {
+public:
+    explicit SnapshotWatcher(std::string path, std::chrono::milliseconds pollInterval = std::chrono::seconds(5),
+                             bool buildFuzzyIndex = false);
+    ~SnapshotWatcher();
+
+    SnapshotWatcher(const SnapshotWatcher&) = delete;
+    SnapshotWatcher& operator=(const SnapshotWatcher&) = delete;
+
+    // The mapped snapshot; null while the file is missing or unreadable.
+    std::shared_ptr<const CatalogSnapshot> current() const { return std::atomic_load(&snapshot_); }
+
+    // Typo-tolerant index over the titles of the latest snapshot it has caught up with; may be null.
+    std::shared_ptr<const FuzzyTitleIndex> fuzzyIndex() const { return std::atomic_load(&fuzzyIndex_); }
+
+    // Maps the file again if it changed since the last look. Returns true if a new snapshot was swapped in.
+    bool reloadIfChanged();
+
+    // Snapshots mapped so far, including the first.
+    uint64_t loads() const { return loads_.load(); }
+
+private:
+    std::string path_;
+    std::chrono::milliseconds pollInterval_;
+    std::shared_ptr<const CatalogSnapshot> snapshot_; // Read and swapped with atomic_load/atomic_store
+    bool buildFuzzyIndex_;
+    std::shared_ptr<const FuzzyTitleIndex> fuzzyIndex_; // Same
+    std::weak_ptr<const CatalogSnapshot> indexedSnapshot_; // What fuzzyIndex_ was built from (watcher thread only)
+    std::optional<std::filesystem::file_time_type> loadedWriteTime_;
+    std::mutex reloadMutex_; // Serializes reloadIfChanged()
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::atomic<uint64_t> loads_{0};
+    std::thread thread_;
+
+    void run();
+    void updateFuzzyIndex();
+};
@@ -0,0 +1,38 @@
+#pragma once
+#include <string>
+#include <sqlite3.h> // SQLite C interface header
+
+// Value for PRAGMA synchronous. NORMAL is durable in WAL mode except for the
+// last transactions before a power loss, and skips the fsync on every commit.
+enum class SyncMode { Off, Normal, Full };
+
+// Connection-level settings shared by ReadListDB and LoanRequestDB.
+struct DatabaseOptions {
+    bool walMode = true;                // PRAGMA journal_mode=WAL instead of the rollback journal
+    SyncMode synchronous = SyncMode::Normal;
+    int cacheSizeKiB = 8192;            // PRAGMA cache_size (negative value = KiB)
+    int busyTimeoutMs = 5000;           // Wait this long for a lock instead of failing with SQLITE_BUSY
+};
+
+// Applies the options to an open connection. Returns false and fills `error` on failure.
+inline bool applyDatabaseOptions(sqlite3* db, const DatabaseOptions& options, std::string& error) {
+    const char* sync = options.synchronous == SyncMode::Off    ? "OFF"
+                     : options.synchronous == SyncMode::Normal ? "NORMAL"
+                                                               : "FULL";
+    std::string sql;
+    if (options.walMode) {
+        sql += "PRAGMA journal_mode=WAL;";
+    }
+    sql += "PRAGMA synchronous=" + std::string(sync) + ";";
+    sql += "PRAGMA cache_size=-" + std::to_string(options.cacheSizeKiB) + ";";
+
+    sqlite3_busy_timeout(db, options.busyTimeoutMs);
+
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        error = errMsg ? errMsg : "unknown error";
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
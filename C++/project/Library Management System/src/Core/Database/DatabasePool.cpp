@@ -0,0 +1,23 @@
+#include "DatabasePool.h"
+
+DatabasePool::DatabasePool(const DatabaseOptions& options)
+    : options_(options)
+{}
+
+std::shared_ptr<ReadListDB> DatabasePool::readList(const std::string& dbPath) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& db = readLists_[dbPath];
+    if (!db) {
+        db = std::make_shared<ReadListDB>(dbPath, options_);
+    }
+    return db;
+}
+
+std::shared_ptr<LoanRequestDB> DatabasePool::loanRequests(const std::string& dbPath) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& db = loanRequests_[dbPath];
+    if (!db) {
+        db = std::make_shared<LoanRequestDB>(dbPath, options_);
+    }
+    return db;
+}
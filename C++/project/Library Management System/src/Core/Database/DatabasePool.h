@@ -0,0 +1,33 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "DatabaseOptions.h"
+#include "ReadListDB.h"
+#include "LoanRequestDB.h"
+
+// Hands out one shared connection per database file, so every service and UI
+// in the process talks to the same ReadListDB / LoanRequestDB instance.
+// A single connection per file means schema setup runs once and there is no
+// SQLITE_BUSY contention between connections of the same process. The
+// connections themselves serialize access, so they are safe to share across threads.
+class DatabasePool {
+public:
+    explicit DatabasePool(const DatabaseOptions& options = {});
+
+    DatabasePool(const DatabasePool&) = delete;
+    DatabasePool& operator=(const DatabasePool&) = delete;
+
+    // Returns the read-list connection for `dbPath`, opening it on first use.
+    std::shared_ptr<ReadListDB> readList(const std::string& dbPath);
+
+    // Returns the loan-request connection for `dbPath`, opening it on first use.
+    std::shared_ptr<LoanRequestDB> loanRequests(const std::string& dbPath);
+
+private:
+    DatabaseOptions options_;
+    std::mutex mutex_; // Guards both maps
+    std::unordered_map<std::string, std::shared_ptr<ReadListDB>> readLists_;
+    std::unordered_map<std::string, std::shared_ptr<LoanRequestDB>> loanRequests_;
+};
@@ -1,96 +1,329 @@
 #include "LoanRequestDB.h"
-#include <iostream>
+#include "TimedSqlite.h"
+#include "Logger.h"
+#include <algorithm>
+#include <limits>
 
-// Constructor: Opens the database and initializes its schema.
-LoanRequestDB::LoanRequestDB(const std::string& dbPath) : dbPath_(dbPath), db_(nullptr) {
+// Bounds used when a listing query has no lower/upper due day.
+static constexpr sqlite3_int64 kMinDay = std::numeric_limits<util::EpochDay>::min();
+static constexpr sqlite3_int64 kMaxDay = std::numeric_limits<util::EpochDay>::max();
+
+// Constructor: Opens the database, applies connection options and initializes its schema.
+LoanRequestDB::LoanRequestDB(const std::string& dbPath, const DatabaseOptions& options)
+    : dbPath_(dbPath), db_(nullptr), insertStmt_(nullptr), dueRangeStmt_(nullptr),
+      returnStmt_(nullptr), countOverdueStmt_(nullptr), inBatch_(false) {
     // Attempt to open the database. If it doesn't exist, it will be created.
-    int rc = sqlite3_open(dbPath_.c_str(), &db_);
+    // FULLMUTEX lets the shared connection be used from any thread (see DatabasePool).
+    int rc = sqlite3_open_v2(dbPath_.c_str(), &db_,
+                             SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr);
     if (rc != SQLITE_OK) {
         logError("Cannot open database: " + std::string(sqlite3_errmsg(db_)));
         sqlite3_close(db_); // Ensure db_ is closed on failure
         db_ = nullptr; // Set to nullptr to indicate failure
-    } else {
-        std::cout << "LoanRequestDB opened successfully: " << dbPath_ << std::endl;
-        if (!initializeSchema()) {
-            logError("Failed to initialize loan request database schema.");
-            sqlite3_close(db_);
-            db_ = nullptr;
-        }
+        return;
+    }
+
+    LOG_DEBUG("LoanRequestDB", "Database opened", dbPath_);
+    std::string pragmaError;
+    if (!applyDatabaseOptions(db_, options, pragmaError)) {
+        // Not fatal: the database still works in its default journal mode.
+        logError("Failed to apply connection options: " + pragmaError);
+    }
+    if (!initializeSchema() || !prepareStatements()) {
+        logError("Failed to initialize loan request database schema.");
+        finalizeStatements();
+        sqlite3_close(db_);
+        db_ = nullptr;
     }
 }
 
-// Destructor: Closes the database connection.
+// Destructor: Finalizes statements and closes the database connection.
 LoanRequestDB::~LoanRequestDB() {
     if (db_) {
+        if (inBatch_) {
+            commitBatch(); // Don't silently lose rows from an unfinished batch
+        }
+        finalizeStatements();
         sqlite3_close(db_);
-        std::cout << "LoanRequestDB closed." << std::endl;
+        LOG_DEBUG("LoanRequestDB", "Database closed", dbPath_);
     }
 }
 
 // Initializes the database schema by creating the 'loan_requests' table if it doesn't exist.
+// Dates are epoch days; 'returned_day' stays NULL while the book is out.
 bool LoanRequestDB::initializeSchema() {
-    // SQL statement to create the 'loan_requests' table.
-    const char* sql = R"(
+    // A version 1 table stores dates as 'YYYY-MM-DD' text in 'borrow_date'/'due_date'.
+    sqlite3_stmt* stmt = nullptr;
+    bool legacy = false;
+    if (timedPrepare(db_, "SELECT 1 FROM pragma_table_info('loan_requests') WHERE name = 'due_date';",
+                           -1, &stmt, nullptr) == SQLITE_OK) {
+        legacy = timedStep(stmt) == SQLITE_ROW;
+    }
+    sqlite3_finalize(stmt);
+
+    // A version 1 table is moved aside, copied over with its dates converted and
+    // dropped, all in the same transaction as the new schema.
+    // julianday() - 2440587.5 is the Unix epoch day. Unparseable dates (never
+    // written by this app) fall back to day 0.
+    const char* moveAside = "ALTER TABLE loan_requests RENAME TO loan_requests_v1;";
+    const char* copyLegacy = R"(
+        INSERT INTO loan_requests (id, book_title, borrow_day, due_day)
+            SELECT id, book_title,
+                   IFNULL(CAST(julianday(borrow_date) - 2440587.5 AS INTEGER), 0),
+                   IFNULL(CAST(julianday(due_date) - 2440587.5 AS INTEGER), 0)
+            FROM loan_requests_v1;
+        DROP TABLE loan_requests_v1;
+    )";
+    // The partial index holds only active loans, in (due_day, id) order: the
+    // filter and order of every listing query. It also carries the other
+    // selected columns (returned_day included, for the planner's sake), so a
+    // listing never reads the table itself.
+    const char* schema = R"(
         CREATE TABLE IF NOT EXISTS loan_requests (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             book_title TEXT NOT NULL,
-            borrow_date TEXT,
-            due_date TEXT
+            borrow_day INTEGER NOT NULL,
+            due_day INTEGER NOT NULL,
+            returned_day INTEGER
         );
+        CREATE INDEX IF NOT EXISTS idx_loan_requests_active_due
+            ON loan_requests (due_day, id, borrow_day, book_title, returned_day)
+            WHERE returned_day IS NULL;
     )";
+    const std::string sql = std::string("BEGIN IMMEDIATE;") + (legacy ? moveAside : "") + schema +
+                            (legacy ? copyLegacy : "") +
+                            "PRAGMA user_version = " + std::to_string(kSchemaVersion) + "; COMMIT;";
 
     char* errMsg = nullptr;
     // Execute the SQL statement.
-    int rc = sqlite3_exec(db_, sql, nullptr, nullptr, &errMsg);
+    int rc = sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, &errMsg);
     if (rc != SQLITE_OK) {
         logError("SQL error during loan request schema initialization: " + std::string(errMsg));
         sqlite3_free(errMsg); // Free the error message memory
+        sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+    if (legacy) {
+        LOG_INFO("LoanRequestDB", "Loan requests converted to schema version", static_cast<int64_t>(kSchemaVersion));
+    }
+    LOG_DEBUG("LoanRequestDB", "Schema initialized/verified", dbPath_);
+    return true;
+}
+
+// Prepares the statements that are reused for the lifetime of the connection.
+bool LoanRequestDB::prepareStatements() {
+    // The row-value comparison continues after the cursor; the index supplies the order.
+    const struct { sqlite3_stmt** stmt; const char* sql; } statements[] = {
+        {&insertStmt_,
+         "INSERT INTO loan_requests (book_title, borrow_day, due_day) VALUES (?, ?, ?);"},
+        {&dueRangeStmt_,
+         "SELECT id, book_title, borrow_day, due_day FROM loan_requests "
+         "WHERE returned_day IS NULL AND due_day BETWEEN ?1 AND ?2 AND (due_day, id) > (?3, ?4) "
+         "ORDER BY due_day, id LIMIT ?5;"},
+        {&returnStmt_,
+         "UPDATE loan_requests SET returned_day = ? WHERE id = ? AND returned_day IS NULL;"},
+        {&countOverdueStmt_,
+         "SELECT COUNT(*) FROM loan_requests WHERE returned_day IS NULL AND due_day < ?;"},
+    };
+    for (const auto& s : statements) {
+        if (timedPrepare(db_, s.sql, -1, s.stmt, nullptr) != SQLITE_OK) {
+            logError("Failed to prepare loan statement: " + std::string(sqlite3_errmsg(db_)));
+            return false;
+        }
+    }
+    return true;
+}
+
+void LoanRequestDB::finalizeStatements() {
+    for (sqlite3_stmt** stmt : {&insertStmt_, &dueRangeStmt_, &returnStmt_, &countOverdueStmt_}) {
+        sqlite3_finalize(*stmt);
+        *stmt = nullptr;
+    }
+}
+
+// Binds one record to the cached insert statement and executes it.
+bool LoanRequestDB::stepInsert(const LoanRecord& record) {
+    sqlite3_bind_text(insertStmt_, 1, record.bookTitle.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(insertStmt_, 2, record.borrowDay);
+    sqlite3_bind_int(insertStmt_, 3, record.dueDay);
+
+    int rc = timedStep(insertStmt_);
+    sqlite3_reset(insertStmt_); // Ready the statement for the next insert
+    if (rc != SQLITE_DONE) {
+        logError("Loan insertion failed for '" + record.bookTitle + "': " + std::string(sqlite3_errmsg(db_)));
         return false;
     }
-    std::cout << "Loan request database schema initialized/verified." << std::endl;
     return true;
 }
 
 // Inserts a loan record into the 'loan_requests' table.
 bool LoanRequestDB::insertLoan(const LoanRecord& record) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     if (!db_) {
         logError("LoanRequestDB is not open. Cannot insert loan record.");
         return false;
     }
+    if (!stepInsert(record)) {
+        return false;
+    }
+    LOG_DEBUG("LoanRequestDB", "Loan record added", record.bookTitle);
+    return true;
+}
 
-    // SQL statement for inserting a loan record.
-    const char* sql = R"(
-        INSERT INTO loan_requests (book_title, borrow_date, due_date)
-        VALUES (?, ?, ?);
-    )";
+// Inserts all records inside one transaction. If the caller already opened a
+// batch, the records join it and the caller decides whether to commit.
+bool LoanRequestDB::insertLoans(const std::vector<LoanRecord>& records) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (!db_) {
+        logError("LoanRequestDB is not open. Cannot insert loan records.");
+        return false;
+    }
+    if (records.empty()) {
+        return true;
+    }
 
-    sqlite3_stmt* stmt; // Prepared statement object
-    // Prepare the SQL statement.
-    int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        logError("Failed to prepare loan insertion statement: " + std::string(sqlite3_errmsg(db_)));
+    const bool ownBatch = !inBatch_;
+    if (ownBatch && !beginBatch()) {
         return false;
     }
 
-    // Bind values to the placeholders.
-    sqlite3_bind_text(stmt, 1, record.bookTitle.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, record.borrowDate.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 3, record.dueDate.c_str(), -1, SQLITE_TRANSIENT);
+    for (const auto& record : records) {
+        if (!stepInsert(record)) {
+            if (ownBatch) rollbackBatch();
+            return false;
+        }
+    }
 
-    // Execute the prepared statement.
-    rc = sqlite3_step(stmt);
+    if (ownBatch && !commitBatch()) {
+        return false;
+    }
+    LOG_DEBUG("LoanRequestDB", "Loan records added", static_cast<int64_t>(records.size()));
+    return true;
+}
+
+bool LoanRequestDB::markReturned(int64_t loanId, util::EpochDay returnedDay) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (!db_) {
+        return false;
+    }
+    sqlite3_bind_int(returnStmt_, 1, returnedDay);
+    sqlite3_bind_int64(returnStmt_, 2, loanId);
+    int rc = timedStep(returnStmt_);
+    sqlite3_reset(returnStmt_);
     if (rc != SQLITE_DONE) {
-        logError("Loan insertion failed: " + std::string(sqlite3_errmsg(db_)));
-        sqlite3_finalize(stmt); // Finalize statement on failure
+        logError("Failed to record return of loan " + std::to_string(loanId) + ": " + sqlite3_errmsg(db_));
         return false;
     }
+    return sqlite3_changes(db_) == 1;
+}
+
+LoanPage LoanRequestDB::getActiveLoans(size_t limit, const std::optional<LoanCursor>& after) {
+    return getLoansDueBetween(static_cast<util::EpochDay>(kMinDay), static_cast<util::EpochDay>(kMaxDay),
+                              limit, after);
+}
+
+LoanPage LoanRequestDB::getOverdueLoans(util::EpochDay asOfDay, size_t limit, const std::optional<LoanCursor>& after) {
+    return getLoansDueBetween(static_cast<util::EpochDay>(kMinDay), asOfDay - 1, limit, after);
+}
+
+LoanPage LoanRequestDB::getLoansDueBetween(util::EpochDay firstDay, util::EpochDay lastDay, size_t limit,
+                                           const std::optional<LoanCursor>& after) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    LoanPage page;
+    if (!db_ || limit == 0) {
+        return page;
+    }
+
+    // The cursor's day also raises the lower bound: SQLite seeks the index on
+    // the BETWEEN bounds only, and the row-value test then skips just the few
+    // rows of that day already returned. Without a cursor, start before the
+    // smallest possible (due_day, id).
+    sqlite3_bind_int(dueRangeStmt_, 1, after ? std::max(firstDay, after->dueDay) : firstDay);
+    sqlite3_bind_int(dueRangeStmt_, 2, lastDay);
+    sqlite3_bind_int64(dueRangeStmt_, 3, after ? after->dueDay : kMinDay - 1);
+    sqlite3_bind_int64(dueRangeStmt_, 4, after ? after->id : 0);
+    // Fetch one extra row to learn whether another page exists.
+    sqlite3_bind_int64(dueRangeStmt_, 5, static_cast<sqlite3_int64>(limit) + 1);
+
+    int rc;
+    while ((rc = timedStep(dueRangeStmt_)) == SQLITE_ROW) {
+        if (page.loans.size() == limit) {
+            const auto& last = page.loans.back();
+            page.next = LoanCursor{last.dueDay, last.id};
+            break;
+        }
+        LoanRecord record;
+        record.id = sqlite3_column_int64(dueRangeStmt_, 0);
+        record.bookTitle = reinterpret_cast<const char*>(sqlite3_column_text(dueRangeStmt_, 1));
+        record.borrowDay = sqlite3_column_int(dueRangeStmt_, 2);
+        record.dueDay = sqlite3_column_int(dueRangeStmt_, 3);
+        page.loans.push_back(std::move(record));
+    }
+    if (rc != SQLITE_ROW && rc != SQLITE_DONE) {
+        logError("Loan query failed: " + std::string(sqlite3_errmsg(db_)));
+    }
+    sqlite3_reset(dueRangeStmt_);
+    return page;
+}
 
-    sqlite3_finalize(stmt); // Finalize the prepared statement
-    std::cout << "Loan record added for: " << record.bookTitle << std::endl;
+size_t LoanRequestDB::countOverdue(util::EpochDay asOfDay) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (!db_) {
+        return 0;
+    }
+    sqlite3_bind_int(countOverdueStmt_, 1, asOfDay);
+    size_t count = timedStep(countOverdueStmt_) == SQLITE_ROW
+                 ? static_cast<size_t>(sqlite3_column_int64(countOverdueStmt_, 0)) : 0;
+    sqlite3_reset(countOverdueStmt_);
+    return count;
+}
+
+bool LoanRequestDB::beginBatch() {
+    mutex_.lock(); // Held until commitBatch()/rollbackBatch()
+    if (!db_ || inBatch_) {
+        mutex_.unlock();
+        return false;
+    }
+    char* errMsg = nullptr;
+    // IMMEDIATE takes the write lock up front so the batch cannot fail halfway on SQLITE_BUSY.
+    if (sqlite3_exec(db_, "BEGIN IMMEDIATE;", nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        logError("Failed to begin loan batch: " + std::string(errMsg));
+        sqlite3_free(errMsg);
+        mutex_.unlock();
+        return false;
+    }
+    inBatch_ = true;
     return true;
 }
 
+bool LoanRequestDB::commitBatch() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (!db_ || !inBatch_) {
+        return false;
+    }
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db_, "COMMIT;", nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        logError("Failed to commit loan batch: " + std::string(errMsg));
+        sqlite3_free(errMsg);
+        rollbackBatch();
+        return false;
+    }
+    inBatch_ = false;
+    mutex_.unlock(); // Release the hold taken in beginBatch()
+    return true;
+}
+
+void LoanRequestDB::rollbackBatch() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (!db_ || !inBatch_) {
+        return;
+    }
+    sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+    inBatch_ = false;
+    mutex_.unlock(); // Release the hold taken in beginBatch()
+}
+
 // Helper function to log errors.
 void LoanRequestDB::logError(const std::string& message) const {
-    std::cerr << "[LoanRequestDB Error] " << message << std::endl;
+    LOG_ERROR("LoanRequestDB", "Database error", message);
 }
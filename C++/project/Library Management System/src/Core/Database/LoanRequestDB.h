@@ -1,38 +1,119 @@
 #pragma once
+#include <cstdint>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <vector>
 #include <sqlite3.h> // SQLite C interface header
+#include "DatabaseOptions.h" // WAL / synchronous / cache settings
+#include "DateUtils.h"       // EpochDay
 
-// Represents a single loan record.
+// Represents a single loan record. Dates are epoch days (see DateUtils.h).
 struct LoanRecord {
     std::string bookTitle;
-    std::string borrowDate;
-    std::string dueDate;
+    util::EpochDay borrowDay = 0;
+    util::EpochDay dueDay = 0;
+    std::optional<util::EpochDay> returnedDay; // Empty while the book is out
+    int64_t id = 0;                            // Set on records read back from the database
+};
+
+// Position after the last loan of a page. Loans are listed in (dueDay, id)
+// order, so the next page starts strictly after this pair: no OFFSET scan, and
+// rows inserted or returned meanwhile never shift the pages.
+struct LoanCursor {
+    util::EpochDay dueDay = 0;
+    int64_t id = 0;
+};
+
+// One page of loans. `next` is empty when there are no more.
+struct LoanPage {
+    std::vector<LoanRecord> loans;
+    std::optional<LoanCursor> next;
 };
 
 // This class manages the SQLite database for loan requests.
+//
+// Schema (version 2, tracked in PRAGMA user_version):
+//   loan_requests(id, book_title, borrow_day, due_day, returned_day)
+// with a partial covering index on (due_day, id) over loans not yet returned,
+// so the active and overdue queries below are index range scans that never
+// touch returned loans.
+// Version 1 files ('YYYY-MM-DD' TEXT dates) are converted on open.
 class LoanRequestDB {
 public:
-    // Constructor: Takes the database file path.
+    // Constructor: Takes the database file path and connection options.
     // It will open the database and create the necessary table if it doesn't exist.
-    explicit LoanRequestDB(const std::string& dbPath);
+    explicit LoanRequestDB(const std::string& dbPath, const DatabaseOptions& options = {});
 
-    // Destructor: Closes the database connection.
+    // Destructor: Finalizes prepared statements and closes the database connection.
     ~LoanRequestDB();
 
+    LoanRequestDB(const LoanRequestDB&) = delete;
+    LoanRequestDB& operator=(const LoanRequestDB&) = delete;
+
     // Inserts a loan record into the loan_requests table.
     // Returns true on success, false on failure.
     bool insertLoan(const LoanRecord& record);
 
-    // TODO (Future): Add methods to retrieve, delete, or update loan records.
-    // For example, to list all current loans, check overdue books, etc.
+    // Inserts several loan records in a single transaction (one fsync for the batch).
+    // Either every record is written or none are. Returns true on success.
+    bool insertLoans(const std::vector<LoanRecord>& records);
+
+    // Groups subsequent inserts into one transaction until commitBatch().
+    // Other threads block on this connection until the batch ends.
+    // Returns false if the database is not open or this thread already runs a batch.
+    bool beginBatch();
+
+    // Commits the current batch. Returns false if there is none or the commit fails.
+    bool commitBatch();
+
+    // Discards everything inserted since beginBatch().
+    void rollbackBatch();
+
+    // Records the return of a loan. Returns false if there is no such active loan.
+    bool markReturned(int64_t loanId, util::EpochDay returnedDay);
+
+    // Loans not yet returned, soonest due first.
+    LoanPage getActiveLoans(size_t limit, const std::optional<LoanCursor>& after = std::nullopt);
+
+    // Loans not yet returned whose due day lies in [firstDay, lastDay].
+    LoanPage getLoansDueBetween(util::EpochDay firstDay, util::EpochDay lastDay, size_t limit,
+                                const std::optional<LoanCursor>& after = std::nullopt);
+
+    // Loans not yet returned that were due before `asOfDay`.
+    LoanPage getOverdueLoans(util::EpochDay asOfDay, size_t limit,
+                             const std::optional<LoanCursor>& after = std::nullopt);
+
+    // Number of overdue loans as of `asOfDay`, counted from the index alone.
+    size_t countOverdue(util::EpochDay asOfDay);
+
+    // Schema version written to PRAGMA user_version.
+    static constexpr int kSchemaVersion = 2;
 
 private:
     sqlite3* db_; // Pointer to the SQLite database connection
     std::string dbPath_; // Path to the database file
+    sqlite3_stmt* insertStmt_; // Prepared once, reused for every insert
+    sqlite3_stmt* dueRangeStmt_; // Backs all three listing queries
+    sqlite3_stmt* returnStmt_;
+    sqlite3_stmt* countOverdueStmt_;
+    bool inBatch_;
+
+    // Serializes all use of the connection and its statements. beginBatch() keeps
+    // it locked until the batch ends, so other threads wait for the whole batch.
+    mutable std::recursive_mutex mutex_;
 
-    // Initializes the database schema (creates tables if they don't exist).
+    // Initializes the database schema (creates tables if they don't exist),
+    // converting a version 1 table in place.
     bool initializeSchema();
 
+    // Prepares the statements kept for the lifetime of the connection.
+    bool prepareStatements();
+    void finalizeStatements();
+
+    // Binds and steps insertStmt_ for one record.
+    bool stepInsert(const LoanRecord& record);
+
     // Private helper for error handling.
     void logError(const std::string& message) const;
 };
@@ -1,114 +1,575 @@
 #include "ReadListDB.h"
-#include <iostream>
-#include <sstream> // For std::ostringstream to join strings
+#include "TimedSqlite.h"
+#include "Logger.h"
+#include <nlohmann/json.hpp> // For JSON export rows
+#include <sstream> // For joining subjects and tokenizing search queries
 
-// Constructor: Opens the database and initializes its schema.
-ReadListDB::ReadListDB(const std::string& dbPath) : dbPath_(dbPath), db_(nullptr) {
+// Constructor: Opens the database, applies connection options and initializes its schema.
+ReadListDB::ReadListDB(const std::string& dbPath, const DatabaseOptions& options)
+    : dbPath_(dbPath), db_(nullptr), insertStmt_(nullptr), subjectInsertStmt_(nullptr),
+      subjectIdStmt_(nullptr), linkStmt_(nullptr), subjectsOfStmt_(nullptr), existsStmt_(nullptr),
+      pageStmt_(nullptr), bySubjectStmt_(nullptr), ftsInsertStmt_(nullptr), ftsSearchStmt_(nullptr),
+      ftsEnabled_(false), inBatch_(false) {
     // Attempt to open the database. If it doesn't exist, it will be created.
-    int rc = sqlite3_open(dbPath_.c_str(), &db_);
+    // FULLMUTEX lets the shared connection be used from any thread (see DatabasePool).
+    int rc = sqlite3_open_v2(dbPath_.c_str(), &db_,
+                             SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr);
     if (rc != SQLITE_OK) {
         logError("Cannot open database: " + std::string(sqlite3_errmsg(db_)));
         sqlite3_close(db_); // Ensure db_ is closed on failure
         db_ = nullptr; // Set to nullptr to indicate failure
-    } else {
-        std::cout << "Database opened successfully: " << dbPath_ << std::endl;
-        if (!initializeSchema()) {
-            logError("Failed to initialize database schema.");
-            sqlite3_close(db_);
-            db_ = nullptr;
-        }
+        return;
+    }
+
+    LOG_DEBUG("ReadListDB", "Database opened", dbPath_);
+    std::string pragmaError;
+    if (!applyDatabaseOptions(db_, options, pragmaError)) {
+        // Not fatal: the database still works in its default journal mode.
+        logError("Failed to apply connection options: " + pragmaError);
+    }
+    if (!initializeSchema() || !prepareStatements() || !migrateLegacyRows()) {
+        logError("Failed to initialize database schema.");
+        finalizeStatements();
+        sqlite3_close(db_);
+        db_ = nullptr;
+        return;
     }
+    ftsEnabled_ = initializeSearchIndex();
 }
 
-// Destructor: Closes the database connection.
+// Destructor: Finalizes statements and closes the database connection.
 ReadListDB::~ReadListDB() {
     if (db_) {
+        if (inBatch_) {
+            commitBatch(); // Don't silently lose rows from an unfinished batch
+        }
+        finalizeStatements();
         sqlite3_close(db_);
-        std::cout << "Database closed." << std::endl;
+        LOG_DEBUG("ReadListDB", "Database closed", dbPath_);
     }
 }
 
-// Initializes the database schema by creating the 'read_list' table if it doesn't exist.
+// Creates the version 2 tables and indexes if they don't exist. A version 1
+// 'read_list' (it has a 'genres' column) is first moved aside to 'read_list_v1'.
 bool ReadListDB::initializeSchema() {
-    // SQL statement to create the 'read_list' table.
-    // 'id' is a primary key that auto-increments.
-    // 'title' is NOT NULL because a book must have a title.
-    // Other fields can be NULL if data is missing.
+    sqlite3_stmt* stmt = nullptr;
+    bool legacy = false;
+    if (timedPrepare(db_, "SELECT 1 FROM pragma_table_info('read_list') WHERE name = 'genres';",
+                           -1, &stmt, nullptr) == SQLITE_OK) {
+        legacy = timedStep(stmt) == SQLITE_ROW;
+    }
+    sqlite3_finalize(stmt);
+
+    // The old full-text rows point at old ids; initializeSearchIndex() rebuilds it.
+    if (legacy && !exec("ALTER TABLE read_list RENAME TO read_list_v1;"
+                        "DROP TABLE IF EXISTS read_list_fts;", "moving the version 1 table aside")) {
+        return false;
+    }
+
+    // 'work_key' is NULL for books without one (never deduplicated).
+    // read_list_subjects is keyed (subject_id, book_id) for getBooksBySubject;
+    // idx_read_list_subjects_book covers the book -> subjects lookup on its own.
     const char* sql = R"(
         CREATE TABLE IF NOT EXISTS read_list (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
+            work_key TEXT UNIQUE,
             title TEXT NOT NULL,
             author TEXT,
             publish_year TEXT,
-            genres TEXT,
-            url TEXT
+            cover_id INTEGER
+        );
+        CREATE TABLE IF NOT EXISTS subjects (
+            id INTEGER PRIMARY KEY,
+            name TEXT NOT NULL UNIQUE COLLATE NOCASE
         );
+        CREATE TABLE IF NOT EXISTS read_list_subjects (
+            subject_id INTEGER NOT NULL REFERENCES subjects(id),
+            book_id INTEGER NOT NULL REFERENCES read_list(id),
+            position INTEGER NOT NULL,
+            PRIMARY KEY (subject_id, book_id)
+        ) WITHOUT ROWID;
+        CREATE INDEX IF NOT EXISTS idx_read_list_subjects_book
+            ON read_list_subjects (book_id, position, subject_id);
+    )";
+    if (!exec(sql, "schema initialization")) {
+        return false;
+    }
+    LOG_DEBUG("ReadListDB", "Schema initialized/verified", dbPath_);
+    return true;
+}
+
+// Moves version 1 rows into the new tables through the normal insert path, so
+// subjects get split out and duplicates (same work URL) collapse to the first copy.
+bool ReadListDB::migrateLegacyRows() {
+    sqlite3_stmt* stmt = nullptr;
+    bool hasLegacy = timedPrepare(db_, "SELECT title, author, publish_year, genres, url "
+                                             "FROM read_list_v1 ORDER BY id;", -1, &stmt, nullptr) == SQLITE_OK;
+    if (!hasLegacy) {
+        sqlite3_finalize(stmt); // No read_list_v1: nothing to migrate
+        return exec(("PRAGMA user_version = " + std::to_string(kSchemaVersion) + ";").c_str(),
+                    "stamping the schema version");
+    }
+
+    if (!exec("BEGIN IMMEDIATE;", "starting the migration")) {
+        sqlite3_finalize(stmt);
+        return false;
+    }
+    auto text = [stmt](int col) {
+        auto p = reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
+        return p ? std::string(p) : std::string();
+    };
+    size_t copied = 0;
+    bool ok = true;
+    int rc = SQLITE_DONE;
+    while (ok && (rc = timedStep(stmt)) == SQLITE_ROW) {
+        OnlineBook b;
+        b.title       = text(0);
+        b.author      = text(1);
+        b.publishYear = text(2);
+        b.subjects    = splitSubjects(text(3));
+        b.workKey     = OnlineBook::workKeyFromUrl(text(4));
+        sqlite3_int64 id = insertRow(b);
+        ok = id >= 0;
+        copied += id > 0 ? 1 : 0;
+    }
+    ok = ok && rc == SQLITE_DONE;
+    sqlite3_finalize(stmt);
+
+    ok = ok && exec(("DROP TABLE read_list_v1; PRAGMA user_version = " +
+                     std::to_string(kSchemaVersion) + ";").c_str(), "finishing the migration");
+    if (!ok || !exec("COMMIT;", "committing the migration")) {
+        sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+    LOG_INFO("ReadListDB", "Read list migrated to the current schema; books copied", static_cast<int64_t>(copied));
+    return true;
+}
+
+// Creates the 'read_list_fts' index. Its rowid mirrors read_list.id, and rows are
+// added by insertBook rather than by triggers so the index can be rebuilt freely.
+// The genres column is the book's subjects joined by ", ".
+bool ReadListDB::initializeSearchIndex() {
+    const char* sql = R"(
+        CREATE VIRTUAL TABLE IF NOT EXISTS read_list_fts USING fts5(
+            title, author, genres,
+            tokenize = 'unicode61 remove_diacritics 2'
+        );
+        INSERT INTO read_list_fts (rowid, title, author, genres)
+            SELECT r.id, r.title, r.author,
+                   (SELECT group_concat(s.name, ', ')
+                    FROM read_list_subjects rs JOIN subjects s ON s.id = rs.subject_id
+                    WHERE rs.book_id = r.id)
+            FROM read_list r
+            WHERE r.id > (SELECT IFNULL(MAX(rowid), 0) FROM read_list_fts);
     )";
 
     char* errMsg = nullptr;
-    // Execute the SQL statement.
-    int rc = sqlite3_exec(db_, sql, nullptr, nullptr, &errMsg);
-    if (rc != SQLITE_OK) {
-        logError("SQL error during schema initialization: " + std::string(errMsg));
-        sqlite3_free(errMsg); // Free the error message memory
+    if (sqlite3_exec(db_, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        logError("Full-text index unavailable, local search disabled: " + std::string(errMsg));
+        sqlite3_free(errMsg);
+        return false;
+    }
+
+    const char* insertSql = "INSERT INTO read_list_fts (rowid, title, author, genres) VALUES (?, ?, ?, ?);";
+    // bm25 weights: title 10, author 5, genres 1. Lower bm25 means more relevant.
+    const char* searchSql = R"(
+        SELECT r.id, r.title, r.author, r.publish_year, r.cover_id, r.work_key
+        FROM read_list_fts
+        JOIN read_list r ON r.id = read_list_fts.rowid
+        WHERE read_list_fts MATCH ?
+        ORDER BY bm25(read_list_fts, 10.0, 5.0, 1.0)
+        LIMIT ? OFFSET ?;
+    )";
+    if (timedPrepare(db_, insertSql, -1, &ftsInsertStmt_, nullptr) != SQLITE_OK ||
+        timedPrepare(db_, searchSql, -1, &ftsSearchStmt_, nullptr) != SQLITE_OK) {
+        logError("Failed to prepare full-text statements: " + std::string(sqlite3_errmsg(db_)));
         return false;
     }
-    std::cout << "Database schema initialized/verified." << std::endl;
     return true;
 }
 
-// Inserts a book into the 'read_list' table using a prepared statement for safety.
+// Prepares the statements that are reused for the lifetime of the connection.
+bool ReadListDB::prepareStatements() {
+    // Use '?' as placeholders for binding parameters to prevent SQL injection.
+    const struct { sqlite3_stmt** stmt; const char* sql; } statements[] = {
+        {&insertStmt_,
+         "INSERT INTO read_list (work_key, title, author, publish_year, cover_id) VALUES (?, ?, ?, ?, ?) "
+         "ON CONFLICT (work_key) DO NOTHING;"},
+        {&subjectInsertStmt_, "INSERT OR IGNORE INTO subjects (name) VALUES (?);"},
+        {&subjectIdStmt_,     "SELECT id FROM subjects WHERE name = ?;"},
+        {&linkStmt_,
+         "INSERT OR IGNORE INTO read_list_subjects (subject_id, book_id, position) VALUES (?, ?, ?);"},
+        {&subjectsOfStmt_,
+         "SELECT s.name FROM read_list_subjects rs JOIN subjects s ON s.id = rs.subject_id "
+         "WHERE rs.book_id = ? ORDER BY rs.position;"},
+        {&existsStmt_,        "SELECT 1 FROM read_list WHERE work_key = ?;"},
+        {&pageStmt_,
+         "SELECT id, title, author, publish_year, cover_id, work_key FROM read_list "
+         "ORDER BY id DESC LIMIT ? OFFSET ?;"},
+        {&bySubjectStmt_,
+         "SELECT r.id, r.title, r.author, r.publish_year, r.cover_id, r.work_key "
+         "FROM subjects s "
+         "JOIN read_list_subjects rs ON rs.subject_id = s.id "
+         "JOIN read_list r ON r.id = rs.book_id "
+         "WHERE s.name = ? ORDER BY rs.book_id DESC LIMIT ? OFFSET ?;"},
+    };
+    for (const auto& s : statements) {
+        if (timedPrepare(db_, s.sql, -1, s.stmt, nullptr) != SQLITE_OK) {
+            logError("Failed to prepare statement: " + std::string(sqlite3_errmsg(db_)));
+            return false;
+        }
+    }
+    return true;
+}
+
+void ReadListDB::finalizeStatements() {
+    for (sqlite3_stmt** stmt : {&insertStmt_, &subjectInsertStmt_, &subjectIdStmt_, &linkStmt_,
+                                &subjectsOfStmt_, &existsStmt_, &pageStmt_, &bySubjectStmt_,
+                                &ftsInsertStmt_, &ftsSearchStmt_}) {
+        sqlite3_finalize(*stmt);
+        *stmt = nullptr;
+    }
+}
+
+// Inserts a book into the 'read_list' table using the cached prepared statement.
 bool ReadListDB::insertBook(const OnlineBook& book) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     if (!db_) {
         logError("Database is not open. Cannot insert book.");
         return false;
     }
 
-    // SQL statement for inserting a book.
-    // Use '?' as placeholders for binding parameters to prevent SQL injection.
-    const char* sql = R"(
-        INSERT INTO read_list (title, author, publish_year, genres, url)
-        VALUES (?, ?, ?, ?, ?);
-    )";
+    // The row, its subject links and its index entry go in together or not at all.
+    // A savepoint nests inside an open batch and acts as a transaction outside one.
+    if (!exec("SAVEPOINT insert_book;", "starting the insert")) {
+        return false;
+    }
+    sqlite3_int64 id = insertRow(book);
+    if (id <= 0) {
+        sqlite3_exec(db_, "ROLLBACK TO insert_book; RELEASE insert_book;", nullptr, nullptr, nullptr);
+        return false; // id 0: already saved, see exists()
+    }
 
-    sqlite3_stmt* stmt; // Prepared statement object
-    // Prepare the SQL statement.
-    int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        logError("Failed to prepare statement: " + std::string(sqlite3_errmsg(db_)));
+    // Keep the full-text index in step. A failure here only affects local search.
+    if (ftsEnabled_) {
+        const std::string genres = joinSubjects(book.subjects);
+        sqlite3_bind_int64(ftsInsertStmt_, 1, id);
+        sqlite3_bind_text(ftsInsertStmt_, 2, book.title.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(ftsInsertStmt_, 3, book.author.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(ftsInsertStmt_, 4, genres.c_str(), -1, SQLITE_TRANSIENT);
+        if (timedStep(ftsInsertStmt_) != SQLITE_DONE) {
+            logError("Failed to index book: " + std::string(sqlite3_errmsg(db_)));
+        }
+        sqlite3_reset(ftsInsertStmt_);
+    }
+
+    if (!exec("RELEASE insert_book;", "committing the insert")) {
+        sqlite3_exec(db_, "ROLLBACK TO insert_book; RELEASE insert_book;", nullptr, nullptr, nullptr);
         return false;
     }
+    LOG_DEBUG("ReadListDB", "Book added to read list", book.title);
+    return true;
+}
 
+sqlite3_int64 ReadListDB::insertRow(const OnlineBook& book) {
     // Bind values to the placeholders.
     // sqlite3_bind_text(statement, parameter_index, value, length, destructor)
     // -1 for length means strlen will be used.
     // SQLITE_TRANSIENT means SQLite makes a copy of the string.
-    sqlite3_bind_text(stmt, 1, book.title.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, book.author.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 3, book.publishYear.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 4, joinSubjects(book.subjects).c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 5, book.openLibraryUrl.c_str(), -1, SQLITE_TRANSIENT);
+    if (book.workKey.empty()) {
+        sqlite3_bind_null(insertStmt_, 1);
+    } else {
+        sqlite3_bind_text(insertStmt_, 1, book.workKey.c_str(), -1, SQLITE_TRANSIENT);
+    }
+    sqlite3_bind_text(insertStmt_, 2, book.title.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(insertStmt_, 3, book.author.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(insertStmt_, 4, book.publishYear.c_str(), -1, SQLITE_TRANSIENT);
+    if (book.coverId != 0) {
+        sqlite3_bind_int64(insertStmt_, 5, book.coverId);
+    } else {
+        sqlite3_bind_null(insertStmt_, 5);
+    }
 
     // Execute the prepared statement. sqlite3_step returns SQLITE_DONE for successful INSERT.
-    rc = sqlite3_step(stmt);
+    int rc = timedStep(insertStmt_);
+    sqlite3_reset(insertStmt_); // Ready the statement for the next insert
     if (rc != SQLITE_DONE) {
         logError("Execution failed: " + std::string(sqlite3_errmsg(db_)));
-        sqlite3_finalize(stmt); // Finalize statement on failure
+        return -1;
+    }
+    if (sqlite3_changes(db_) == 0) {
+        return 0; // ON CONFLICT DO NOTHING: this work key is already saved
+    }
+    const sqlite3_int64 bookId = sqlite3_last_insert_rowid(db_);
+
+    for (size_t i = 0; i < book.subjects.size(); ++i) {
+        const sqlite3_int64 subject = subjectId(book.subjects[i]);
+        if (subject < 0) {
+            return -1;
+        }
+        sqlite3_bind_int64(linkStmt_, 1, subject);
+        sqlite3_bind_int64(linkStmt_, 2, bookId);
+        sqlite3_bind_int64(linkStmt_, 3, static_cast<sqlite3_int64>(i));
+        rc = timedStep(linkStmt_);
+        sqlite3_reset(linkStmt_);
+        if (rc != SQLITE_DONE) {
+            logError("Failed to link subject: " + std::string(sqlite3_errmsg(db_)));
+            return -1;
+        }
+    }
+    return bookId;
+}
+
+sqlite3_int64 ReadListDB::subjectId(const std::string& name) {
+    sqlite3_bind_text(subjectInsertStmt_, 1, name.c_str(), -1, SQLITE_TRANSIENT);
+    int rc = timedStep(subjectInsertStmt_);
+    sqlite3_reset(subjectInsertStmt_);
+    if (rc != SQLITE_DONE) {
+        logError("Failed to add subject: " + std::string(sqlite3_errmsg(db_)));
+        return -1;
+    }
+
+    sqlite3_bind_text(subjectIdStmt_, 1, name.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_int64 id = timedStep(subjectIdStmt_) == SQLITE_ROW ? sqlite3_column_int64(subjectIdStmt_, 0) : -1;
+    sqlite3_reset(subjectIdStmt_);
+    return id;
+}
+
+bool ReadListDB::exists(const std::string& workKey) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (!db_ || workKey.empty()) {
         return false;
     }
+    sqlite3_bind_text(existsStmt_, 1, workKey.c_str(), -1, SQLITE_TRANSIENT);
+    bool found = timedStep(existsStmt_) == SQLITE_ROW;
+    sqlite3_reset(existsStmt_);
+    return found;
+}
+
+std::vector<OnlineBook> ReadListDB::getBooks(size_t limit, size_t offset) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (!db_) {
+        return {};
+    }
+    sqlite3_bind_int64(pageStmt_, 1, static_cast<sqlite3_int64>(limit));
+    sqlite3_bind_int64(pageStmt_, 2, static_cast<sqlite3_int64>(offset));
+    return collectBooks(pageStmt_);
+}
 
-    sqlite3_finalize(stmt); // Finalize (destroy) the prepared statement
-    std::cout << "Book added to read list: " << book.title << std::endl;
+std::vector<OnlineBook> ReadListDB::getBooksBySubject(const std::string& subject, size_t limit, size_t offset) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (!db_) {
+        return {};
+    }
+    sqlite3_bind_text(bySubjectStmt_, 1, subject.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(bySubjectStmt_, 2, static_cast<sqlite3_int64>(limit));
+    sqlite3_bind_int64(bySubjectStmt_, 3, static_cast<sqlite3_int64>(offset));
+    return collectBooks(bySubjectStmt_);
+}
+
+size_t ReadListDB::countBooks() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    size_t count = 0;
+    sqlite3_stmt* stmt = nullptr;
+    if (db_ && timedPrepare(db_, "SELECT COUNT(*) FROM read_list;", -1, &stmt, nullptr) == SQLITE_OK &&
+        timedStep(stmt) == SQLITE_ROW) {
+        count = static_cast<size_t>(sqlite3_column_int64(stmt, 0));
+    }
+    sqlite3_finalize(stmt);
+    return count;
+}
+
+std::vector<OnlineBook> ReadListDB::searchLocal(const std::string& query, size_t limit, size_t offset) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    const std::string match = toMatchExpression(query);
+    if (!db_ || !ftsEnabled_ || match.empty()) {
+        return {};
+    }
+
+    sqlite3_bind_text(ftsSearchStmt_, 1, match.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(ftsSearchStmt_, 2, static_cast<sqlite3_int64>(limit));
+    sqlite3_bind_int64(ftsSearchStmt_, 3, static_cast<sqlite3_int64>(offset));
+    return collectBooks(ftsSearchStmt_);
+}
+
+std::vector<OnlineBook> ReadListDB::collectBooks(sqlite3_stmt* stmt) {
+    std::vector<OnlineBook> results;
+    int rc;
+    while ((rc = timedStep(stmt)) == SQLITE_ROW) {
+        results.push_back(readBook(stmt, 0));
+    }
+    if (rc != SQLITE_DONE) {
+        logError("Query failed: " + std::string(sqlite3_errmsg(db_)));
+    }
+    sqlite3_reset(stmt);
+    return results;
+}
+
+// Reads (id, title, author, publish_year, cover_id, work_key) starting at `firstColumn`.
+OnlineBook ReadListDB::readBook(sqlite3_stmt* stmt, int firstColumn) {
+    auto text = [stmt](int col) {
+        auto p = reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
+        return p ? std::string(p) : std::string();
+    };
+    OnlineBook b;
+    b.title       = text(firstColumn + 1);
+    b.author      = text(firstColumn + 2);
+    b.publishYear = text(firstColumn + 3);
+    b.coverId     = sqlite3_column_int64(stmt, firstColumn + 4); // NULL reads as 0
+    b.workKey     = text(firstColumn + 5);
+    b.subjects    = subjectsOf(sqlite3_column_int64(stmt, firstColumn));
+    return b;
+}
+
+std::vector<std::string> ReadListDB::subjectsOf(sqlite3_int64 bookId) {
+    std::vector<std::string> subjects;
+    sqlite3_bind_int64(subjectsOfStmt_, 1, bookId);
+    while (timedStep(subjectsOfStmt_) == SQLITE_ROW) {
+        subjects.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(subjectsOfStmt_, 0)));
+    }
+    sqlite3_reset(subjectsOfStmt_);
+    return subjects;
+}
+
+// Quotes a CSV field when it contains a separator, quote or line break.
+static void writeCsvField(std::ostream& out, const std::string& field) {
+    if (field.find_first_of(",\"\r\n") == std::string::npos) {
+        out << field;
+        return;
+    }
+    out << '"';
+    for (char c : field) {
+        if (c == '"') out << '"';
+        out << c;
+    }
+    out << '"';
+}
+
+bool ReadListDB::exportCsv(std::ostream& out) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    sqlite3_stmt* stmt = nullptr;
+    if (!db_ || timedPrepare(db_, "SELECT id, title, author, publish_year, cover_id, work_key "
+                                        "FROM read_list ORDER BY id;", -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        return false;
+    }
+
+    out << "title,author,publish_year,subjects,work_key,cover_id,url\n";
+    int rc = SQLITE_DONE;
+    while (out && (rc = timedStep(stmt)) == SQLITE_ROW) {
+        const OnlineBook b = readBook(stmt, 0);
+        writeCsvField(out, b.title);
+        out << ',';
+        writeCsvField(out, b.author);
+        out << ',';
+        writeCsvField(out, b.publishYear);
+        out << ',';
+        writeCsvField(out, joinSubjects(b.subjects, "; "));
+        out << ',';
+        writeCsvField(out, b.workKey);
+        out << ',';
+        if (b.coverId != 0) out << b.coverId;
+        out << ',';
+        writeCsvField(out, b.openLibraryUrl());
+        out << '\n';
+    }
+    sqlite3_finalize(stmt);
+    return out && rc == SQLITE_DONE;
+}
+
+bool ReadListDB::exportJson(std::ostream& out) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    sqlite3_stmt* stmt = nullptr;
+    if (!db_ || timedPrepare(db_, "SELECT id, title, author, publish_year, cover_id, work_key "
+                                        "FROM read_list ORDER BY id;", -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        return false;
+    }
+
+    // Only one row's object exists at a time; the array brackets are written by hand.
+    out << '[';
+    bool first = true;
+    int rc = SQLITE_DONE;
+    while (out && (rc = timedStep(stmt)) == SQLITE_ROW) {
+        const OnlineBook b = readBook(stmt, 0);
+        nlohmann::json row = {
+            {"title", b.title},
+            {"author", b.author},
+            {"publishYear", b.publishYear},
+            {"subjects", b.subjects},
+            {"workKey", b.workKey},
+            {"coverId", b.coverId},
+            {"url", b.openLibraryUrl()}
+        };
+        out << (first ? "\n  " : ",\n  ") << row.dump();
+        first = false;
+    }
+    out << (first ? "]\n" : "\n]\n");
+    sqlite3_finalize(stmt);
+    return out && rc == SQLITE_DONE;
+}
+
+bool ReadListDB::exec(const char* sql, const std::string& what) {
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db_, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        logError("SQL error during " + what + ": " + std::string(errMsg ? errMsg : "unknown error"));
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+bool ReadListDB::beginBatch() {
+    mutex_.lock(); // Held until commitBatch()/rollbackBatch()
+    if (!db_ || inBatch_) {
+        mutex_.unlock();
+        return false;
+    }
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db_, "BEGIN IMMEDIATE;", nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        logError("Failed to begin batch: " + std::string(errMsg));
+        sqlite3_free(errMsg);
+        mutex_.unlock();
+        return false;
+    }
+    inBatch_ = true;
     return true;
 }
 
+bool ReadListDB::commitBatch() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (!db_ || !inBatch_) {
+        return false;
+    }
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db_, "COMMIT;", nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        logError("Failed to commit batch: " + std::string(errMsg));
+        sqlite3_free(errMsg);
+        rollbackBatch();
+        return false;
+    }
+    inBatch_ = false;
+    mutex_.unlock(); // Release the hold taken in beginBatch()
+    return true;
+}
+
+void ReadListDB::rollbackBatch() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (!db_ || !inBatch_) {
+        return;
+    }
+    sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+    inBatch_ = false;
+    mutex_.unlock(); // Release the hold taken in beginBatch()
+}
+
 // Helper function to log errors.
 void ReadListDB::logError(const std::string& message) const {
-    std::cerr << "[ReadListDB Error] " << message << std::endl;
+    LOG_ERROR("ReadListDB", "Database error", message);
 }
 
-// Helper function to join a vector of subjects into a comma-separated string.
-std::string ReadListDB::joinSubjects(const std::vector<std::string>& subjects) const {
+// Helper function to join a vector of subjects into one string.
+std::string ReadListDB::joinSubjects(const std::vector<std::string>& subjects, const std::string& separator) const {
     if (subjects.empty()) {
         return "";
     }
@@ -116,8 +577,38 @@ std::string ReadListDB::joinSubjects(const std::vector<std::string>& subjects) c
     for (size_t i = 0; i < subjects.size(); ++i) {
         oss << subjects[i];
         if (i < subjects.size() - 1) {
-            oss << ", ";
+            oss << separator;
         }
     }
     return oss.str();
 }
+
+// Helper function to split a comma-separated genres string back into subjects.
+std::vector<std::string> ReadListDB::splitSubjects(const std::string& genres) const {
+    std::vector<std::string> subjects;
+    size_t start = 0;
+    while (start < genres.size()) {
+        size_t end = genres.find(", ", start);
+        if (end == std::string::npos) end = genres.size();
+        if (end > start) subjects.push_back(genres.substr(start, end - start));
+        start = end + 2;
+    }
+    return subjects;
+}
+
+// Builds e.g. "hobbit"* "tolk"* from "Hobbit  tolk". Embedded quotes are doubled.
+std::string ReadListDB::toMatchExpression(const std::string& query) {
+    std::istringstream iss(query);
+    std::string word, expr;
+    while (iss >> word) {
+        std::string quoted = "\"";
+        for (char c : word) {
+            quoted += c;
+            if (c == '"') quoted += '"';
+        }
+        quoted += "\"*";
+        if (!expr.empty()) expr += ' ';
+        expr += quoted;
+    }
+    return expr;
+}
@@ -1,37 +1,146 @@
 #pragma once
+#include <mutex>
+#include <ostream>
 #include <string>
 #include <vector>
 #include <sqlite3.h> // SQLite C interface header
 #include "OnlineBookService.h" // To use the OnlineBook struct definition
+#include "DatabaseOptions.h"   // WAL / synchronous / cache settings
 
 // This class manages the SQLite database for the user's read list.
+//
+// Schema (version 2, tracked in PRAGMA user_version):
+//   read_list(id, work_key UNIQUE, title, author, publish_year, cover_id)
+//   subjects(id, name UNIQUE NOCASE)
+//   read_list_subjects(subject_id, book_id, position)  -- join table, keyed for
+//       subject -> books lookups, with a covering index for book -> subjects
+// Version 1 files (subjects as one comma-joined `genres` column, no uniqueness)
+// are migrated in place on open, keeping the first copy of duplicated books.
 class ReadListDB {
 public:
-    // Constructor: Takes the database file path.
+    // Constructor: Takes the database file path and connection options.
     // It will open the database and create the necessary table if it doesn't exist.
-    explicit ReadListDB(const std::string& dbPath);
+    explicit ReadListDB(const std::string& dbPath, const DatabaseOptions& options = {});
 
-    // Destructor: Closes the database connection.
+    // Destructor: Finalizes prepared statements and closes the database connection.
     ~ReadListDB();
 
-    // Inserts a book into the read_list table.
-    // Returns true on success, false on failure.
+    ReadListDB(const ReadListDB&) = delete;
+    ReadListDB& operator=(const ReadListDB&) = delete;
+
+    // Inserts a book into the read_list table (and its full-text index).
+    // Returns true on success, false on failure or if a book with the same
+    // work key is already saved (books without a work key are never deduplicated).
     bool insertBook(const OnlineBook& book);
 
-    // TODO (Future): Add methods to retrieve, delete, or update books from the read list.
-    // std::vector<OnlineBook> getAllBooks();
-    // bool deleteBook(const std::string& title, const std::string& author);
+    // True if a book with this work key (e.g. "OL262758W") is saved. Index lookup.
+    bool exists(const std::string& workKey);
+
+    // Saved books, most recently added first.
+    std::vector<OnlineBook> getBooks(size_t limit = 20, size_t offset = 0);
+
+    // Saved books tagged with `subject` (exact name, case-insensitive), most recently added first.
+    std::vector<OnlineBook> getBooksBySubject(const std::string& subject, size_t limit = 20, size_t offset = 0);
+
+    // Number of saved books.
+    size_t countBooks();
+
+    // Write every saved book to `out`, oldest first, one row at a time, so memory
+    // use does not grow with the read list. Return false on a database or stream error.
+    // CSV columns: title,author,publish_year,subjects,work_key,cover_id,url (subjects joined by "; ").
+    bool exportCsv(std::ostream& out);
+    // JSON: an array of objects with the same fields, subjects as an array.
+    bool exportJson(std::ostream& out);
+
+    // Full-text search over title, author and genres of saved books, ranked by
+    // relevance (title matches weigh most). Each word of `query` is matched as a
+    // prefix, so "hob tolk" finds "The Hobbit" by Tolkien. Never touches the network.
+    // Returns an empty vector if nothing matches or the index is unavailable.
+    std::vector<OnlineBook> searchLocal(const std::string& query, size_t limit = 5, size_t offset = 0);
+
+    // False if this SQLite build lacks FTS5; searchLocal() then always returns nothing.
+    bool hasLocalSearch() const { return ftsEnabled_; }
+
+    // Turns free text into an FTS5 query of quoted prefix terms, so user input
+    // can never be parsed as FTS5 syntax. Also used by CatalogDB.
+    static std::string toMatchExpression(const std::string& query);
+
+    // Groups subsequent inserts into one transaction until commitBatch().
+    // Other threads block on this connection until the batch ends.
+    // Returns false if the database is not open or this thread already runs a batch.
+    bool beginBatch();
+
+    // Commits the current batch. Returns false if there is none or the commit fails.
+    bool commitBatch();
+
+    // Discards everything inserted since beginBatch().
+    void rollbackBatch();
+
+    // TODO (Future): Add methods to delete or update books in the read list.
+    // bool deleteBook(const std::string& workKey);
+
+    // Schema version written to PRAGMA user_version.
+    static constexpr int kSchemaVersion = 2;
 
 private:
     sqlite3* db_; // Pointer to the SQLite database connection
     std::string dbPath_; // Path to the database file
+    sqlite3_stmt* insertStmt_; // Prepared once, reused for every insert
+    sqlite3_stmt* subjectInsertStmt_;
+    sqlite3_stmt* subjectIdStmt_;
+    sqlite3_stmt* linkStmt_;         // Adds one read_list_subjects row
+    sqlite3_stmt* subjectsOfStmt_;   // A book's subjects in their original order
+    sqlite3_stmt* existsStmt_;
+    sqlite3_stmt* pageStmt_;         // getBooks
+    sqlite3_stmt* bySubjectStmt_;    // getBooksBySubject
+    sqlite3_stmt* ftsInsertStmt_;
+    sqlite3_stmt* ftsSearchStmt_;
+    bool ftsEnabled_;
+    bool inBatch_;
+
+    // Serializes all use of the connection and its statements. beginBatch() keeps
+    // it locked until the batch ends, so other threads wait for the whole batch.
+    mutable std::recursive_mutex mutex_;
 
     // Initializes the database schema (creates tables if they don't exist).
+    // A version 1 read_list is renamed to read_list_v1 for migrateLegacyRows().
     bool initializeSchema();
 
+    // Copies rows out of read_list_v1 (if present) into the current schema,
+    // drops it and stamps the schema version, all in one transaction.
+    bool migrateLegacyRows();
+
+    // Creates the FTS5 index and backfills rows saved before it existed.
+    // Failure only disables local search.
+    bool initializeSearchIndex();
+
+    // Prepares the statements kept for the lifetime of the connection.
+    bool prepareStatements();
+    void finalizeStatements();
+
+    // Writes the read_list row and its subject links. Returns the new row id,
+    // 0 if the work key is already saved, or -1 on error.
+    sqlite3_int64 insertRow(const OnlineBook& book);
+
+    // Id of a subject name, adding it on first use. Returns -1 on error.
+    sqlite3_int64 subjectId(const std::string& name);
+
+    // Runs a statement whose columns are (id, title, author, publish_year, cover_id,
+    // work_key) and collects the books, with their subjects.
+    std::vector<OnlineBook> collectBooks(sqlite3_stmt* stmt);
+    OnlineBook readBook(sqlite3_stmt* stmt, int firstColumn);
+    std::vector<std::string> subjectsOf(sqlite3_int64 bookId);
+
+    // Runs SQL with no result rows; logs and returns false on error.
+    bool exec(const char* sql, const std::string& what);
+
     // Private helper for error handling.
     void logError(const std::string& message) const;
 
     // Helper to join a vector of strings into a single string (e.g., for subjects).
-    std::string joinSubjects(const std::vector<std::string>& subjects) const;
+    // Feeds the full-text index's genres column, and exports.
+    std::string joinSubjects(const std::vector<std::string>& subjects, const std::string& separator = ", ") const;
+
+    // Inverse of joinSubjects. Only used to read version 1 rows.
+    std::vector<std::string> splitSubjects(const std::string& genres) const;
 };
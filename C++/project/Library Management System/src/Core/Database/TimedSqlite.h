@@ -0,0 +1,20 @@
+#ifndef TIMED_SQLITE_H
+#define TIMED_SQLITE_H
+
+#include <sqlite3.h>
+#include "Metrics.h"
+
+// Drop-in replacements for sqlite3_prepare_v2 / sqlite3_step that record their
+// latency in the DbPrepare / DbStep histograms.
+
+inline int timedPrepare(sqlite3* db, const char* sql, int bytes, sqlite3_stmt** stmt, const char** tail) {
+    ScopedTimer timer(Stage::DbPrepare);
+    return sqlite3_prepare_v2(db, sql, bytes, stmt, tail);
+}
+
+inline int timedStep(sqlite3_stmt* stmt) {
+    ScopedTimer timer(Stage::DbStep);
+    return sqlite3_step(stmt);
+}
+
+#endif // TIMED_SQLITE_H
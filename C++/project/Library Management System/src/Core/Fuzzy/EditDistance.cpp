@@ -0,0 +1,71 @@
+#include "EditDistance.h"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace fuzzy {
+
+int editDistance(std::string_view a, std::string_view b, int maxDistance) {
+    if (a.size() < b.size()) std::swap(a, b);
+    const int n = static_cast<int>(a.size()), m = static_cast<int>(b.size());
+    if (n - m > maxDistance) return maxDistance + 1;
+
+    // Cells further than maxDistance off the diagonal cannot lie on a path of
+    // cost <= maxDistance; they are treated as infinite.
+    const int kInfinity = maxDistance + 1;
+    std::vector<int> prev(m + 1), cur(m + 1);
+    for (int j = 0; j <= m; ++j) prev[j] = std::min(j, kInfinity);
+    for (int i = 1; i <= n; ++i) {
+        const int from = std::max(1, i - maxDistance), to = std::min(m, i + maxDistance);
+        cur[0] = std::min(i, kInfinity);
+        if (from > 1) cur[from - 1] = kInfinity;
+        int rowMin = cur[0];
+        for (int j = from; j <= to; ++j) {
+            const int substitute = prev[j - 1] + (a[i - 1] != b[j - 1]);
+            cur[j] = std::min({substitute, prev[j] + 1, cur[j - 1] + 1, kInfinity});
+            rowMin = std::min(rowMin, cur[j]);
+        }
+        if (to < m) cur[to + 1] = kInfinity;
+        if (rowMin > maxDistance) return kInfinity;
+        std::swap(prev, cur);
+    }
+    return std::min(prev[m], kInfinity);
+}
+
+BitParallelPattern::BitParallelPattern(std::string_view pattern) : pattern_(pattern) {
+    if (pattern_.size() > kMaxLength) return;
+    for (size_t i = 0; i < pattern_.size(); ++i) {
+        peq_[static_cast<unsigned char>(pattern_[i])] |= uint64_t(1) << i;
+    }
+}
+
+int BitParallelPattern::distance(std::string_view text, int maxDistance) const {
+    const size_t m = pattern_.size();
+    if (m > kMaxLength) return editDistance(pattern_, text, maxDistance);
+    if (m == 0) return static_cast<int>(std::min<size_t>(text.size(), maxDistance + 1));
+    if (std::abs(static_cast<int>(text.size()) - static_cast<int>(m)) > maxDistance) return maxDistance + 1;
+
+    // Pv/Mv: +1/-1 vertical deltas of the current column; score tracks D[m][j].
+    const uint64_t last = uint64_t(1) << (m - 1);
+    uint64_t pv = ~uint64_t(0), mv = 0;
+    int score = static_cast<int>(m);
+    for (size_t j = 0; j < text.size(); ++j) {
+        const uint64_t eq = peq_[static_cast<unsigned char>(text[j])];
+        const uint64_t xv = eq | mv;
+        const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        if (ph & last) ++score;
+        if (mh & last) --score;
+        // Row 0 is D[0][j] = j, so the horizontal delta entering row 1 is +1.
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+        // D[m][n] >= D[m][j] - (n - j): stop once even the remaining text cannot bring it back.
+        if (score - static_cast<int>(text.size() - j - 1) > maxDistance) return maxDistance + 1;
+    }
+    return std::min(score, maxDistance + 1);
+}
+
+} // namespace fuzzy
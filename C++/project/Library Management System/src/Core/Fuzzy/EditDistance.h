@@ -0,0 +1,36 @@
+#ifndef EDIT_DISTANCE_H
+#define EDIT_DISTANCE_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace fuzzy {
+
+// Levenshtein distance between `a` and `b` (insertions, deletions and
+// substitutions, bytewise), or `maxDistance + 1` once it is certain to exceed
+// `maxDistance`. Plain dynamic programming restricted to the diagonal band.
+int editDistance(std::string_view a, std::string_view b, int maxDistance);
+
+// A pattern prepared for Myers' bit-parallel edit distance (in Hyyrö's form
+// for whole-string distance): one 64-bit word holds a column of the DP
+// matrix, so each text character costs a handful of word operations instead
+// of a row of cells. Build one per query and reuse it across candidates.
+// Patterns longer than 64 bytes fall back to editDistance().
+class BitParallelPattern {
+public:
+    explicit BitParallelPattern(std::string_view pattern);
+
+    // Same contract as editDistance(pattern, text, maxDistance).
+    int distance(std::string_view text, int maxDistance) const;
+
+    static constexpr size_t kMaxLength = 64;
+
+private:
+    std::string_view pattern_;
+    std::array<uint64_t, 256> peq_{}; // Bit i set where pattern[i] == c
+};
+
+} // namespace fuzzy
+
+#endif // EDIT_DISTANCE_H
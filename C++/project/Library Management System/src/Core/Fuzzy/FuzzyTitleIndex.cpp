@@ -0,0 +1,165 @@
+#include "FuzzyTitleIndex.h"
+#include "EditDistance.h"
+#include "StringUtils.h"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <numeric>
+#include <queue>
+
+// Normalized text has 37 symbols: space, a-z, 0-9.
+static constexpr uint32_t kSymbols = 37;
+static constexpr uint32_t kTrigramCodes = kSymbols * kSymbols * kSymbols;
+
+static uint32_t symbol(char c) {
+    if (c >= 'a' && c <= 'z') return 1 + static_cast<uint32_t>(c - 'a');
+    if (c >= '0' && c <= '9') return 27 + static_cast<uint32_t>(c - '0');
+    return 0;
+}
+
+// Distinct trigram codes of `normalized` padded as "  text ", ascending. The
+// padding gives the first letters (and the end) trigrams of their own, so
+// short titles and typos near the edges still share grams with the original.
+static void trigrams(std::string_view normalized, std::vector<uint32_t>& out) {
+    out.clear();
+    if (normalized.empty()) return;
+    uint32_t a = 0, b = 0; // The two padding spaces
+    auto push = [&](uint32_t c) {
+        out.push_back((a * kSymbols + b) * kSymbols + c);
+        a = b;
+        b = c;
+    };
+    for (char ch : normalized) push(symbol(ch));
+    push(0);
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+std::string FuzzyTitleIndex::normalize(std::string_view title) {
+    return util::normalizeTitle(title);
+}
+
+FuzzyTitleIndex::FuzzyTitleIndex(std::vector<std::string> titles) : titles_(std::move(titles)) {
+    // Internal ids number the titles by normalized length, so every posting
+    // list is grouped by length and a query only reads the slice of each
+    // list whose lengths are within its edit budget.
+    util::NormalizedTitles normalized = util::normalizeTitles(titles_);
+    originalId_.resize(titles_.size());
+    std::iota(originalId_.begin(), originalId_.end(), 0);
+    std::stable_sort(originalId_.begin(), originalId_.end(), [&normalized](uint32_t a, uint32_t b) {
+        return normalized[a].size() < normalized[b].size();
+    });
+
+    normalizedStart_.reserve(titles_.size() + 1);
+    for (uint32_t original : originalId_) {
+        const size_t length = normalized[original].size();
+        while (lengthStart_.size() <= length) {
+            lengthStart_.push_back(static_cast<uint32_t>(normalizedStart_.size()));
+        }
+        normalizedStart_.push_back(static_cast<uint32_t>(normalized_.size()));
+        normalized_ += normalized[original];
+    }
+    normalizedStart_.push_back(static_cast<uint32_t>(normalized_.size()));
+    lengthStart_.push_back(static_cast<uint32_t>(titles_.size()));
+    normalized = {};
+
+    // Two passes (count, then fill) build the posting arrays in place, with
+    // ids ascending in each list because titles are visited in order.
+    std::vector<uint32_t> grams;
+    postingStart_.assign(kTrigramCodes + 1, 0);
+    for (uint32_t id = 0; id < titles_.size(); ++id) {
+        trigrams(normalizedTitle(id), grams);
+        for (uint32_t g : grams) ++postingStart_[g + 1];
+    }
+    for (uint32_t g = 0; g < kTrigramCodes; ++g) {
+        postingStart_[g + 1] += postingStart_[g];
+    }
+    postings_.resize(postingStart_[kTrigramCodes]);
+    std::vector<uint32_t> cursor(postingStart_.begin(), postingStart_.end() - 1);
+    for (uint32_t id = 0; id < titles_.size(); ++id) {
+        trigrams(normalizedTitle(id), grams);
+        for (uint32_t g : grams) postings_[cursor[g]++] = id;
+    }
+}
+
+uint32_t FuzzyTitleIndex::firstIdOfLength(int length) const {
+    if (length <= 0) return 0;
+    return static_cast<size_t>(length) < lengthStart_.size() ? lengthStart_[length] : static_cast<uint32_t>(titles_.size());
+}
+
+std::string_view FuzzyTitleIndex::normalizedTitle(uint32_t id) const {
+    return std::string_view(normalized_).substr(normalizedStart_[id], normalizedStart_[id + 1] - normalizedStart_[id]);
+}
+
+std::vector<FuzzyMatch> FuzzyTitleIndex::match(std::string_view query, const FuzzyMatchOptions& options) const {
+    std::vector<FuzzyMatch> matches;
+    const std::string q = normalize(query);
+    std::vector<uint32_t> grams;
+    trigrams(q, grams);
+    if (grams.empty() || options.limit == 0) return matches;
+
+    // A budget of k edits in a short query would leave nothing of it to
+    // match on, so queries under 3k characters get a smaller one.
+    const int queryLength = static_cast<int>(q.size());
+    const int maxEdits = std::max(0, std::min(options.maxEdits, queryLength / 3));
+
+    // Titles whose length is within the budget: a contiguous range of internal ids.
+    const uint32_t lowId = firstIdOfLength(queryLength - maxEdits);
+    const uint32_t highId = firstIdOfLength(queryLength + maxEdits + 1);
+
+    const fuzzy::BitParallelPattern pattern(q);
+    auto consider = [&](uint32_t id) {
+        const std::string_view text = normalizedTitle(id);
+        const int distance = pattern.distance(text, maxEdits);
+        if (distance > maxEdits) return;
+        const double score = 1.0 - static_cast<double>(distance) / std::max(text.size(), q.size());
+        if (score >= options.minScore) matches.push_back({originalId_[id], distance, score});
+    };
+
+    const size_t lists = static_cast<size_t>(3 * maxEdits + 1);
+    if (grams.size() < lists) {
+        // Repetitive queries ("aaaaaa") have too few distinct grams to filter on.
+        for (uint32_t id = lowId; id < highId; ++id) consider(id);
+    } else {
+        std::partial_sort(grams.begin(), grams.begin() + lists, grams.end(), [this](uint32_t x, uint32_t y) {
+            return postingStart_[x + 1] - postingStart_[x] < postingStart_[y + 1] - postingStart_[y];
+        });
+
+        // K-way merge of the rarest lists yields each candidate once, in id order.
+        struct Cursor {
+            uint32_t id;
+            uint32_t position, end; // In postings_
+            bool operator>(const Cursor& other) const { return id > other.id; }
+        };
+        std::priority_queue<Cursor, std::vector<Cursor>, std::greater<Cursor>> heads;
+        for (size_t i = 0; i < lists; ++i) {
+            const auto first = postings_.begin() + postingStart_[grams[i]];
+            const auto last = postings_.begin() + postingStart_[grams[i] + 1];
+            const auto begin = std::lower_bound(first, last, lowId);
+            const auto end = std::lower_bound(begin, last, highId);
+            if (begin < end) {
+                heads.push({*begin, static_cast<uint32_t>(begin - postings_.begin()),
+                            static_cast<uint32_t>(end - postings_.begin())});
+            }
+        }
+        int64_t last = -1;
+        while (!heads.empty()) {
+            Cursor head = heads.top();
+            heads.pop();
+            const uint32_t id = head.id;
+            if (++head.position < head.end) {
+                head.id = postings_[head.position];
+                heads.push(head);
+            }
+            if (id != last) consider(id);
+            last = id;
+        }
+    }
+
+    const size_t keep = std::min(options.limit, matches.size());
+    std::partial_sort(matches.begin(), matches.begin() + keep, matches.end(), [](const FuzzyMatch& x, const FuzzyMatch& y) {
+        return x.score != y.score ? x.score > y.score : x.id < y.id;
+    });
+    matches.resize(keep);
+    return matches;
+}
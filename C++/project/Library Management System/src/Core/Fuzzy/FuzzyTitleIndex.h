@@ -0,0 +1,65 @@
+#ifndef FUZZY_TITLE_INDEX_H
+#define FUZZY_TITLE_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Tunables for FuzzyTitleIndex::match.
+struct FuzzyMatchOptions {
+    size_t limit = 5;    // Top-k matches returned
+    int maxEdits = 2;    // Most typos tolerated (at most a third of the query's length)
+    double minScore = 0.75; // Matches scoring lower are dropped
+};
+
+struct FuzzyMatch {
+    uint32_t id;       // Index of the title in the list the index was built from
+    int distance;      // Edits between the normalized query and title
+    double score;      // 1 - distance / longer length; 1.0 is an exact (normalized) match
+};
+
+// Typo-tolerant title lookup over a fixed list of titles.
+//
+// Titles and queries are normalized (lowercased, runs of anything other than
+// ASCII letters and digits folded to one space) before matching. Each title
+// is indexed by its trigrams, padded at the ends, in a compact inverted index
+// (one sorted posting array per trigram).
+//
+// A query with k allowed edits keeps at least |Q| - 3k of its trigrams in any
+// title within k edits, so such a title must appear in one of the query's
+// 3k + 1 rarest posting lists. Only those lists are scanned, and only the
+// part of each holding titles whose length is within k of the query's (ids
+// are assigned in length order for this); the candidates are then verified
+// with a bit-parallel edit distance (fuzzy::BitParallelPattern). The filter
+// loses nothing: every title within the edit budget is found, and only those.
+//
+// Read-only after construction; match() may be called from several threads.
+class FuzzyTitleIndex {
+public:
+    explicit FuzzyTitleIndex(std::vector<std::string> titles);
+
+    // Best matches for `query`, highest score first (ties: lower id first).
+    std::vector<FuzzyMatch> match(std::string_view query, const FuzzyMatchOptions& options = {}) const;
+
+    const std::string& title(uint32_t id) const { return titles_[id]; }
+    size_t size() const { return titles_.size(); }
+
+    // Lowercase, alphanumerics only, single spaces, trimmed (util::normalizeTitle).
+    static std::string normalize(std::string_view title);
+
+private:
+    // Below, "id" is an internal id: titles numbered by normalized length.
+    std::vector<std::string> titles_;       // As given (by original id)
+    std::vector<uint32_t> originalId_;      // Internal id -> original id
+    std::string normalized_;                // Normalized titles, back to back
+    std::vector<uint32_t> normalizedStart_; // Title i is [start[i], start[i + 1])
+    std::vector<uint32_t> lengthStart_;     // First id whose normalized title has at least this length
+    std::vector<uint32_t> postingStart_;    // Per trigram code, into postings_ (kTrigramCodes + 1 entries)
+    std::vector<uint32_t> postings_;        // Ids, ascending within each trigram
+
+    std::string_view normalizedTitle(uint32_t id) const;
+    uint32_t firstIdOfLength(int length) const;
+};
+
+#endif // FUZZY_TITLE_INDEX_H
@@ -0,0 +1,45 @@
+#include "BodyPipe.h"
+
+BodyPipe::BodyPipe(size_t maxChunks)
+    : maxChunks_(maxChunks > 0 ? maxChunks : 1), buffer_(*this), stream_(&buffer_)
+{}
+
+bool BodyPipe::write(std::string_view chunk) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [this] { return readClosed_ || chunks_.size() < maxChunks_; });
+    if (readClosed_) return false;
+    chunks_.emplace_back(chunk);
+    changed_.notify_all();
+    return true;
+}
+
+void BodyPipe::closeWrite() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    writeClosed_ = true;
+    changed_.notify_all();
+}
+
+void BodyPipe::closeRead() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    readClosed_ = true;
+    chunks_.clear();
+    changed_.notify_all();
+}
+
+bool BodyPipe::next(std::string& chunk) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [this] { return !chunks_.empty() || writeClosed_; });
+    if (chunks_.empty()) return false;
+    chunk = std::move(chunks_.front());
+    chunks_.pop_front();
+    changed_.notify_all(); // Room for the writer
+    return true;
+}
+
+BodyPipe::Buffer::int_type BodyPipe::Buffer::underflow() {
+    do {
+        if (!pipe_.next(current_)) return traits_type::eof();
+    } while (current_.empty());
+    setg(current_.data(), current_.data(), current_.data() + current_.size());
+    return traits_type::to_int_type(current_[0]);
+}
@@ -0,0 +1,62 @@
+#ifndef BODY_PIPE_H
+#define BODY_PIPE_H
+
+#include <condition_variable>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+// Hands a response body from the thread downloading it to a thread reading
+// it as a std::istream, chunk by chunk as it arrives. At most `maxChunks`
+// chunks wait at a time: the writer blocks when the reader falls behind, so
+// the whole body is never held in memory.
+//
+// One writer (write, closeWrite) and one reader (stream, closeRead).
+class BodyPipe {
+public:
+    explicit BodyPipe(size_t maxChunks = 8);
+
+    BodyPipe(const BodyPipe&) = delete;
+    BodyPipe& operator=(const BodyPipe&) = delete;
+
+    // Queues a copy of `chunk`. Returns false, without queueing it, once the
+    // reader has stopped: the rest of the body is not wanted.
+    bool write(std::string_view chunk);
+
+    // End of the body: the stream reports EOF once it has read what was queued.
+    void closeWrite();
+
+    // The body as it arrives. Reads block until more is written or the writer closes.
+    std::istream& stream() { return stream_; }
+
+    // The reader is done, possibly before the end: unblocks and refuses the writer.
+    void closeRead();
+
+private:
+    class Buffer : public std::streambuf {
+    public:
+        explicit Buffer(BodyPipe& pipe) : pipe_(pipe) {}
+    protected:
+        int_type underflow() override;
+    private:
+        BodyPipe& pipe_;
+        std::string current_; // Chunk being read; the get area points into it
+    };
+
+    const size_t maxChunks_;
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<std::string> chunks_;
+    bool writeClosed_ = false;
+    bool readClosed_ = false;
+
+    Buffer buffer_;
+    std::istream stream_;
+
+    bool next(std::string& chunk); // Reader side: false at the end of the body
+};
+
+#endif // BODY_PIPE_H
@@ -0,0 +1,253 @@
+#include "HttpClient.h"
+#include "BodyPipe.h"
+#include "Metrics.h"
+#include "ThreadPool.h"
+#include <cpr/cpr.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <string_view>
+#include <thread>
+
+HttpClient::HttpClient(const HttpClientOptions& options)
+    : options_(options), bucket_(options.rateLimit), breaker_(options.circuitBreaker),
+      rng_(std::random_device{}())
+{}
+
+HttpClient::~HttpClient() = default; // Out of line: cpr::Session is incomplete in the header
+
+HttpClient& HttpClient::shared() {
+    static HttpClient client;
+    return client;
+}
+
+HttpResponse HttpClient::get(const std::string& pathAndQuery) {
+    return get(pathAndQuery, CancellationToken());
+}
+
+HttpResponse HttpClient::get(const std::string& pathAndQuery, const CancellationToken& token) {
+    return get(pathAndQuery, token, BodyReader());
+}
+
+// Helper: an unsent response carrying only an error.
+static HttpResponse notSent(const std::string& error, unsigned attempts) {
+    HttpResponse result;
+    result.error = error;
+    result.attempts = attempts;
+    return result;
+}
+
+HttpResponse HttpClient::get(const std::string& pathAndQuery, const CancellationToken& token,
+                             const BodyReader& reader) {
+    for (unsigned attempt = 0;; ++attempt) {
+        if (token.cancelled()) {
+            return notSent("cancelled", attempt);
+        }
+        if (!breaker_.allow()) {
+            ++rejected_;
+            HttpResponse result = notSent("circuit open: Open Library has been failing", attempt);
+            result.circuitOpen = true;
+            return result;
+        }
+
+        // Queue behind the rate limit, unless the deadline would pass first.
+        if (auto wait = bucket_.reserve(); wait.count() > 0) {
+            if (auto left = token.remaining(); left && wait >= *left) {
+                bucket_.refund();
+                breaker_.abandon();
+                token.cancel();
+                return notSent("cancelled", attempt);
+            }
+            std::this_thread::sleep_for(wait);
+        }
+
+        auto timeout = options_.requestTimeout;
+        bool cutByDeadline = false;
+        if (auto left = token.remaining(); left && *left < timeout) {
+            timeout = std::max(*left, std::chrono::milliseconds(1)); // 0 would mean "no timeout" to curl
+            cutByDeadline = true;
+        }
+        ++sent_;
+        HttpResponse result = perform(pathAndQuery, timeout, reader);
+        result.attempts = attempt + 1;
+
+        if (cutByDeadline && result.timedOut) {
+            // curl's timer can fire a hair before the deadline; make the token
+            // agree that this request ran out of time rather than failed. The
+            // caller's budget, not the server, ended it: no verdict for the breaker.
+            breaker_.abandon();
+            token.cancel();
+            return result;
+        }
+
+        const bool retryable = result.status == 429 || result.status >= 500;
+        if (result.status != 0 && !retryable) {
+            breaker_.onSuccess();
+            bucket_.onSuccess();
+            return result;
+        }
+        breaker_.onFailure();
+        if (result.status == 429) {
+            ++throttled_;
+            bucket_.onThrottled();
+        }
+        if (!retryable || attempt >= options_.retry.maxRetries) {
+            return result;
+        }
+
+        std::chrono::milliseconds delay;
+        if (result.retryAfter.count() > 0) {
+            delay = std::min(result.retryAfter, options_.retry.maxDelay);
+        } else {
+            std::lock_guard<std::mutex> lock(rngMutex_);
+            delay = jitteredBackoff(options_.retry, attempt, rng_);
+        }
+        if (auto left = token.remaining(); left && delay >= *left) {
+            return result; // No time left for another attempt: report this one
+        }
+        ++retries_;
+        std::this_thread::sleep_for(delay);
+    }
+}
+
+HttpClientStats HttpClient::stats() const {
+    HttpClientStats s;
+    s.sent = sent_.load();
+    s.retries = retries_.load();
+    s.throttled = throttled_.load();
+    s.rejected = rejected_.load();
+    return s;
+}
+
+// True if header line `line` is header `name` (case-insensitive).
+static bool isHeader(std::string_view line, std::string_view name) {
+    if (line.size() <= name.size() || line[name.size()] != ':') return false;
+    for (size_t i = 0; i < name.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(line[i])) != name[i]) return false;
+    }
+    return true;
+}
+
+// When a reader is given, the Http stage also covers reading the body:
+// the two overlap.
+HttpResponse HttpClient::perform(const std::string& pathAndQuery, std::chrono::milliseconds timeout,
+                                 const BodyReader& reader) {
+    ScopedTimer timer(Stage::Http);
+    auto session = acquire();
+    session->SetUrl(cpr::Url{options_.baseUrl + pathAndQuery});
+    session->SetTimeout(cpr::Timeout{timeout}); // Per request: pooled sessions may carry a deadline-cut one
+
+    // Both callbacks are set on every request, as pooled sessions keep them.
+    // A status line starts a new response (after a redirect or 100 Continue).
+    HttpResponse result;
+    std::string firstChunk; // A 2xx body is held back until a second chunk shows it needs the pipe
+    std::unique_ptr<BodyPipe> pipe;
+    std::future<void> reading;
+    bool stoppedByReader = false;
+    auto startReading = [&]() {
+        pipe = std::make_unique<BodyPipe>();
+        reading = readers().submit([&reader, &body = *pipe]() {
+            struct Done { BodyPipe& body; ~Done() { body.closeRead(); } } done{body}; // Even if reader throws
+            reader(body.stream());
+        });
+    };
+    auto streaming = [&]() { return reader && result.status >= 200 && result.status < 300; };
+    session->SetHeaderCallback(cpr::HeaderCallback{[&result](std::string_view line, intptr_t) {
+        if (line.substr(0, 5) == "HTTP/") {
+            const size_t space = line.find(' ');
+            result.status = space == std::string_view::npos ? 0 : std::atol(std::string(line.substr(space + 1, 3)).c_str());
+            result.retryAfter = std::chrono::milliseconds(0);
+        } else if (isHeader(line, "retry-after")) {
+            // The delay-seconds form; the HTTP-date form is ignored.
+            result.retryAfter = std::chrono::seconds(std::atoi(std::string(line.substr(12)).c_str()));
+        }
+        return true;
+    }});
+    session->SetWriteCallback(cpr::WriteCallback{[&](std::string_view chunk, intptr_t) {
+        if (!streaming()) {
+            result.body.append(chunk);
+            return true;
+        }
+        if (!pipe) {
+            if (firstChunk.empty()) {
+                firstChunk.assign(chunk);
+                return true;
+            }
+            startReading();
+            stoppedByReader = !pipe->write(firstChunk);
+            firstChunk.clear();
+        }
+        stoppedByReader = stoppedByReader || !pipe->write(chunk);
+        return !stoppedByReader;
+    }});
+    cpr::Response resp = session->Get();
+
+    if (!pipe && !resp.error && streaming()) {
+        // The whole body came in one piece (or none): read it right here,
+        // sparing small responses the hand-off to another thread.
+        struct View : std::streambuf {
+            explicit View(std::string& s) { setg(&s[0], &s[0], &s[0] + s.size()); }
+        } view(firstChunk);
+        std::istream body(&view);
+        result.streamed = true;
+        release(std::move(session));
+        reader(body);
+        return result;
+    }
+    if (pipe) {
+        pipe->closeWrite();
+        reading.wait();
+        result.streamed = true;
+    }
+    if (!stoppedByReader) {
+        // The reader not wanting the rest is its own business, not a failed request.
+        result.status = resp.status_code;
+        if (resp.error) {
+            result.error = resp.error.message;
+            result.timedOut = resp.error.code == cpr::ErrorCode::OPERATION_TIMEDOUT;
+        }
+    }
+    release(std::move(session));
+    if (reading.valid()) reading.get(); // Rethrows what the reader threw
+    return result;
+}
+
+ThreadPool& HttpClient::readers() {
+    // Each reader only waits on its own download, so a transfer whose reader
+    // is queued behind busy ones just pauses until a thread is free.
+    std::call_once(readersOnce_, [this]() {
+        readers_ = std::make_unique<ThreadPool>(std::max<size_t>(options_.maxIdleSessions, 1));
+    });
+    return *readers_;
+}
+
+// Reuses an idle session (and its open connection) or creates a new one.
+std::unique_ptr<cpr::Session> HttpClient::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!idle_.empty()) {
+            auto session = std::move(idle_.back());
+            idle_.pop_back();
+            return session;
+        }
+    }
+
+    auto session = std::make_unique<cpr::Session>();
+    session->SetConnectTimeout(cpr::ConnectTimeout{options_.connectTimeout});
+    session->SetHeader(cpr::Header{{"User-Agent", "LibraryManager/1.0"}, {"Connection", "keep-alive"}});
+    // An empty list asks for every encoding libcurl can decode.
+    session->SetAcceptEncoding(options_.compression ? cpr::AcceptEncoding{}
+                                                    : cpr::AcceptEncoding{cpr::AcceptEncodingMethods::disabled});
+    if (options_.http2) {
+        session->SetHttpVersion(cpr::HttpVersion{cpr::HttpVersionCode::VERSION_2_0_TLS});
+    }
+    return session;
+}
+
+// Returns a session to the pool; beyond maxIdleSessions it is closed instead.
+void HttpClient::release(std::unique_ptr<cpr::Session> session) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.size() < options_.maxIdleSessions) {
+        idle_.push_back(std::move(session));
+    }
+}
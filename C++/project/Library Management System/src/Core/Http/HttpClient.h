@@ -0,0 +1,129 @@
+#ifndef HTTP_CLIENT_H
+#define HTTP_CLIENT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+#include "CancellationToken.h"
+#include "RateControl.h"
+
+namespace cpr { class Session; }
+class ThreadPool;
+
+// Settings for the shared HTTP client.
+struct HttpClientOptions {
+    std::string baseUrl = "https://openlibrary.org"; // Prepended to every request path
+    std::chrono::milliseconds connectTimeout{3000};
+    std::chrono::milliseconds requestTimeout{10000};  // Whole request, including the body
+    size_t maxIdleSessions = 8;  // Warm connections kept around between requests
+    bool http2 = true;           // Negotiate HTTP/2 over TLS when the server offers it
+    bool compression = true;     // Ask for compressed bodies (see HttpClient)
+    RateLimitOptions rateLimit;      // Shared by every request through this client
+    RetryOptions retry;
+    CircuitBreakerOptions circuitBreaker;
+};
+
+// Counters for the outbound traffic controls.
+struct HttpClientStats {
+    uint64_t sent = 0;      // Requests put on the wire, retries included
+    uint64_t retries = 0;
+    uint64_t throttled = 0; // 429 responses
+    uint64_t rejected = 0;  // Refused locally because the circuit was open
+};
+
+// Result of one GET. `status` is 0 when no HTTP response was received,
+// in which case `error` says why (timeout, DNS failure, ...).
+struct HttpResponse {
+    long status = 0;
+    std::string body;      // Empty when a BodyReader took it
+    bool streamed = false; // The body went to a BodyReader
+    std::string error;
+    bool timedOut = false; // No complete response within the request timeout
+    bool circuitOpen = false; // Not sent: Open Library has been failing (see CircuitBreaker)
+    unsigned attempts = 0;    // Requests sent for this call, retries included
+    std::chrono::milliseconds retryAfter{0}; // Server's Retry-After, if it sent one
+};
+
+// Reads a 2xx response body from `body` while it downloads, decompressed.
+// Runs on a thread of the client's, or on the calling one when the whole body
+// arrives at once; the stream ends where the body does (early if the
+// transfer fails).
+using BodyReader = std::function<void(std::istream& body)>;
+
+// Long-lived HTTP client shared by every service that talks to Open Library.
+//
+// Each cpr::Session owns one libcurl handle, and a handle keeps its TCP+TLS
+// connection alive between requests. The client keeps a pool of idle sessions:
+// a request borrows one (reusing its warm connection), and returns it when done.
+// Concurrent requests each get their own session, so the client is thread-safe.
+//
+// All traffic also passes one set of controls: a token-bucket rate limit that
+// halves on 429 and recovers on success, retries with jittered exponential
+// backoff (honouring Retry-After) for 429 and 5xx, and a circuit breaker that
+// fails fast while Open Library keeps failing. Transport errors (no response)
+// are not retried; they count towards the breaker.
+//
+// Responses are requested compressed in every encoding libcurl can decode
+// (gzip and deflate, plus br and zstd when it is built with them); libcurl
+// inflates them as they arrive, so callers only ever see plain bytes.
+class HttpClient {
+public:
+    explicit HttpClient(const HttpClientOptions& options = {});
+    ~HttpClient();
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    // Process-wide client with default options, used by services that are not
+    // given one explicitly.
+    static HttpClient& shared();
+
+    // GETs `pathAndQuery` (e.g. "/search.json?q=dune") relative to the base URL.
+    // The result is the last attempt's response once retries are used up.
+    HttpResponse get(const std::string& pathAndQuery);
+
+    // Same, but gives up at the token's deadline: the request timeout is cut to
+    // the time remaining, and nothing is sent if the token is already cancelled
+    // (status 0, error "cancelled"). A request that times out after being
+    // cut short cancels the token, so callers can tell a deadline from an outage.
+    // Rate-limit waits and retry backoffs also stay within the deadline.
+    HttpResponse get(const std::string& pathAndQuery, const CancellationToken& token);
+
+    // Same, but a 2xx body is not collected in `body`: `reader` reads it while
+    // it downloads, so only a few chunks of it are held at a time. `reader`
+    // has returned (and any exception it threw is rethrown) by the time this
+    // does. Other responses, retried ones included, never reach `reader`.
+    HttpResponse get(const std::string& pathAndQuery, const CancellationToken& token, const BodyReader& reader);
+
+    const HttpClientOptions& options() const { return options_; }
+
+    HttpClientStats stats() const;
+    CircuitBreaker::State circuitState() const { return breaker_.state(); }
+
+private:
+    HttpClientOptions options_;
+    std::mutex mutex_; // Guards idle_
+    std::vector<std::unique_ptr<cpr::Session>> idle_;
+
+    TokenBucket bucket_;
+    CircuitBreaker breaker_;
+    std::mutex rngMutex_; // Guards rng_
+    std::mt19937_64 rng_; // Backoff jitter
+    std::atomic<uint64_t> sent_{0}, retries_{0}, throttled_{0}, rejected_{0};
+    std::once_flag readersOnce_;
+    std::unique_ptr<ThreadPool> readers_; // Runs BodyReaders; started on first use
+
+    HttpResponse perform(const std::string& pathAndQuery, std::chrono::milliseconds timeout, const BodyReader& reader);
+    ThreadPool& readers();
+    std::unique_ptr<cpr::Session> acquire();
+    void release(std::unique_ptr<cpr::Session> session);
+};
+
+#endif // HTTP_CLIENT_H
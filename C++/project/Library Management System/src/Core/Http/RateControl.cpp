@@ -0,0 +1,105 @@
+#include "RateControl.h"
+#include <algorithm>
+#include <cmath>
+
+TokenBucket::TokenBucket(const RateLimitOptions& options)
+    : options_(options), rate_(options.requestsPerSecond), tokens_(options.burst), last_(Clock::now())
+{}
+
+void TokenBucket::refill(Clock::time_point now) {
+    const double elapsed = std::chrono::duration<double>(now - last_).count();
+    tokens_ = std::min(options_.burst, tokens_ + elapsed * rate_);
+    last_ = now;
+}
+
+std::chrono::milliseconds TokenBucket::reserve() {
+    if (options_.requestsPerSecond <= 0) return std::chrono::milliseconds(0);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    refill(Clock::now());
+    tokens_ -= 1.0;
+    if (tokens_ >= 0) return std::chrono::milliseconds(0);
+    // In debt: wait until the rate has paid this token back.
+    return std::chrono::milliseconds(static_cast<int64_t>(std::ceil(-tokens_ / rate_ * 1000.0)));
+}
+
+void TokenBucket::refund() {
+    if (options_.requestsPerSecond <= 0) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    tokens_ = std::min(options_.burst, tokens_ + 1.0);
+}
+
+void TokenBucket::onThrottled() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refill(Clock::now());
+    rate_ = std::max(options_.minRequestsPerSecond, rate_ / 2);
+}
+
+void TokenBucket::onSuccess() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (rate_ < options_.requestsPerSecond) {
+        refill(Clock::now());
+        rate_ = std::min(options_.requestsPerSecond, rate_ + options_.requestsPerSecond / 20);
+    }
+}
+
+double TokenBucket::currentRate() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rate_;
+}
+
+CircuitBreaker::CircuitBreaker(const CircuitBreakerOptions& options)
+    : options_(options)
+{}
+
+bool CircuitBreaker::allow() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    switch (state_) {
+        case State::Closed:
+            return true;
+        case State::Open:
+            if (Clock::now() - openedAt_ < options_.openDuration) return false;
+            state_ = State::HalfOpen;
+            probing_ = false;
+            [[fallthrough]];
+        case State::HalfOpen:
+            if (probing_) return false; // Someone else is already probing
+            probing_ = true;
+            return true;
+    }
+    return false;
+}
+
+void CircuitBreaker::onSuccess() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state_ = State::Closed;
+    failures_ = 0;
+    probing_ = false;
+}
+
+void CircuitBreaker::onFailure() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    probing_ = false;
+    if (state_ == State::HalfOpen || ++failures_ >= options_.failureThreshold) {
+        state_ = State::Open;
+        openedAt_ = Clock::now();
+        failures_ = 0;
+    }
+}
+
+void CircuitBreaker::abandon() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    probing_ = false;
+}
+
+CircuitBreaker::State CircuitBreaker::state() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_;
+}
+
+std::chrono::milliseconds jitteredBackoff(const RetryOptions& options, unsigned retry, std::mt19937_64& rng) {
+    const double ceiling = std::min<double>(static_cast<double>(options.maxDelay.count()),
+                                            options.baseDelay.count() * std::ldexp(1.0, static_cast<int>(std::min(retry, 30u))));
+    std::uniform_real_distribution<double> wait(0.0, ceiling);
+    return std::chrono::milliseconds(static_cast<int64_t>(wait(rng)));
+}
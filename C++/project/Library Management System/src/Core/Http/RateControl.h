@@ -0,0 +1,97 @@
+#ifndef RATE_CONTROL_H
+#define RATE_CONTROL_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+// Outbound request rate. Zero requestsPerSecond disables the limit.
+struct RateLimitOptions {
+    double requestsPerSecond = 5.0;    // Steady rate while Open Library is happy
+    double burst = 10.0;               // Requests allowed back to back after a quiet spell
+    double minRequestsPerSecond = 0.5; // Floor when backing off after 429s
+};
+
+// Retries for throttled (429) and server-error (5xx) responses.
+struct RetryOptions {
+    unsigned maxRetries = 3;                      // Attempts after the first
+    std::chrono::milliseconds baseDelay{200};     // Backoff ceiling before the first retry, doubled each time
+    std::chrono::milliseconds maxDelay{5000};     // Cap on any single wait, Retry-After included
+};
+
+// When to stop calling a server that keeps failing.
+struct CircuitBreakerOptions {
+    unsigned failureThreshold = 5;                  // Consecutive failures that open the circuit
+    std::chrono::milliseconds openDuration{30000};  // How long to fail fast before probing again
+};
+
+// Token bucket with an adaptive rate (AIMD): every 429 halves the rate, down
+// to the floor, and every success wins back a twentieth of the configured rate.
+// Thread-safe.
+class TokenBucket {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit TokenBucket(const RateLimitOptions& options);
+
+    // Takes a token and returns how long the caller must wait before sending.
+    // Callers queue fairly: each reservation pushes the next one further out.
+    std::chrono::milliseconds reserve();
+
+    // Gives a reserved token back (the caller decided not to send).
+    void refund();
+
+    void onThrottled();
+    void onSuccess();
+
+    double currentRate() const;
+
+private:
+    RateLimitOptions options_;
+    mutable std::mutex mutex_;
+    double rate_;    // Tokens per second right now
+    double tokens_;  // May go negative: outstanding reservations
+    Clock::time_point last_;
+
+    void refill(Clock::time_point now);
+};
+
+// Closed -> Open after failureThreshold consecutive failures. While open,
+// requests are refused without touching the network. After openDuration one
+// probe is let through (half-open): success closes the circuit, failure
+// reopens it. Thread-safe.
+class CircuitBreaker {
+public:
+    using Clock = std::chrono::steady_clock;
+    enum class State { Closed, Open, HalfOpen };
+
+    explicit CircuitBreaker(const CircuitBreakerOptions& options);
+
+    // True if a request may be sent now. In half-open state only one caller
+    // at a time gets true; it must report back with onSuccess()/onFailure().
+    bool allow();
+
+    void onSuccess();
+    void onFailure();
+
+    // Releases a half-open probe slot without a verdict (e.g. the caller's deadline ran out).
+    void abandon();
+
+    State state() const;
+
+private:
+    CircuitBreakerOptions options_;
+    mutable std::mutex mutex_;
+    State state_ = State::Closed;
+    unsigned failures_ = 0;
+    bool probing_ = false;
+    Clock::time_point openedAt_;
+};
+
+// Full-jitter exponential backoff: a uniformly random wait in
+// [0, min(maxDelay, baseDelay * 2^retry)]. Spreads out clients that were
+// throttled at the same moment instead of having them retry in lockstep.
+std::chrono::milliseconds jitteredBackoff(const RetryOptions& options, unsigned retry, std::mt19937_64& rng);
+
+#endif // RATE_CONTROL_H
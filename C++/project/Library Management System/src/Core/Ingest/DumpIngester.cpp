@@ -0,0 +1,509 @@
+#include "DumpIngester.h"
+#include "CatalogDB.h"
+#include "Logger.h"
+#include <nlohmann/json.hpp>
+#include <zlib.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+using json = nlohmann::json;
+
+// Bytes handed to the line splitter per read (after decompression).
+static constexpr size_t kReadBlockBytes = 1 << 20;
+
+namespace {
+
+// Blocking FIFO with a capacity, so a fast stage waits for a slow one instead
+// of buffering a whole dump in memory. close() ends the stream.
+template <class T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity) {}
+
+    void push(T value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this]() { return items_.size() < capacity_; });
+        items_.push_back(std::move(value));
+        notEmpty_.notify_one();
+    }
+
+    // Empty optional once the queue is closed and drained.
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this]() { return !items_.empty() || closed_; });
+        if (items_.empty()) return std::nullopt;
+        T value = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return value;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        notEmpty_.notify_all();
+    }
+
+private:
+    size_t capacity_;
+    std::mutex mutex_;
+    std::condition_variable notFull_, notEmpty_;
+    std::deque<T> items_;
+    bool closed_ = false;
+};
+
+// "/works/OL45804W" -> "OL45804W"
+std::string stripPrefix(const std::string& key, const char* prefix) {
+    const size_t n = std::char_traits<char>::length(prefix);
+    return key.compare(0, n, prefix) == 0 ? key.substr(n) : key;
+}
+
+// First run of four digits, e.g. "1954" from "July 29, 1954".
+std::string firstYear(const std::string& text) {
+    for (size_t i = 0; i + 4 <= text.size(); ++i) {
+        if (std::all_of(text.begin() + i, text.begin() + i + 4, [](unsigned char c) { return std::isdigit(c); })) {
+            return text.substr(i, 4);
+        }
+    }
+    return "";
+}
+
+std::string stringField(const json& j, const char* name) {
+    auto it = j.find(name);
+    return it != j.end() && it->is_string() ? it->get<std::string>() : std::string();
+}
+
+// First string of an array field, or empty.
+std::string firstString(const json& j, const char* name) {
+    auto it = j.find(name);
+    if (it == j.end() || !it->is_array()) return "";
+    for (const auto& v : *it) {
+        if (v.is_string()) return v.get<std::string>();
+    }
+    return "";
+}
+
+void parseWork(const json& j, DumpRecord& r) {
+    r.title = stringField(j, "title");
+
+    // Search-style records name their authors; dump records only link to them,
+    // as [{"author": {"key": "/authors/OL1A"}}] (or [{"key": ...}] in old revisions).
+    r.authorName = firstString(j, "author_name");
+    if (r.authorName.empty()) {
+        auto authors = j.find("authors");
+        if (authors != j.end() && authors->is_array() && !authors->empty() && (*authors)[0].is_object()) {
+            const json& first = (*authors)[0];
+            auto author = first.find("author");
+            const json& ref = author != first.end() && author->is_object() ? *author : first;
+            r.authorKey = stripPrefix(stringField(ref, "key"), "/authors/");
+        }
+    }
+
+    auto year = j.find("first_publish_year");
+    if (year != j.end() && year->is_number_integer()) {
+        r.publishYear = std::to_string(year->get<int64_t>());
+    } else {
+        r.publishYear = firstYear(stringField(j, "first_publish_date"));
+    }
+
+    for (const char* field : {"covers", "cover_i"}) {
+        auto covers = j.find(field);
+        if (covers == j.end()) continue;
+        if (covers->is_number_integer() && covers->get<int64_t>() > 0) {
+            r.coverId = covers->get<int64_t>();
+        } else if (covers->is_array()) {
+            for (const auto& c : *covers) {
+                if (c.is_number_integer() && c.get<int64_t>() > 0) {
+                    r.coverId = c.get<int64_t>();
+                    break;
+                }
+            }
+        }
+        break;
+    }
+
+    for (const char* field : {"subjects", "subject"}) {
+        auto subjects = j.find(field);
+        if (subjects == j.end() || !subjects->is_array()) continue;
+        for (const auto& s : *subjects) {
+            if (r.subjects.size() == CatalogDB::kMaxSubjects) break;
+            // '\n' separates subjects in the catalog
+            if (s.is_string() && s.get_ref<const std::string&>().find('\n') == std::string::npos) {
+                r.subjects.push_back(s.get<std::string>());
+            }
+        }
+        break;
+    }
+}
+
+} // namespace
+
+DumpRecord DumpIngester::parseLine(std::string_view line) {
+    DumpRecord r;
+    while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) line.remove_suffix(1);
+    if (line.empty()) {
+        r.kind = DumpRecord::Kind::Malformed;
+        return r;
+    }
+
+    // TSV dump line: type, key, revision, last_modified, JSON. Otherwise JSON only.
+    std::string type;
+    std::string_view text = line;
+    if (line.front() != '{') {
+        size_t pos = 0;
+        for (int column = 0; column < 4; ++column) {
+            pos = line.find('\t', pos);
+            if (pos == std::string_view::npos) {
+                r.kind = DumpRecord::Kind::Malformed;
+                return r;
+            }
+            if (column == 0) type = std::string(line.substr(0, pos));
+            ++pos;
+        }
+        text = line.substr(pos);
+    }
+
+    json j = json::parse(text.begin(), text.end(), nullptr, false);
+    if (j.is_discarded() || !j.is_object()) {
+        r.kind = DumpRecord::Kind::Malformed;
+        return r;
+    }
+    const std::string key = stringField(j, "key");
+    if (type.empty()) {
+        auto t = j.find("type");
+        type = t != j.end() && t->is_object() ? stringField(*t, "key") : "";
+    }
+    if (type.empty()) {
+        // Search-style JSONL has no type; the key says what it is.
+        type = key.rfind("/works/", 0) == 0 ? "/type/work" : key.rfind("/authors/", 0) == 0 ? "/type/author" : "";
+    }
+
+    if (type == "/type/work") {
+        r.key = stripPrefix(key, "/works/");
+        parseWork(j, r);
+        r.kind = r.key.empty() || r.title.empty() ? DumpRecord::Kind::Malformed : DumpRecord::Kind::Work;
+    } else if (type == "/type/author") {
+        r.key = stripPrefix(key, "/authors/");
+        r.authorName = stringField(j, "name");
+        r.kind = r.key.empty() || r.authorName.empty() ? DumpRecord::Kind::Malformed : DumpRecord::Kind::Author;
+    }
+    return r;
+}
+
+DumpIngester::DumpIngester(const std::string& catalogPath, const IngestOptions& options)
+    : path_(catalogPath), options_(options) {
+    if (options_.parserThreads == 0) {
+        options_.parserThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    options_.linesPerChunk = std::max<size_t>(1, options_.linesPerChunk);
+    options_.rowsPerTransaction = std::max<size_t>(1, options_.rowsPerTransaction);
+
+    if (sqlite3_open(path_.c_str(), &db_) != SQLITE_OK) {
+        LOG_ERROR("DumpIngester", "Cannot open catalog", sqlite3_errmsg(db_));
+        sqlite3_close(db_);
+        db_ = nullptr;
+        return;
+    }
+
+    // Bulk-load settings: no rollback journal and no fsync. A crash mid-load
+    // can corrupt the file, which is why it is rebuilt rather than repaired.
+    // The indexes are dropped so inserts only append; finish() rebuilds them.
+    std::string error;
+    if (!exec("PRAGMA journal_mode=OFF; PRAGMA synchronous=OFF; PRAGMA temp_store=MEMORY;"
+              "PRAGMA cache_size=-262144;", error) ||
+        (!CatalogDB::createSchema(db_, error) && error.find("fts5") == std::string::npos) ||
+        !exec("DROP INDEX IF EXISTS works_key; DROP INDEX IF EXISTS authors_key;", error)) {
+        LOG_ERROR("DumpIngester", "Cannot prepare catalog for loading", error);
+        sqlite3_close(db_);
+        db_ = nullptr;
+        return;
+    }
+
+    // Row ids are given, not assigned: see run().
+    const char* workSql = "INSERT INTO works (id, work_key, title, author, author_key, publish_year, cover_id, subjects) "
+                          "VALUES (?, ?, ?, ?, ?, ?, ?, ?);";
+    const char* authorSql = "INSERT INTO authors (rowid, key, name) VALUES (?, ?, ?);";
+    if (sqlite3_prepare_v2(db_, workSql, -1, &insertWorkStmt_, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(db_, authorSql, -1, &insertAuthorStmt_, nullptr) != SQLITE_OK) {
+        LOG_ERROR("DumpIngester", "Failed to prepare statements", sqlite3_errmsg(db_));
+        sqlite3_finalize(insertWorkStmt_);
+        sqlite3_close(db_);
+        db_ = nullptr;
+    }
+}
+
+DumpIngester::~DumpIngester() {
+    if (!db_) return;
+    if (dirty_) {
+        finish();
+    }
+    sqlite3_finalize(insertWorkStmt_);
+    sqlite3_finalize(insertAuthorStmt_);
+    sqlite3_close(db_);
+}
+
+bool DumpIngester::exec(const char* sql, std::string& error) {
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db_, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        error = errMsg ? errMsg : "unknown error";
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+IngestStats DumpIngester::ingest(std::istream& in) {
+    return run([&in](char* buffer, size_t capacity) -> long {
+        in.read(buffer, static_cast<std::streamsize>(capacity));
+        if (in.bad()) return -1;
+        return static_cast<long>(in.gcount());
+    });
+}
+
+IngestStats DumpIngester::ingestFile(const std::string& path) {
+    gzFile file = gzopen(path.c_str(), "rb"); // Reads uncompressed files as they are
+    if (!file) {
+        IngestStats stats;
+        stats.error = "Cannot open " + path;
+        return stats;
+    }
+    gzbuffer(file, 1 << 17);
+    IngestStats stats = run([file](char* buffer, size_t capacity) -> long {
+        return gzread(file, buffer, static_cast<unsigned>(capacity));
+    });
+    gzclose(file);
+    return stats;
+}
+
+IngestStats DumpIngester::run(const ReadFn& read) {
+    IngestStats stats;
+    if (!db_) {
+        stats.error = "Catalog is not open";
+        return stats;
+    }
+    const auto start = std::chrono::steady_clock::now();
+
+    struct Lines {
+        uint64_t first = 0; // Line number of lines[0] in this dump
+        std::vector<std::string> lines;
+    };
+    using Records = std::vector<std::pair<uint64_t, DumpRecord>>; // (line number, record)
+    const size_t depth = options_.parserThreads * 2;
+    BoundedQueue<Lines> lineQueue(depth);
+    BoundedQueue<Records> recordQueue(depth);
+    std::atomic<uint64_t> skipped{0}, malformed{0};
+
+    // Chunks reach the writer in whatever order the parsers finish them, so
+    // each row's id is its line number past the ids already in the file.
+    // finish() keeps the highest id per key: the copy latest in the dumps.
+    int64_t workBase = 0, authorBase = 0;
+    if (!maxRowid("works", workBase, stats.error) || !maxRowid("authors", authorBase, stats.error)) {
+        return stats;
+    }
+
+    // Parsers: lines -> records.
+    std::vector<std::thread> parsers;
+    for (size_t i = 0; i < options_.parserThreads; ++i) {
+        parsers.emplace_back([&]() {
+            while (auto chunk = lineQueue.pop()) {
+                Records records;
+                records.reserve(chunk->lines.size());
+                uint64_t chunkSkipped = 0, chunkMalformed = 0;
+                for (size_t n = 0; n < chunk->lines.size(); ++n) {
+                    DumpRecord r = parseLine(chunk->lines[n]);
+                    if (r.kind == DumpRecord::Kind::Work || r.kind == DumpRecord::Kind::Author) {
+                        records.emplace_back(chunk->first + n, std::move(r));
+                    } else if (r.kind == DumpRecord::Kind::Other) {
+                        ++chunkSkipped;
+                    } else {
+                        ++chunkMalformed;
+                    }
+                }
+                skipped += chunkSkipped;
+                malformed += chunkMalformed;
+                recordQueue.push(std::move(records));
+            }
+        });
+    }
+
+    // Writer: records -> SQLite, one transaction per rowsPerTransaction rows.
+    std::thread writer([&]() {
+        std::string error;
+        bool failed = !exec("BEGIN;", error);
+        uint64_t inTransaction = 0, nextProgress = options_.progressEvery;
+        while (auto records = recordQueue.pop()) {
+            if (failed) continue; // Keep draining so the other stages can finish
+            for (const auto& [line, r] : *records) {
+                const int64_t base = r.kind == DumpRecord::Kind::Work ? workBase : authorBase;
+                if (!insert(r, base + 1 + static_cast<int64_t>(line), stats)) {
+                    error = sqlite3_errmsg(db_);
+                    failed = true;
+                    break;
+                }
+                if (++inTransaction >= options_.rowsPerTransaction) {
+                    failed = !exec("COMMIT; BEGIN;", error);
+                    inTransaction = 0;
+                }
+            }
+            if (options_.onProgress && stats.works + stats.authors >= nextProgress) {
+                nextProgress += options_.progressEvery;
+                IngestStats progress = stats;
+                progress.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                options_.onProgress(progress);
+            }
+        }
+        if (!failed) {
+            failed = !exec("COMMIT;", error);
+        } else {
+            sqlite3_exec(db_, "COMMIT;", nullptr, nullptr, nullptr); // Keep what made it in
+        }
+        if (failed) stats.error = error;
+    });
+
+    // Reader (this thread): blocks -> lines -> chunks.
+    std::vector<char> buffer(kReadBlockBytes);
+    std::string partial; // Line split across blocks
+    uint64_t lines = 0; // Not stats.lines: the writer copies stats for onProgress
+    Lines chunk;
+    chunk.lines.reserve(options_.linesPerChunk);
+    long n;
+    while ((n = read(buffer.data(), buffer.size())) > 0) {
+        size_t begin = 0;
+        for (size_t i = 0; i < static_cast<size_t>(n); ++i) {
+            if (buffer[i] != '\n') continue;
+            partial.append(buffer.data() + begin, i - begin);
+            begin = i + 1;
+            ++lines;
+            chunk.lines.push_back(std::move(partial));
+            partial.clear();
+            if (chunk.lines.size() == options_.linesPerChunk) {
+                lineQueue.push(std::move(chunk));
+                chunk = Lines();
+                chunk.first = lines;
+                chunk.lines.reserve(options_.linesPerChunk);
+            }
+        }
+        partial.append(buffer.data() + begin, static_cast<size_t>(n) - begin);
+    }
+    if (!partial.empty()) {
+        ++lines;
+        chunk.lines.push_back(std::move(partial));
+    }
+    if (!chunk.lines.empty()) {
+        lineQueue.push(std::move(chunk));
+    }
+    lineQueue.close();
+    for (auto& t : parsers) t.join();
+    recordQueue.close();
+    writer.join();
+
+    if (n < 0 && stats.error.empty()) {
+        stats.error = "Read error in dump (truncated or corrupt file?)";
+    }
+    stats.lines = lines;
+    stats.skipped = skipped.load();
+    stats.malformed = malformed.load();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    dirty_ = dirty_ || stats.works + stats.authors > 0;
+    return stats;
+}
+
+bool DumpIngester::maxRowid(const char* table, int64_t& rowid, std::string& error) {
+    sqlite3_stmt* stmt = nullptr;
+    const std::string sql = std::string("SELECT COALESCE(MAX(rowid), 0) FROM ") + table + ";";
+    const bool ok = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK &&
+                    sqlite3_step(stmt) == SQLITE_ROW;
+    if (ok) {
+        rowid = sqlite3_column_int64(stmt, 0);
+    } else {
+        error = sqlite3_errmsg(db_);
+    }
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+bool DumpIngester::insert(const DumpRecord& r, int64_t rowid, IngestStats& stats) {
+    auto bindText = [](sqlite3_stmt* stmt, int index, const std::string& value) {
+        if (value.empty()) {
+            sqlite3_bind_null(stmt, index);
+        } else {
+            sqlite3_bind_text(stmt, index, value.data(), static_cast<int>(value.size()), SQLITE_STATIC);
+        }
+    };
+
+    sqlite3_stmt* stmt;
+    if (r.kind == DumpRecord::Kind::Work) {
+        stmt = insertWorkStmt_;
+        std::string subjects;
+        for (const auto& s : r.subjects) {
+            if (!subjects.empty()) subjects += '\n';
+            subjects += s;
+        }
+        sqlite3_bind_int64(stmt, 1, rowid);
+        bindText(stmt, 2, r.key);
+        bindText(stmt, 3, r.title);
+        bindText(stmt, 4, r.authorName);
+        bindText(stmt, 5, r.authorKey);
+        bindText(stmt, 6, r.publishYear);
+        if (r.coverId > 0) {
+            sqlite3_bind_int64(stmt, 7, r.coverId);
+        } else {
+            sqlite3_bind_null(stmt, 7);
+        }
+        bindText(stmt, 8, subjects);
+        const bool done = sqlite3_step(stmt) == SQLITE_DONE; // Before `subjects` goes out of scope
+        sqlite3_reset(stmt);
+        if (done) ++stats.works;
+        return done;
+    }
+
+    stmt = insertAuthorStmt_;
+    sqlite3_bind_int64(stmt, 1, rowid);
+    bindText(stmt, 2, r.key);
+    bindText(stmt, 3, r.authorName);
+    const bool done = sqlite3_step(stmt) == SQLITE_DONE;
+    sqlite3_reset(stmt);
+    if (done) ++stats.authors;
+    return done;
+}
+
+bool DumpIngester::finish() {
+    if (!db_) return false;
+    const auto start = std::chrono::steady_clock::now();
+
+    // One pass each, after the load, instead of index maintenance per row.
+    // The works_fts statement fails harmlessly if this SQLite has no FTS5.
+    const char* sql = R"(
+        BEGIN;
+        DELETE FROM works WHERE id NOT IN (SELECT MAX(id) FROM works GROUP BY work_key);
+        DELETE FROM authors WHERE rowid NOT IN (SELECT MAX(rowid) FROM authors GROUP BY key);
+        CREATE UNIQUE INDEX IF NOT EXISTS works_key ON works (work_key);
+        CREATE UNIQUE INDEX IF NOT EXISTS authors_key ON authors (key);
+        UPDATE works SET author = (SELECT name FROM authors WHERE key = works.author_key)
+            WHERE author IS NULL AND author_key IS NOT NULL;
+        COMMIT;
+    )";
+    std::string error;
+    if (!exec(sql, error)) {
+        sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+        LOG_ERROR("DumpIngester", "Failed to index the catalog", error);
+        return false;
+    }
+    if (!exec("INSERT INTO works_fts (works_fts) VALUES ('rebuild');", error)) {
+        LOG_ERROR("DumpIngester", "Catalog search index unavailable", error);
+    }
+    exec("PRAGMA journal_mode=WAL;", error); // Back to the settings readers expect
+    dirty_ = false;
+    LOG_INFO("DumpIngester", "Catalog indexed; milliseconds",
+             static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::steady_clock::now() - start).count()));
+    return true;
+}
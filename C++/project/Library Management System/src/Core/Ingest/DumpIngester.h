@@ -0,0 +1,98 @@
+#ifndef DUMP_INGESTER_H
+#define DUMP_INGESTER_H
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sqlite3.h>
+
+// Counters for one ingest() call (or a whole run, when summed by the caller).
+struct IngestStats {
+    uint64_t lines = 0;     // Dump lines read
+    uint64_t works = 0;     // Work rows written
+    uint64_t authors = 0;   // Author rows written
+    uint64_t skipped = 0;   // Other record types (editions, redirects, ...)
+    uint64_t malformed = 0; // Lines that were not valid JSON or lacked a key/title
+    double seconds = 0;
+    std::string error;      // Empty on success
+};
+
+struct IngestOptions {
+    size_t parserThreads = 0;            // JSON parsing threads; 0 = one per core
+    size_t linesPerChunk = 4096;         // Unit of work handed to a parser thread
+    size_t rowsPerTransaction = 200000;  // Rows per COMMIT while loading
+    // Called on the writer thread about every `progressEvery` rows, e.g. to print progress.
+    std::function<void(const IngestStats&)> onProgress;
+    uint64_t progressEvery = 1000000;
+};
+
+// One dump line, parsed.
+struct DumpRecord {
+    enum class Kind { Work, Author, Other, Malformed };
+    Kind kind = Kind::Other;
+    std::string key;          // "OL45804W" / "OL34184A", prefix stripped
+    std::string title;        // Works
+    std::string authorName;   // Works with inline author names (search-style JSONL); authors' own name
+    std::string authorKey;    // Works: first author's key, resolved to a name by finish()
+    std::string publishYear;  // Works: first four-digit year of first_publish_year/_date
+    int64_t coverId = 0;      // Works: first cover
+    std::vector<std::string> subjects; // Works: first CatalogDB::kMaxSubjects
+};
+
+// Bulk-loads Open Library data dumps into a CatalogDB file.
+//
+// Takes the published dumps as they come: tab-separated
+// (type, key, revision, last_modified, JSON), or one JSON object per line,
+// optionally gzipped. Works and authors are kept; other record types are
+// skipped. Works and authors dumps can be ingested in either order.
+//
+// The calling thread reads and decompresses, `parserThreads` threads parse
+// JSON, and one writer thread inserts through prepared statements, committing
+// every `rowsPerTransaction` rows with journaling and fsync off. Indexes, the
+// full-text index, de-duplication (the last copy of a key wins) and author
+// names are all done once, by finish(), instead of row by row.
+//
+// While loading the file is not crash-safe: if the process dies, delete it and
+// start over. Close any CatalogDB on the file first; loading needs it to itself.
+class DumpIngester {
+public:
+    explicit DumpIngester(const std::string& catalogPath, const IngestOptions& options = {});
+    ~DumpIngester(); // Calls finish() if there is unfinished work
+
+    DumpIngester(const DumpIngester&) = delete;
+    DumpIngester& operator=(const DumpIngester&) = delete;
+
+    // Streams one dump into the catalog. May be called several times before finish().
+    IngestStats ingest(std::istream& in);
+
+    // Same for a file; ".gz" files (and plain ones) are read through zlib.
+    IngestStats ingestFile(const std::string& path);
+
+    // De-duplicates, builds the indexes, resolves author names and rebuilds the
+    // search index, then switches the file back to WAL. Returns false on error.
+    bool finish();
+
+    bool ok() const { return db_ != nullptr; }
+
+    static DumpRecord parseLine(std::string_view line);
+
+private:
+    using ReadFn = std::function<long(char* buffer, size_t capacity)>; // Bytes read, 0 at end, < 0 on error
+
+    std::string path_;
+    IngestOptions options_;
+    sqlite3* db_ = nullptr;
+    sqlite3_stmt* insertWorkStmt_ = nullptr;
+    sqlite3_stmt* insertAuthorStmt_ = nullptr;
+    bool dirty_ = false; // Rows written since the last finish()
+
+    IngestStats run(const ReadFn& read);
+    bool exec(const char* sql, std::string& error);
+    bool maxRowid(const char* table, int64_t& rowid, std::string& error);
+    bool insert(const DumpRecord& record, int64_t rowid, IngestStats& stats);
+};
+
+#endif // DUMP_INGESTER_H
@@ -1,66 +1,226 @@
 #include "LoanService.h"
-#include <iostream>   // <--- ADDED: For std::cout and std::cerr
-#include <ctime>      // For std::time, std::localtime, std::mktime, std::strftime
-#include <algorithm>  // For std::transform, std::tolower if needed in StringUtils (already there)
-#include <cpr/cpr.h>  // If OnlineBookService is in same compilation unit, though typically it's already linked
+#include "ThreadPool.h"
+#include "CatalogSnapshot.h"
+#include "FuzzyTitleIndex.h"
+#include "DateUtils.h"
+#include "Metrics.h"
+#include "Logger.h"
+#include <iostream>   // For the user-facing borrow messages
+#include <algorithm>  // For std::min
 
-using util::trim;
-using util::toLower; // Assuming toLower is in util namespace
 
 // Constructor: Initializes members with provided references and database path.
-LoanService::LoanService(OnlineBookService& onlineSvc, const std::string& loanDbPath)
- : onlineBookService_(onlineSvc), loanRequestDB_(loanDbPath)
+LoanService::LoanService(OnlineBookService& onlineSvc, const std::string& loanDbPath,
+                         const CatalogCacheOptions& catalogCacheOptions, const SnapshotWatcher* snapshot)
+ : onlineBookService_(onlineSvc), loanRequestDB_(std::make_shared<LoanRequestDB>(loanDbPath)),
+   catalogCache_(catalogCacheOptions), snapshot_(snapshot)
 {}
 
+LoanService::LoanService(OnlineBookService& onlineSvc, std::shared_ptr<LoanRequestDB> loanDb,
+                         const CatalogCacheOptions& catalogCacheOptions, const SnapshotWatcher* snapshot)
+ : onlineBookService_(onlineSvc), loanRequestDB_(std::move(loanDb)), catalogCache_(catalogCacheOptions),
+   snapshot_(snapshot)
+{}
+
+// Finds the book to lend for a typed title.
+std::optional<LoanService::CatalogMatch> LoanService::findInCatalog(const std::string& title,
+                                                                    const CancellationToken& token) const {
+    // A snapshot hit, or a fuzzy match that differs only in case and
+    // punctuation, is definitive and names the catalog's title.
+    std::optional<std::string> typoFix; // Unambiguous near match, lent only if the typed title is unknown
+    if (snapshot_) {
+        auto snapshot = snapshot_->current();
+        if (snapshot) {
+            if (auto book = snapshot->find(title)) {
+                return CatalogMatch{true, std::string(book->title)};
+            }
+        }
+        auto fuzzy = snapshot_->fuzzyIndex();
+        FuzzyMatchOptions options;
+        options.limit = 2; // The runner-up tells a typo from a guess between neighbours
+        if (fuzzy) {
+            auto matches = fuzzy->match(title, options);
+            if (!matches.empty() && matches[0].distance == 0) {
+                return CatalogMatch{true, fuzzy->title(matches[0].id)};
+            }
+            if (matches.size() == 1 || (matches.size() == 2 && matches[0].distance < matches[1].distance)) {
+                typoFix = fuzzy->title(matches[0].id);
+            }
+        }
+    }
+
+    // A snapshot miss is not definitive (the online search also matches
+    // partial and newer titles), so the typed title is checked first: "Emma"
+    // must not become the snapshot's "Gemma" when Open Library has "Emma".
+    // Ties ("Harry Potter 2" between 1 and 3) are never guessed; they only
+    // come back as suggestions.
+    const auto exists = existsInOnlineCatalog(title, token);
+    if (exists && *exists) {
+        return CatalogMatch{true, title};
+    }
+    if (typoFix) {
+        return CatalogMatch{true, *typoFix};
+    }
+    if (!exists) {
+        return std::nullopt;
+    }
+    return CatalogMatch{false, title};
+}
+
 // Checks if a book exists in the online catalog using OnlineBookService.
-bool LoanService::existsInOnlineCatalog(const std::string& title) const {
+std::optional<bool> LoanService::existsInOnlineCatalog(const std::string& title, const CancellationToken& token) const {
+    switch (catalogCache_.lookup(title)) {
+        case CatalogExistenceCache::Status::Found:   return true;
+        case CatalogExistenceCache::Status::Missing: return false;
+        case CatalogExistenceCache::Status::Unknown: break;
+    }
+
     // Use the online book service to search for the book.
     // We only need to check if *any* result comes back.
     // Limit to 1 result for efficiency if we only need to know existence.
-    auto results = onlineBookService_.search(title, 1); 
-    return !results.empty();
+    auto results = onlineBookService_.trySearch(title, 1, 0, token);
+    if (!results) {
+        return std::nullopt; // Request failed: not remembered, so the next attempt asks again
+    }
+    if (results->empty()) {
+        catalogCache_.recordMissing(title);
+        return false;
+    }
+    catalogCache_.recordFound(title);
+    return true;
 }
 
-LoanResult LoanService::calculateDates() const {
-    time_t now = std::time(nullptr);
-    tm borrow = *std::localtime(&now);
-    
-    // Set borrow date to tomorrow
-    borrow.tm_mday += 1;
-    std::mktime(&borrow); // Normalize the date
-
-    tm due = borrow;
-    due.tm_mday += 21; // Add 21 days for the due date
-    std::mktime(&due); // Normalize the date
+std::vector<TitleSuggestion> LoanService::suggestTitles(const std::string& title, size_t limit) const {
+    std::vector<TitleSuggestion> suggestions;
+    auto fuzzy = snapshot_ ? snapshot_->fuzzyIndex() : nullptr;
+    if (!fuzzy) {
+        return suggestions;
+    }
+    // Looser than the borrow check: these are shown, not acted on.
+    FuzzyMatchOptions options;
+    options.limit = limit;
+    options.maxEdits = 4;
+    options.minScore = 0.5;
+    for (const auto& m : fuzzy->match(title, options)) {
+        suggestions.push_back({fuzzy->title(m.id), m.score});
+    }
+    return suggestions;
+}
 
-    char buf1[11], buf2[11]; // Buffer for YYYY-MM-DD (10 chars + null terminator)
-    std::strftime(buf1, sizeof(buf1), "%Y-%m-%d", &borrow);
-    std::strftime(buf2, sizeof(buf2), "%Y-%m-%d", &due);
+LoanRecord LoanService::calculateDates(const std::string& title) const {
+    LoanRecord record;
+    record.bookTitle = title;
+    record.borrowDay = util::todayEpochDay() + 1;        // Set borrow date to tomorrow
+    record.dueDay = record.borrowDay + kLoanPeriodDays;  // Add 21 days for the due date
+    return record;
+}
 
-    return {buf1, buf2};
+LoanResult LoanService::toResult(const LoanRecord& record) {
+    return {util::formatEpochDay(record.borrowDay), util::formatEpochDay(record.dueDay)};
 }
 
 // Saves the loan request to the SQLite database.
-void LoanService::saveRequest(const std::string& title, const LoanResult& lr) const {
-    LoanRecord record;
-    record.bookTitle = title;
-    record.borrowDate = lr.borrowDate;
-    record.dueDate = lr.dueDate;
+void LoanService::saveRequest(const LoanRecord& record) const {
+    const std::string& title = record.bookTitle;
 
-    // Call insertLoan on the mutable loanRequestDB_ member
-    if (!loanRequestDB_.insertLoan(record)) {
-        std::cerr << "Error: Failed to save loan request for '" << title << "' to database.\n";
+    if (!loanRequestDB_->insertLoan(record)) {
+        LOG_ERROR("LoanService", "Failed to save loan request", title);
     }
 }
 
 // Attempts to borrow a book.
 std::optional<LoanResult> LoanService::borrowBook(const std::string& title) {
-    if (!existsInOnlineCatalog(title)) {
+    return borrowBook(title, CancellationToken());
+}
+
+std::optional<LoanResult> LoanService::borrowBook(const std::string& title, const CancellationToken& token) {
+    ScopedTimer timer(Stage::BorrowBook);
+    const auto match = findInCatalog(title, token);
+    if (!match) {
+        std::cout << "The online catalog could not be reached; '" << title << "' was not borrowed. Please try again later.\n";
+        return std::nullopt;
+    }
+    if (!match->found) {
         std::cout << "Book '" << title << "' not found in online catalog.\n";
+        for (const auto& suggestion : suggestTitles(title)) {
+            std::cout << "  Did you mean '" << suggestion.title << "'?\n";
+        }
         return std::nullopt; // Book not found
     }
 
-    auto lr = calculateDates(); // Calculate borrow and due dates
-    saveRequest(title, lr);     // Save the loan request to the database
-    return lr;                  // Return the loan result
+    if (match->title != title) {
+        std::cout << "Borrowing '" << match->title << "' (matched from '" << title << "').\n";
+    }
+
+    token.throwIfCancelled();                   // Last point at which the caller can back out
+    auto record = calculateDates(match->title); // Calculate borrow and due dates
+    saveRequest(record);                 // Save the loan request to the database
+    return toResult(record);             // Return the loan result
+}
+
+std::future<std::optional<LoanResult>> LoanService::borrowBookAsync(std::string title, CancellationToken token) {
+    return ThreadPool::shared().submit([this, title = std::move(title), token = std::move(token)]() {
+        return borrowBook(title, token);
+    });
+}
+
+// Attempts to borrow several books in one go.
+std::vector<std::optional<LoanResult>> LoanService::borrowBooks(const std::vector<std::string>& titles) {
+    std::vector<std::optional<LoanResult>> results(titles.size());
+    if (titles.empty()) {
+        return results;
+    }
+
+    // Check the catalog for every title concurrently. The pool size caps how many
+    // requests are in flight at once, so a large batch does not flood Open Library.
+    std::vector<std::optional<CatalogMatch>> found(titles.size());
+    const CancellationToken never; // Batch borrows run to completion
+    {
+        ThreadPool pool(std::min(titles.size(), kMaxConcurrentChecks));
+        std::vector<std::future<std::optional<CatalogMatch>>> checks;
+        checks.reserve(titles.size());
+        for (const auto& title : titles) {
+            checks.push_back(pool.submit([this, &title, &never]() { return findInCatalog(title, never); }));
+        }
+        for (size_t i = 0; i < checks.size(); ++i) {
+            found[i] = checks[i].get();
+        }
+    }
+
+    // Every loan in the batch shares the same dates.
+    const LoanRecord dates = calculateDates("");
+    const LoanResult lr = toResult(dates);
+    std::vector<LoanRecord> records;
+    for (size_t i = 0; i < titles.size(); ++i) {
+        if (!found[i]) {
+            std::cout << "The online catalog could not be reached; '" << titles[i] << "' was not borrowed.\n";
+            continue;
+        }
+        if (!found[i]->found) {
+            std::cout << "Book '" << titles[i] << "' not found in online catalog.\n";
+            continue;
+        }
+        if (found[i]->title != titles[i]) {
+            std::cout << "Borrowing '" << found[i]->title << "' (matched from '" << titles[i] << "').\n";
+        }
+        LoanRecord record = dates;
+        record.bookTitle = found[i]->title;
+        records.push_back(std::move(record));
+    }
+
+    // One transaction for the whole batch; on failure nothing is borrowed.
+    if (!loanRequestDB_->insertLoans(records)) {
+        LOG_ERROR("LoanService", "Failed to save batch of loan requests", static_cast<int64_t>(records.size()));
+        return results;
+    }
+    for (size_t i = 0; i < titles.size(); ++i) {
+        if (found[i] && found[i]->found) {
+            results[i] = lr;
+        }
+    }
+    return results;
+}
+
+LoanPage LoanService::overdueLoans(size_t limit, const std::optional<LoanCursor>& after) {
+    return loanRequestDB_->getOverdueLoans(util::todayEpochDay(), limit, after);
 }
@@ -1,13 +1,25 @@
 #ifndef LOAN_SERVICE_H
 #define LOAN_SERVICE_H
 
+#include <future>
+#include <memory>
 #include <string>
 #include <optional>
 #include <vector> // For std::vector<OnlineBook>
 #include "StringUtils.h"
 #include "OnlineBookService.h" // To check online catalog
 #include "LoanRequestDB.h"             // For saving loan requests
+#include "CatalogExistenceCache.h"     // Remembers catalog checks between borrows
 
+class SnapshotWatcher; // Optional mapped catalog snapshot (see Database/CatalogSnapshot.h)
+
+// A catalog title close to what was typed, from LoanService::suggestTitles.
+struct TitleSuggestion {
+    std::string title;
+    double score; // 1.0 = same title up to case and punctuation
+};
+
+// Loan dates formatted as YYYY-MM-DD for display.
 struct LoanResult {
     std::string borrowDate;
     std::string dueDate;
@@ -16,22 +28,80 @@ struct LoanResult {
 class LoanService {
 public:
     // Constructor now takes an OnlineBookService instance by reference
-    // and the path for the loan request database.
-    LoanService(OnlineBookService& onlineSvc, const std::string& loanDbPath);
+    // and the path for the loan request database. Titles found in `snapshot`
+    // (not owned; may be null) are borrowable without asking the online
+    // catalog. With a fuzzy index, a title the catalog does not know is lent
+    // as its one clearly closest snapshot title, if there is one.
+    LoanService(OnlineBookService& onlineSvc, const std::string& loanDbPath,
+                const CatalogCacheOptions& catalogCacheOptions = {}, const SnapshotWatcher* snapshot = nullptr);
+
+    // Uses an already-open (typically pooled and shared) loan request database.
+    LoanService(OnlineBookService& onlineSvc, std::shared_ptr<LoanRequestDB> loanDb,
+                const CatalogCacheOptions& catalogCacheOptions = {}, const SnapshotWatcher* snapshot = nullptr);
 
-    // Try to borrow a book title; returns empty optional on failure
+    // Try to borrow a book title; returns empty optional on failure.
+    // A title matched in the snapshot is lent under the snapshot's spelling,
+    // so a corrected typo is recorded as the book it was matched to.
     std::optional<LoanResult> borrowBook(const std::string& title);
 
+    // Same, but stops once `token` is cancelled or past its deadline by
+    // throwing OperationCancelled. Nothing is saved after that point.
+    std::optional<LoanResult> borrowBook(const std::string& title, const CancellationToken& token);
+
+    // Runs borrowBook() on ThreadPool::shared() and returns at once. The future
+    // throws OperationCancelled if `token` stops the call. The service must
+    // outlive the future.
+    std::future<std::optional<LoanResult>> borrowBookAsync(std::string title, CancellationToken token = {});
+
+    // Borrow several titles at once. Catalog checks run concurrently (at most
+    // kMaxConcurrentChecks in flight) and all found titles are saved in one
+    // database transaction. Results are returned in the same order as `titles`;
+    // an entry is empty if that title was not found or could not be saved.
+    std::vector<std::optional<LoanResult>> borrowBooks(const std::vector<std::string>& titles);
+
+    // Upper bound on simultaneous catalog requests issued by borrowBooks.
+    static constexpr size_t kMaxConcurrentChecks = 4;
+
+    // Days between the borrow date and the due date.
+    static constexpr int kLoanPeriodDays = 21;
+
+    // Loans not returned by today, oldest due date first, a page at a time.
+    // Pass the previous page's `next` cursor to continue.
+    LoanPage overdueLoans(size_t limit, const std::optional<LoanCursor>& after = std::nullopt);
+
+    // Snapshot titles resembling `title`, best first. Empty without a snapshot fuzzy index.
+    std::vector<TitleSuggestion> suggestTitles(const std::string& title, size_t limit = 3) const;
+
+    // Hit/miss counters of the catalog existence cache.
+    CatalogCacheStats catalogCacheStats() const { return catalogCache_.stats(); }
+
 private:
     OnlineBookService& onlineBookService_; // Reference to the online book service
-    // Make loanRequestDB_ mutable so we can call non-const methods from const LoanService methods
-    mutable LoanRequestDB loanRequestDB_;  // <--- ADDED 'mutable' keyword
+    // Shared with other services via DatabasePool; the DB serializes access itself.
+    std::shared_ptr<LoanRequestDB> loanRequestDB_;
+    // Catalog answers per title, so repeat (or repeatedly mistyped) titles skip the network.
+    mutable CatalogExistenceCache catalogCache_;
+    const SnapshotWatcher* snapshot_;
+
+    // Outcome of a catalog check for a typed title.
+    struct CatalogMatch {
+        bool found = false;
+        std::string title; // The title to lend: as the snapshot spells it, else as typed
+    };
 
+    // Snapshot first, then the cache and Open Library. A near match in the
+    // snapshot is lent only when it is unambiguous and the typed title itself
+    // is not found. Empty optional if the catalog could not be reached and
+    // the snapshot had no answer.
+    std::optional<CatalogMatch> findInCatalog(const std::string& title, const CancellationToken& token) const;
     // Now checks online availability instead of a local file
-    bool existsInOnlineCatalog(const std::string& title) const;
-    LoanResult calculateDates() const;
+    // Empty optional if the catalog could not be reached.
+    std::optional<bool> existsInOnlineCatalog(const std::string& title, const CancellationToken& token) const;
+    // A loan of `title` starting tomorrow, due kLoanPeriodDays later.
+    LoanRecord calculateDates(const std::string& title) const;
+    static LoanResult toResult(const LoanRecord& record);
     // Saves to SQLite DB instead of a file
-    void saveRequest(const std::string& title, const LoanResult& lr) const;
+    void saveRequest(const LoanRecord& record) const;
 };
 
 #endif // LOAN_SERVICE_H
@@ -0,0 +1,212 @@
+#include "Logger.h"
+#include "DateUtils.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// How long the writer sleeps when the queue is empty. Warnings and errors wake it at once.
+static constexpr std::chrono::milliseconds kIdleWait(10);
+
+const char* logLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "debug";
+        case LogLevel::Info:  return "info";
+        case LogLevel::Warn:  return "warn";
+        case LogLevel::Error: return "error";
+        case LogLevel::Off:   break;
+    }
+    return "off";
+}
+
+// "YYYY-MM-DDTHH:MM:SS.mmmZ" for milliseconds since the epoch.
+static std::string formatTimestamp(int64_t ms) {
+    constexpr int64_t kMsPerDay = 86400000;
+    int64_t day = ms / kMsPerDay, rem = ms % kMsPerDay;
+    if (rem < 0) {
+        rem += kMsPerDay;
+        --day;
+    }
+    char time[20];
+    std::snprintf(time, sizeof(time), "T%02d:%02d:%02d.%03dZ", static_cast<int>(rem / 3600000),
+                  static_cast<int>(rem / 60000 % 60), static_cast<int>(rem / 1000 % 60), static_cast<int>(rem % 1000));
+    return util::formatEpochDay(static_cast<util::EpochDay>(day)) + time;
+}
+
+// Writes `text` as a logfmt value: bare if it is a simple word, quoted and escaped otherwise.
+static void writeValue(std::ostream& out, std::string_view text) {
+    const bool plain = !text.empty() && std::all_of(text.begin(), text.end(), [](char c) {
+        return c > ' ' && c != '"' && c != '=' && c != '\\' && c != 0x7f;
+    });
+    if (plain) {
+        out << text;
+        return;
+    }
+    out << '"';
+    for (char c : text) {
+        switch (c) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:   out << c;
+        }
+    }
+    out << '"';
+}
+
+Logger::Logger(std::ostream& sink, size_t capacity)
+    : sink_(sink), ring_(capacity)
+{
+    writer_ = std::thread([this]() { run(); });
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    writer_.join();
+}
+
+bool Logger::enqueue(LogLevel level, const char* component, const char* message,
+                     std::string_view detail, const int64_t* value) {
+    if (!enabled(level)) return false;
+    const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    const bool pushed = ring_.tryPush([&](Record& r) {
+        r.level = level;
+        r.timeMs = now;
+        r.component = component;
+        r.message = message;
+        r.hasValue = value != nullptr;
+        r.value = value ? *value : 0;
+        r.detailLen = static_cast<uint16_t>(std::min(detail.size(), kDetailBytes));
+        r.truncated = detail.size() > kDetailBytes;
+        std::memcpy(r.detail, detail.data(), r.detailLen);
+    });
+    if (!pushed) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    queued_.fetch_add(1, std::memory_order_release);
+    if (level >= LogLevel::Warn) {
+        wake_.notify_one(); // Get problems out promptly, e.g. before a crash
+    }
+    return true;
+}
+
+void Logger::log(LogLevel level, const char* component, const char* message, std::string_view detail) {
+    enqueue(level, component, message, detail, nullptr);
+}
+
+void Logger::log(LogLevel level, const char* component, const char* message, int64_t value) {
+    enqueue(level, component, message, {}, &value);
+}
+
+void Logger::flush() {
+    const uint64_t target = queued_.load(std::memory_order_acquire);
+    wake_.notify_one();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (written_.load(std::memory_order_acquire) < target) {
+        drained_.wait_for(lock, kIdleWait); // Timed: the writer notifies without holding the lock
+    }
+}
+
+LoggerStats Logger::stats() const {
+    LoggerStats s;
+    s.written = written_.load();
+    s.dropped = dropped_.load();
+    return s;
+}
+
+void Logger::run() {
+    Record record;
+    for (;;) {
+        bool wroteAny = false;
+        while (ring_.tryPop(record)) {
+            write(record);
+            written_.fetch_add(1, std::memory_order_release);
+            wroteAny = true;
+        }
+        const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped != droppedReported_) {
+            writeDropped(dropped - droppedReported_);
+            droppedReported_ = dropped;
+            wroteAny = true;
+        }
+        if (wroteAny) {
+            sink_.flush(); // Once per batch, not per line
+            drained_.notify_all();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stopping_) {
+            lock.unlock();
+            if (!wroteAny) break; // Drained after stop was requested: done
+            continue;
+        }
+        wake_.wait_for(lock, kIdleWait);
+    }
+}
+
+void Logger::write(const Record& record) {
+    sink_ << "ts=" << formatTimestamp(record.timeMs) << " level=" << logLevelName(record.level)
+          << " component=";
+    writeValue(sink_, record.component);
+    sink_ << " msg=";
+    writeValue(sink_, record.message);
+    if (record.detailLen > 0 || record.truncated) {
+        sink_ << " detail=";
+        writeValue(sink_, std::string_view(record.detail, record.detailLen));
+        if (record.truncated) sink_ << " truncated=true";
+    }
+    if (record.hasValue) {
+        sink_ << " value=" << record.value;
+    }
+    sink_ << '\n';
+}
+
+void Logger::writeDropped(uint64_t dropped) {
+    sink_ << "ts=" << formatTimestamp(std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::system_clock::now().time_since_epoch()).count())
+          << " level=warn component=Logger msg=\"Log records dropped, queue full\" value=" << dropped << '\n';
+}
+
+// Set once the global logger is gone, so late callers (static destructors) still get their output.
+static std::atomic<bool> globalLoggerGone{false};
+
+namespace {
+struct GlobalLogger {
+    Logger logger{std::cerr};
+    ~GlobalLogger() { globalLoggerGone.store(true); }
+};
+} // namespace
+
+Logger& Logger::global() {
+    static GlobalLogger instance;
+    return instance.logger;
+}
+
+namespace logging {
+
+void log(LogLevel level, const char* component, const char* message, std::string_view detail) {
+    if (globalLoggerGone.load(std::memory_order_relaxed)) {
+        std::cerr << logLevelName(level) << ' ' << component << ": " << message
+                  << (detail.empty() ? "" : ": ") << detail << '\n';
+        return;
+    }
+    Logger::global().log(level, component, message, detail);
+}
+
+void log(LogLevel level, const char* component, const char* message, int64_t value) {
+    if (globalLoggerGone.load(std::memory_order_relaxed)) {
+        std::cerr << logLevelName(level) << ' ' << component << ": " << message << ": " << value << '\n';
+        return;
+    }
+    Logger::global().log(level, component, message, value);
+}
+
+} // namespace logging
@@ -0,0 +1,121 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <thread>
+#include "RingBuffer.h"
+
+enum class LogLevel : int { Debug = 0, Info = 1, Warn = 2, Error = 3, Off = 4 };
+
+// Lowest level compiled in; set with -DLIBRARY_LOG_LEVEL=DEBUG|INFO|WARN|ERROR|OFF
+// at configure time. Calls below it vanish from the binary, arguments and all.
+#ifndef LIBRARY_LOG_MIN_LEVEL
+#define LIBRARY_LOG_MIN_LEVEL 1
+#endif
+constexpr LogLevel kMinLogLevel = static_cast<LogLevel>(LIBRARY_LOG_MIN_LEVEL);
+
+const char* logLevelName(LogLevel level);
+
+struct LoggerStats {
+    uint64_t written = 0; // Lines handed to the sink
+    uint64_t dropped = 0; // Records lost because the queue was full
+};
+
+// Asynchronous structured logger. log() copies the record into a lock-free
+// ring buffer and returns: no formatting, allocation, locking or flushing on
+// the caller's thread. A background thread formats each record as one logfmt
+// line and flushes the sink once per batch:
+//
+//   ts=2025-05-01T09:30:00.123Z level=info component=ReadListDB msg="Book added to read list" detail="Dune"
+//
+// `component` and `message` must be string literals (only the pointers are
+// queued). `detail` is copied, cut at kDetailBytes. If the queue is full the
+// record is dropped and counted rather than making the caller wait.
+class Logger {
+public:
+    static constexpr size_t kDetailBytes = 160;
+
+    explicit Logger(std::ostream& sink, size_t capacity = 2048);
+    ~Logger(); // Writes out everything queued, then stops the writer
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    void log(LogLevel level, const char* component, const char* message, std::string_view detail = {});
+    void log(LogLevel level, const char* component, const char* message, int64_t value);
+
+    // Runtime threshold, on top of the compile-time one.
+    void setLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+    bool enabled(LogLevel level) const { return level >= level_.load(std::memory_order_relaxed); }
+
+    // Blocks until every record queued before the call has reached the sink.
+    void flush();
+
+    LoggerStats stats() const;
+
+    // The process-wide logger, writing to std::cerr.
+    static Logger& global();
+
+private:
+    struct Record {
+        LogLevel level = LogLevel::Info;
+        int64_t timeMs = 0; // Wall clock, ms since the epoch
+        const char* component = "";
+        const char* message = "";
+        bool hasValue = false;
+        int64_t value = 0;
+        uint16_t detailLen = 0;
+        bool truncated = false;
+        char detail[kDetailBytes];
+    };
+
+    bool enqueue(LogLevel level, const char* component, const char* message,
+                 std::string_view detail, const int64_t* value);
+    void run();
+    void write(const Record& record);
+    void writeDropped(uint64_t dropped);
+
+    std::ostream& sink_;
+    RingBuffer<Record> ring_;
+    std::atomic<LogLevel> level_{kMinLogLevel};
+    std::atomic<uint64_t> queued_{0};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    uint64_t droppedReported_ = 0; // Writer thread only
+
+    std::mutex mutex_;                 // Only for sleeping/waking; never taken by log()
+    std::condition_variable wake_;     // Writer: records may be waiting
+    std::condition_variable drained_;  // flush(): the writer caught up
+    bool stopping_ = false;
+    std::thread writer_;
+};
+
+namespace logging {
+
+// Log to the global logger. After it has been destroyed (static teardown),
+// records are written to std::cerr synchronously instead.
+void log(LogLevel level, const char* component, const char* message, std::string_view detail = {});
+void log(LogLevel level, const char* component, const char* message, int64_t value);
+
+} // namespace logging
+
+// Leveled logging macros. Usage: LOG_INFO("ReadListDB", "Book added to read list", book.title);
+#define LIBRARY_LOG_AT(level, ...)                                  \
+    do {                                                            \
+        if constexpr ((level) >= kMinLogLevel) {                    \
+            ::logging::log((level), __VA_ARGS__);                   \
+        }                                                           \
+    } while (0)
+
+#define LOG_DEBUG(...) LIBRARY_LOG_AT(LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...)  LIBRARY_LOG_AT(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARN(...)  LIBRARY_LOG_AT(LogLevel::Warn, __VA_ARGS__)
+#define LOG_ERROR(...) LIBRARY_LOG_AT(LogLevel::Error, __VA_ARGS__)
+
+#endif // LOGGER_H
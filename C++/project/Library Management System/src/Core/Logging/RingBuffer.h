@@ -0,0 +1,91 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded lock-free queue for many producers and consumers (Dmitry Vyukov's
+// array queue). Each slot carries a sequence number saying whose turn it is,
+// so a push or pop is one CAS on a shared position plus work on its own slot.
+// A full queue refuses a push rather than blocking the producer.
+template <class T>
+class RingBuffer {
+public:
+    // Capacity is rounded up to a power of two.
+    explicit RingBuffer(size_t capacity)
+        : mask_(roundUp(capacity) - 1), slots_(new Slot[mask_ + 1])
+    {
+        for (size_t i = 0; i <= mask_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    // Claims a slot and lets `fill(T&)` write the value in place. False if full.
+    template <class Fill>
+    bool tryPush(Fill&& fill) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            const size_t seq = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    fill(slot.value);
+                    slot.sequence.store(pos + 1, std::memory_order_release); // Publish to consumers
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // The slot still holds a value from one lap ago: full
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Moves the oldest value into `out`. False if empty.
+    bool tryPop(T& out) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            const size_t seq = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(slot.value);
+                    slot.sequence.store(pos + mask_ + 1, std::memory_order_release); // Free for the next lap
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    static size_t roundUp(size_t n) {
+        size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<size_t> head_{0}; // Next push position; own cache line so
+    alignas(64) std::atomic<size_t> tail_{0}; // producers and the consumer don't collide
+};
+
+#endif // RING_BUFFER_H
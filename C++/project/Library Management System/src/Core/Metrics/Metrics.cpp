@@ -0,0 +1,170 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>   // For std::rename / std::remove
+#include <fstream>
+
+const char* stageName(Stage stage) {
+    switch (stage) {
+        case Stage::Http:       return "http";
+        case Stage::JsonParse:  return "json_parse";
+        case Stage::DbPrepare:  return "db_prepare";
+        case Stage::DbStep:     return "db_step";
+        case Stage::Search:     return "search";
+        case Stage::Recommend:  return "recommend";
+        case Stage::BorrowBook: return "borrow_book";
+        case Stage::Count:      break;
+    }
+    return "unknown";
+}
+
+// Index of the highest set bit; v must be non-zero.
+static int highestBit(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(v);
+#else
+    int bit = 0;
+    while (v >>= 1) ++bit;
+    return bit;
+#endif
+}
+
+size_t LatencyHistogram::bucketOf(uint64_t ns) {
+    if (ns < 4) return static_cast<size_t>(ns); // 0..3 ns get a bucket each
+    const int e = highestBit(ns);
+    const size_t bucket = static_cast<size_t>(e - 1) * 4 + ((ns >> (e - 2)) & 3);
+    return std::min(bucket, kBuckets - 1);
+}
+
+uint64_t LatencyHistogram::bucketLowerNs(size_t bucket) {
+    if (bucket < 4) return bucket;
+    const size_t e = bucket / 4 + 1;
+    return (4 + bucket % 4) << (e - 2);
+}
+
+uint64_t LatencyHistogram::bucketUpperNs(size_t bucket) {
+    if (bucket < 4) return bucket + 1;
+    const size_t e = bucket / 4 + 1;
+    return (5 + bucket % 4) << (e - 2);
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds elapsed) {
+    const uint64_t ns = elapsed.count() > 0 ? static_cast<uint64_t>(elapsed.count()) : 0;
+    buckets_[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sumNs_.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t seen = maxNs_.load(std::memory_order_relaxed);
+    while (ns > seen && !maxNs_.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+    }
+}
+
+LatencySnapshot LatencyHistogram::snapshot() const {
+    LatencySnapshot s;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        s.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        s.count += s.buckets[i]; // Consistent with the buckets, unlike count_ mid-record
+    }
+    s.sumNs = sumNs_.load(std::memory_order_relaxed);
+    s.maxNs = maxNs_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    sumNs_.store(0, std::memory_order_relaxed);
+    maxNs_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencySnapshot::quantileNs(double q) const {
+    if (count == 0) return 0;
+    const double clamped = std::min(1.0, std::max(0.0, q));
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped * count)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            // Middle of the bucket, but never past the largest value recorded.
+            const uint64_t mid = (LatencyHistogram::bucketLowerNs(i) + LatencyHistogram::bucketUpperNs(i)) / 2;
+            return std::min(mid, maxNs);
+        }
+    }
+    return maxNs;
+}
+
+namespace metrics {
+
+static std::array<LatencyHistogram, kStageCount>& registry() {
+    static std::array<LatencyHistogram, kStageCount> histograms;
+    return histograms;
+}
+
+LatencyHistogram& histogram(Stage stage) {
+    return registry()[static_cast<size_t>(stage)];
+}
+
+LatencySnapshot snapshot(Stage stage) {
+    return histogram(stage).snapshot();
+}
+
+void resetAll() {
+    for (auto& h : registry()) h.reset();
+}
+
+void writePrometheus(std::ostream& out) {
+    // Export buckets end on powers of two (in ns), which are also histogram
+    // bucket boundaries, so the cumulative counts are exact.
+    constexpr int kFirstExponent = 10; // 1.024 µs
+    constexpr int kLastExponent = 36;  // ~68.7 s
+
+    const std::streamsize savedPrecision = out.precision(10);
+    std::array<LatencySnapshot, kStageCount> snapshots;
+    for (size_t i = 0; i < kStageCount; ++i) {
+        snapshots[i] = snapshot(static_cast<Stage>(i));
+    }
+
+    out << "# HELP library_stage_latency_seconds Latency of each request stage.\n"
+        << "# TYPE library_stage_latency_seconds histogram\n";
+    for (size_t i = 0; i < kStageCount; ++i) {
+        const LatencySnapshot& s = snapshots[i];
+        const std::string label = std::string("stage=\"") + stageName(static_cast<Stage>(i)) + "\"";
+        uint64_t cumulative = 0;
+        size_t bucket = 0;
+        for (int e = kFirstExponent; e <= kLastExponent; ++e) {
+            const size_t end = LatencyHistogram::bucketOf(uint64_t{1} << e); // First bucket at or above 2^e
+            for (; bucket < end; ++bucket) cumulative += s.buckets[bucket];
+            out << "library_stage_latency_seconds_bucket{" << label << ",le=\""
+                << std::ldexp(1e-9, e) << "\"} " << cumulative << "\n";
+        }
+        out << "library_stage_latency_seconds_bucket{" << label << ",le=\"+Inf\"} " << s.count << "\n"
+            << "library_stage_latency_seconds_sum{" << label << "} " << s.sumNs / 1e9 << "\n"
+            << "library_stage_latency_seconds_count{" << label << "} " << s.count << "\n";
+    }
+
+    out << "# HELP library_stage_latency_quantile_seconds Estimated latency quantiles of each request stage.\n"
+        << "# TYPE library_stage_latency_quantile_seconds gauge\n";
+    for (size_t i = 0; i < kStageCount; ++i) {
+        for (const char* q : {"0.5", "0.9", "0.99"}) {
+            out << "library_stage_latency_quantile_seconds{stage=\"" << stageName(static_cast<Stage>(i))
+                << "\",quantile=\"" << q << "\"} " << snapshots[i].quantileNs(std::stod(q)) / 1e9 << "\n";
+        }
+    }
+    out.precision(savedPrecision);
+}
+
+bool dumpToFile(const std::string& path) {
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::trunc);
+        if (!out) return false;
+        writePrometheus(out);
+        if (!out.flush()) return false;
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace metrics
@@ -0,0 +1,103 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Stages of a request whose latency is tracked.
+enum class Stage {
+    Http,        // One HTTP exchange with Open Library (each retry counts separately)
+    JsonParse,   // Parsing a search.json body into OnlineBook records
+    DbPrepare,   // sqlite3_prepare_v2
+    DbStep,      // sqlite3_step
+    Search,      // OnlineBookService::trySearch, end to end
+    Recommend,   // RecommenderService::recommend, end to end
+    BorrowBook,  // LoanService::borrowBook, end to end
+    Count
+};
+
+constexpr size_t kStageCount = static_cast<size_t>(Stage::Count);
+
+// Name used for the stage label in exports ("http", "json_parse", ...).
+const char* stageName(Stage stage);
+
+// Point-in-time copy of a LatencyHistogram.
+struct LatencySnapshot {
+    static constexpr size_t kBuckets = 160;
+
+    uint64_t count = 0;
+    uint64_t sumNs = 0;
+    uint64_t maxNs = 0;
+    std::array<uint64_t, kBuckets> buckets{};
+
+    // Estimated latency at quantile q (0..1), in nanoseconds; 0 when empty.
+    // Accurate to the bucket width, i.e. within 25%.
+    uint64_t quantileNs(double q) const;
+    double meanNs() const { return count ? static_cast<double>(sumNs) / count : 0.0; }
+};
+
+// Log-linear latency histogram: each power of two is split into four buckets,
+// so a recorded value lands in a bucket at most 25% wide. Covers 1 ns to ~18 min
+// (longer values go in the last bucket).
+//
+// record() is lock-free and wait-free (a few relaxed atomic adds), so it is
+// safe on hot paths and from any thread. A snapshot taken while others record
+// may be off by the in-flight values, never torn beyond that.
+class LatencyHistogram {
+public:
+    static constexpr size_t kBuckets = LatencySnapshot::kBuckets;
+
+    void record(std::chrono::nanoseconds elapsed);
+    LatencySnapshot snapshot() const;
+    void reset();
+
+    static size_t bucketOf(uint64_t ns);
+    static uint64_t bucketLowerNs(size_t bucket);
+    static uint64_t bucketUpperNs(size_t bucket); // Exclusive
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sumNs_{0};
+    std::atomic<uint64_t> maxNs_{0};
+};
+
+// Process-wide histograms, one per Stage.
+namespace metrics {
+
+LatencyHistogram& histogram(Stage stage);
+LatencySnapshot snapshot(Stage stage);
+void resetAll();
+
+// Prometheus text exposition format: a `library_stage_latency_seconds`
+// histogram (power-of-two buckets from ~1 µs to ~69 s) plus p50/p90/p99 gauges,
+// each labelled with the stage.
+void writePrometheus(std::ostream& out);
+
+// Writes the Prometheus text to `path` via a temporary file and rename, so a
+// reader (e.g. node_exporter's textfile collector) never sees half a file.
+bool dumpToFile(const std::string& path);
+
+} // namespace metrics
+
+// Records the time from construction to destruction into a stage's histogram.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Stage stage)
+        : histogram_(metrics::histogram(stage)), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() { histogram_.record(std::chrono::steady_clock::now() - start_); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    LatencyHistogram& histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,60 @@
+#include "MetricsDumper.h"
+#include "Metrics.h"
+#include "Logger.h"
+#include <csignal>
+
+// Set by the signal handler, consumed by the dumper thread.
+static std::atomic<bool> dumpRequested{false};
+
+#ifdef SIGUSR1
+extern "C" void onDumpSignal(int) {
+    dumpRequested.store(true); // Lock-free atomic: safe in a handler
+}
+#endif
+
+// How often the thread looks for a pending signal.
+static constexpr std::chrono::milliseconds kSignalPoll(100);
+
+MetricsDumper::MetricsDumper(std::string path, std::chrono::milliseconds interval)
+    : path_(std::move(path)), interval_(interval)
+{
+#ifdef SIGUSR1
+    std::signal(SIGUSR1, onDumpSignal);
+#endif
+    thread_ = std::thread([this]() { run(); });
+}
+
+MetricsDumper::~MetricsDumper() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+#ifdef SIGUSR1
+    std::signal(SIGUSR1, SIG_DFL);
+#endif
+    dump();
+}
+
+void MetricsDumper::run() {
+    auto nextPeriodic = std::chrono::steady_clock::now() + interval_;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!wake_.wait_for(lock, kSignalPoll, [this]() { return stopping_; })) {
+        const bool periodic = interval_.count() > 0 && std::chrono::steady_clock::now() >= nextPeriodic;
+        if (dumpRequested.exchange(false) || periodic) {
+            lock.unlock();
+            dump();
+            lock.lock();
+            nextPeriodic = std::chrono::steady_clock::now() + interval_;
+        }
+    }
+}
+
+void MetricsDumper::dump() {
+    if (metrics::dumpToFile(path_)) {
+        ++dumps_;
+    } else {
+        LOG_ERROR("MetricsDumper", "Cannot write metrics", path_);
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef METRICS_DUMPER_H
+#define METRICS_DUMPER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Writes the process metrics (metrics::dumpToFile) to a file:
+//  - whenever the process receives SIGUSR1 (`kill -USR1 <pid>`), where supported,
+//  - every `interval`, if one is given,
+//  - and once more on destruction, so a finished run always leaves its numbers.
+//
+// The signal handler only sets a flag; a background thread does the writing,
+// since file I/O is not allowed inside a handler. Only one dumper should be
+// alive at a time: it owns the SIGUSR1 handler while it exists.
+class MetricsDumper {
+public:
+    explicit MetricsDumper(std::string path, std::chrono::milliseconds interval = std::chrono::milliseconds(0));
+    ~MetricsDumper();
+
+    MetricsDumper(const MetricsDumper&) = delete;
+    MetricsDumper& operator=(const MetricsDumper&) = delete;
+
+    // Files written so far.
+    uint64_t dumps() const { return dumps_.load(); }
+
+private:
+    std::string path_;
+    std::chrono::milliseconds interval_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::atomic<uint64_t> dumps_{0};
+    std::thread thread_;
+
+    void run();
+    void dump();
+};
+
+#endif // METRICS_DUMPER_H
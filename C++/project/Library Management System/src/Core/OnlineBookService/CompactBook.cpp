@@ -0,0 +1,84 @@
+#include "CompactBook.h"
+#include <algorithm>
+#include <limits>
+
+uint32_t StringPool::intern(std::string_view s) {
+    auto it = ids_.find(s);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    const auto id = static_cast<uint32_t>(strings_.size());
+    strings_.emplace_back(s);
+    ids_.emplace(strings_.back(), id); // Key views the pooled copy, not the caller's buffer
+    return id;
+}
+
+// Strings longer than a length field can hold are truncated (titles of 64 KiB do not occur).
+static std::string_view clampLength(const std::string& s) {
+    return std::string_view(s).substr(0, std::numeric_limits<uint16_t>::max());
+}
+
+CompactBookList::CompactBookList(const std::vector<OnlineBook>& books, StringPool& pool) {
+    size_t textBytes = 0, subjectCount = 0;
+    for (const auto& b : books) {
+        textBytes += b.title.size() + b.workKey.size();
+        subjectCount += b.subjects.size();
+    }
+    arena_.reserve(textBytes);
+    subjects_.reserve(subjectCount);
+    books_.reserve(books.size());
+
+    for (const auto& b : books) {
+        const auto title = clampLength(b.title);
+        const auto workKey = clampLength(b.workKey);
+        const size_t subjects = std::min<size_t>(b.subjects.size(), std::numeric_limits<uint16_t>::max());
+
+        CompactBook c;
+        c.textOffset = static_cast<uint32_t>(arena_.size());
+        c.titleLength = static_cast<uint16_t>(title.size());
+        c.workKeyLength = static_cast<uint16_t>(workKey.size());
+        c.author = pool.intern(b.author);
+        c.publishYear = pool.intern(b.publishYear);
+        c.subjectsOffset = static_cast<uint32_t>(subjects_.size());
+        c.subjectCount = static_cast<uint16_t>(subjects);
+        c.coverId = b.coverId;
+
+        arena_.append(title);
+        arena_.append(workKey);
+        for (size_t i = 0; i < subjects; ++i) {
+            subjects_.push_back(pool.intern(b.subjects[i]));
+        }
+        books_.push_back(c);
+    }
+}
+
+std::vector<OnlineBook> CompactBookList::expand(const StringPool& pool) const {
+    std::vector<OnlineBook> books;
+    books.reserve(books_.size());
+    for (const auto& c : books_) {
+        OnlineBook b;
+        b.title.assign(arena_, c.textOffset, c.titleLength);
+        b.workKey.assign(arena_, c.textOffset + c.titleLength, c.workKeyLength);
+        b.author = pool.at(c.author);
+        b.publishYear = pool.at(c.publishYear);
+        b.coverId = c.coverId;
+        b.subjects.reserve(c.subjectCount);
+        for (uint32_t i = 0; i < c.subjectCount; ++i) {
+            b.subjects.push_back(pool.at(subjects_[c.subjectsOffset + i]));
+        }
+        books.push_back(std::move(b));
+    }
+    return books;
+}
+
+CompactBookList CompactBookList::rebased(const StringPool& from, StringPool& to) const {
+    CompactBookList copy(*this);
+    for (auto& c : copy.books_) {
+        c.author = to.intern(from.at(c.author));
+        c.publishYear = to.intern(from.at(c.publishYear));
+    }
+    for (auto& id : copy.subjects_) {
+        id = to.intern(from.at(id));
+    }
+    return copy;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "OnlineBookService.h" // For the OnlineBook struct
+
+// Stores each distinct string once and hands out 32-bit ids for it.
+// Authors, subjects and publish years repeat across thousands of books, so a
+// cached book refers to them by id instead of carrying its own copies.
+// Not thread-safe; the owner (e.g. SearchCache) serializes access.
+class StringPool {
+public:
+    StringPool() = default;
+
+    // Ids and internal views point into this pool's storage: movable, not copyable.
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+    StringPool(StringPool&&) = default;
+    StringPool& operator=(StringPool&&) = default;
+
+    // Returns the id of `s`, adding it on first sight.
+    uint32_t intern(std::string_view s);
+
+    // The string behind an id returned by intern().
+    const std::string& at(uint32_t id) const { return strings_[id]; }
+
+    size_t size() const { return strings_.size(); }
+
+private:
+    std::deque<std::string> strings_; // Never moves its elements, so the views below stay valid
+    std::unordered_map<std::string_view, uint32_t> ids_;
+};
+
+// Fixed-size record for one book: 32 bytes and no heap allocations of its own,
+// versus 160 bytes plus one allocation per long string for an OnlineBook.
+struct CompactBook {
+    uint32_t textOffset;     // Title, then work key, in the owning list's arena
+    uint16_t titleLength;
+    uint16_t workKeyLength;
+    uint32_t author;         // StringPool ids
+    uint32_t publishYear;
+    uint32_t subjectsOffset; // Into the owning list's subject id array
+    uint16_t subjectCount;
+    int64_t coverId;         // URLs are rebuilt from this and the work key on expansion
+};
+
+// A result set stored as CompactBooks. Every title and work key lives in one
+// shared character arena, so a page costs three allocations however many books
+// it holds. Strings and ids are resolved against the StringPool it was built with.
+class CompactBookList {
+public:
+    CompactBookList() = default;
+    CompactBookList(const std::vector<OnlineBook>& books, StringPool& pool);
+
+    // Rebuilds the full OnlineBook records.
+    std::vector<OnlineBook> expand(const StringPool& pool) const;
+
+    // Copy of this list whose ids refer to `to` instead of `from`. Used to move
+    // live entries into a fresh pool, dropping strings nothing refers to anymore.
+    CompactBookList rebased(const StringPool& from, StringPool& to) const;
+
+    size_t size() const { return books_.size(); }
+
+private:
+    std::string arena_;
+    std::vector<uint32_t> subjects_;
+    std::vector<CompactBook> books_;
+};
@@ -1,10 +1,12 @@
 #include "OnlineBookService.h"
-#include <cpr/cpr.h>
-#include <nlohmann/json.hpp>
+#include "SearchCache.h"
+#include "CatalogDB.h"
+#include "OpenLibraryParser.h"
+#include "HttpClient.h"
+#include "Metrics.h"
+#include "Logger.h"
+#include "ThreadPool.h"
 #include <algorithm>
-#include <iostream>
-
-using json = nlohmann::json;
 
 // Helper to URL-encode space→'+'
 static std::string encode(const std::string& s) {
@@ -13,60 +15,119 @@ static std::string encode(const std::string& s) {
     return r;
 }
 
-std::vector<OnlineBook> OnlineBookService::search(const std::string& query, size_t limit, size_t offset) const {
-    std::vector<OnlineBook> results;
-    // New: Added offset parameter to the URL for pagination
-    auto url = "https://openlibrary.org/search.json?q=" + encode(query)
-             + "&limit=" + std::to_string(limit)
-             + "&offset=" + std::to_string(offset)
-             + "&fields=key,title,author_name,first_publish_year,cover_i,subject"; // Specify fields for efficiency
+static const std::string kSiteUrl = "https://openlibrary.org";
+static const std::string kWorksPrefix = "/works/";
 
-    auto resp = cpr::Get(cpr::Url{url});
-    if (resp.status_code != 200) {
-        std::cerr << "Error: Failed to fetch data from Open Library (status code: " << resp.status_code << ")\n";
-        return results;
+std::string OnlineBook::coverUrl() const {
+    if (coverId == 0) return "";
+    return "https://covers.openlibrary.org/b/id/" + std::to_string(coverId) + "-M.jpg";
+}
+
+std::string OnlineBook::openLibraryUrl() const {
+    if (workKey.empty()) return "";
+    // Keys that are not works (rare in search results) keep their own path.
+    return workKey[0] == '/' ? kSiteUrl + workKey : kSiteUrl + kWorksPrefix + workKey;
+}
+
+std::string OnlineBook::workKeyFromUrl(const std::string& url) {
+    std::string key = url;
+    if (key.compare(0, kSiteUrl.size(), kSiteUrl) == 0) {
+        key.erase(0, kSiteUrl.size());
+    }
+    if (key.compare(0, kWorksPrefix.size(), kWorksPrefix) == 0) {
+        key.erase(0, kWorksPrefix.size());
     }
+    return key;
+}
 
-    auto j = json::parse(resp.text, nullptr, false);
-    if (!j.is_object() || !j.contains("docs")) return results;
+OnlineBookService::OnlineBookService(SearchCache* cache, HttpClient* http, CatalogDB* catalog)
+    : cache_(cache), http_(http ? http : &HttpClient::shared()), catalog_(catalog)
+{}
 
-    for (auto& doc : j["docs"]) {
-        if (!doc.is_object()) continue;
-        OnlineBook b;
-        b.title       = doc.value("title", "N/A");
-        
-        if (doc.contains("author_name") && doc["author_name"].is_array() && !doc["author_name"].empty()) {
-            b.author = doc["author_name"][0].get<std::string>();
-        } else {
-            b.author = "Unknown Author";
+std::vector<OnlineBook> OnlineBookService::search(const std::string& query, size_t limit, size_t offset) const {
+    return search(query, limit, offset, CancellationToken());
+}
+
+std::vector<OnlineBook> OnlineBookService::search(const std::string& query, size_t limit, size_t offset,
+                                                  const CancellationToken& token) const {
+    return trySearch(query, limit, offset, token).value_or(std::vector<OnlineBook>{});
+}
+
+std::optional<std::vector<OnlineBook>> OnlineBookService::trySearch(const std::string& query, size_t limit, size_t offset,
+                                                                    const CancellationToken& token) const {
+    ScopedTimer timer(Stage::Search);
+    token.throwIfCancelled();
+
+    // A query the local catalog knows is answered from it, pages included: past
+    // the catalog's last match the result is empty rather than a page of
+    // Open Library's differently ranked results.
+    if (catalog_) {
+        auto local = catalog_->search(query, limit, offset);
+        if (!local.empty() || (offset > 0 && !catalog_->search(query, 1, 0).empty())) {
+            return local;
         }
-        
-        b.publishYear = doc.contains("first_publish_year") && doc["first_publish_year"].is_number()
-                       ? std::to_string(doc["first_publish_year"].get<int>())
-                       : "N/A";
-                       
-        if (doc.contains("cover_i") && doc["cover_i"].is_number()) {
-            b.coverUrl = "https://covers.openlibrary.org/b/id/"
-                       + std::to_string(doc["cover_i"].get<int>()) + "-M.jpg";
+    }
+
+    // Serve repeated queries and page-backs from the cache when one is attached.
+    // The normalized key also identifies identical in-flight searches below.
+    const std::string cacheKey = SearchCache::makeKey(query, limit, offset);
+    if (cache_) {
+        if (auto cached = cache_->get(cacheKey)) {
+            return *cached;
         }
+    }
 
-        // New: Extract subjects (genres)
-        if (doc.contains("subject") && doc["subject"].is_array()) {
-            for (const auto& sub : doc["subject"]) {
-                if (b.subjects.size() < 4) { // Limit to first 4 subjects
-                    b.subjects.push_back(sub.get<std::string>());
-                } else {
-                    break;
-                }
-            }
+    // New: Added offset parameter to the URL for pagination
+    auto path = "/search.json?q=" + encode(query)
+             + "&limit=" + std::to_string(limit)
+             + "&offset=" + std::to_string(offset)
+             + "&fields=key,title,author_name,first_publish_year,cover_i,subject"; // Specify fields for efficiency
+
+    // The first caller for a query fetches (and fills the cache); overlapping callers wait for it.
+    return inflight_.run(cacheKey, token, [&]() {
+        auto results = fetch(path, token);
+        if (!cache_) {
+            return results;
         }
-        
-        // New: Construct the URL from the book's key
-        if (doc.contains("key") && doc["key"].is_string()) {
-            b.openLibraryUrl = "https://openlibrary.org" + doc["key"].get<std::string>();
+        if (!results) {
+            if (auto stale = cache_->getStale(cacheKey)) {
+                LOG_WARN("OnlineBookService", "Open Library unavailable; using saved results", query);
+                return stale;
+            }
+            return results;
         }
+        cache_->put(cacheKey, *results); // Only successful responses are cached
+        return results;
+    });
+}
 
-        results.push_back(std::move(b));
+std::optional<std::vector<OnlineBook>> OnlineBookService::fetch(const std::string& path,
+                                                                const CancellationToken& token) const {
+    // Goes over the shared client's warm keep-alive connections. The body is
+    // parsed while it downloads, straight into OnlineBook records.
+    std::vector<OnlineBook> results;
+    bool parsed = false;
+    static const OpenLibraryParser parser(4); // Keep the first 4 subjects
+    auto resp = http_->get(path, token, [&](std::istream& body) { parsed = parser.parse(body, results); });
+    if (resp.status != 200) {
+        token.throwIfCancelled(); // Deadline hit mid-request: not an Open Library failure
+        if (resp.circuitOpen) {
+            LOG_ERROR("OnlineBookService", "Open Library skipped: circuit open after repeated failures");
+        } else {
+            LOG_ERROR("OnlineBookService", "Failed to fetch data from Open Library; status code",
+                      static_cast<int64_t>(resp.status));
+        }
+        return std::nullopt;
     }
+
+    if (!parsed || !resp.error.empty()) return std::nullopt; // Not JSON, or cut short
+    token.throwIfCancelled();
     return results;
-}
\ No newline at end of file
+}
+
+std::future<std::vector<OnlineBook>> OnlineBookService::searchAsync(std::string query, size_t limit, size_t offset,
+                                                                    CancellationToken token) const {
+    return ThreadPool::shared().submit([this, query = std::move(query), limit, offset, token = std::move(token)]() {
+        return search(query, limit, offset, token);
+    });
+}
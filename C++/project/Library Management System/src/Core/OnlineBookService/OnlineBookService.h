@@ -1,18 +1,69 @@
 #pragma once
+#include <cstdint>
+#include <future>
+#include <optional>
 #include <string>
 #include <vector>
+#include "CancellationToken.h"
+#include "SingleFlight.h"
 
 struct OnlineBook {
     std::string title;
     std::string author;
     std::string publishYear;
-    std::string coverUrl;           // optional
+    int64_t coverId = 0;            // Open Library cover ID; 0 = no cover
     std::vector<std::string> subjects; // New: To hold genres/subjects
-    std::string openLibraryUrl;     // New: URL to the book's page
+    std::string workKey;            // Work key without the "/works/" prefix, e.g. "OL262758W"
+
+    // URLs are built on demand from the IDs above; empty when the ID is missing.
+    std::string coverUrl() const;       // Medium-size cover image
+    std::string openLibraryUrl() const; // The book's page
+
+    // Inverse of openLibraryUrl(), for URLs saved before books carried a work key.
+    static std::string workKeyFromUrl(const std::string& url);
 };
 
+class SearchCache; // Optional response cache (see Cache/SearchCache.h)
+class HttpClient;  // Shared keep-alive HTTP session (see Http/HttpClient.h)
+class CatalogDB;   // Optional local catalog (see Database/CatalogDB.h)
+
 class OnlineBookService {
 public:
+    // The cache is optional; pass nullptr to always hit the network.
+    // `http` defaults to HttpClient::shared(). With a `catalog`, queries it
+    // matches are answered locally and never reach the network. None are
+    // owned; all must outlive the service.
+    explicit OnlineBookService(SearchCache* cache = nullptr, HttpClient* http = nullptr,
+                               CatalogDB* catalog = nullptr);
+
     // Query Open Library for up to `limit` matches, starting from `offset`
     std::vector<OnlineBook> search(const std::string& query, size_t limit = 5, size_t offset = 0) const;
+
+    // Same, but stops once `token` is cancelled or past its deadline by
+    // throwing OperationCancelled (a cancelled call is never cached).
+    std::vector<OnlineBook> search(const std::string& query, size_t limit, size_t offset,
+                                   const CancellationToken& token) const;
+
+    // Like search(), but tells a failed request (empty optional) apart from a
+    // query with no matches (empty vector). When Open Library cannot be reached
+    // (after HttpClient's retries, or with its circuit open), an expired cache
+    // entry for the query is returned instead, if there is one.
+    std::optional<std::vector<OnlineBook>> trySearch(const std::string& query, size_t limit, size_t offset,
+                                                     const CancellationToken& token = {}) const;
+
+    // Runs search() on ThreadPool::shared() and returns at once. The future
+    // throws OperationCancelled if `token` stops the call. The service must
+    // outlive the future.
+    std::future<std::vector<OnlineBook>> searchAsync(std::string query, size_t limit = 5, size_t offset = 0,
+                                                     CancellationToken token = {}) const;
+
+private:
+    SearchCache* cache_;
+    HttpClient* http_;
+    CatalogDB* catalog_;
+    // Identical searches that overlap in time share one request, so a burst of
+    // sessions looking up the same new release costs Open Library one call.
+    mutable SingleFlight<std::string, std::optional<std::vector<OnlineBook>>> inflight_;
+
+    std::optional<std::vector<OnlineBook>> fetch(const std::string& path, const CancellationToken& token) const;
 };
\ No newline at end of file
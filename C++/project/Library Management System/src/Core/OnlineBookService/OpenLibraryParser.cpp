@@ -0,0 +1,178 @@
+#include "OpenLibraryParser.h"
+#include "Metrics.h"
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace {
+
+// SAX handler that tracks where it is in the document and only acts on the
+// handful of fields inside "docs" that OnlineBook needs.
+//
+// Nesting depth as seen by the handler:
+//   1 = top-level object, 2 = "docs" array, 3 = one doc object,
+//   4 = an array value inside a doc (author_name, subject).
+class SearchResponseHandler : public nlohmann::json_sax<json> {
+public:
+    SearchResponseHandler(size_t maxSubjects, std::vector<OnlineBook>& out)
+        : maxSubjects_(maxSubjects), out_(out) {}
+
+    bool sawDocs() const { return sawDocs_; }
+
+    bool null() override { return scalarDone(); }
+    bool boolean(bool) override { return scalarDone(); }
+    bool binary(binary_t&) override { return scalarDone(); }
+
+    bool number_integer(number_integer_t val) override { return number(static_cast<long long>(val)); }
+    bool number_unsigned(number_unsigned_t val) override { return number(static_cast<long long>(val)); }
+    bool number_float(number_float_t val, const string_t&) override { return number(static_cast<long long>(val)); }
+
+    bool string(string_t& val) override {
+        if (inDoc() && depth_ == 3) {
+            if (field_ == Field::Title) {
+                book_.title = std::move(val);
+            } else if (field_ == Field::Key) {
+                book_.workKey = OnlineBook::workKeyFromUrl(val); // "/works/OL1W" -> "OL1W"
+            }
+            field_ = Field::None;
+        } else if (inDoc() && depth_ == 4) {
+            if (field_ == Field::Author && !authorSet_) {
+                book_.author = std::move(val); // Only the first author is kept
+                authorSet_ = true;
+            } else if (field_ == Field::Subject && book_.subjects.size() < maxSubjects_) {
+                book_.subjects.push_back(std::move(val));
+            }
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        ++depth_;
+        if (inDocs_ && depth_ == 3) {
+            startBook();
+        } else if (depth_ == 4) {
+            field_ = Field::None; // Object-valued doc field: not one we keep
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        if (inDoc() && depth_ == 3) {
+            out_.push_back(std::move(book_));
+            docOpen_ = false;
+        }
+        --depth_;
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        ++depth_;
+        if (depth_ == 2 && expectDocs_) {
+            inDocs_ = sawDocs_ = true;
+        }
+        return true;
+    }
+
+    bool end_array() override {
+        if (depth_ == 2) {
+            inDocs_ = false;
+        } else if (inDoc() && depth_ == 4) {
+            field_ = Field::None; // Done with author_name / subject
+        }
+        --depth_;
+        return true;
+    }
+
+    bool key(string_t& val) override {
+        if (depth_ == 1) {
+            expectDocs_ = (val == "docs");
+        } else if (inDoc() && depth_ == 3) {
+            field_ = val == "title"              ? Field::Title
+                   : val == "author_name"        ? Field::Author
+                   : val == "first_publish_year" ? Field::Year
+                   : val == "cover_i"            ? Field::Cover
+                   : val == "subject"            ? Field::Subject
+                   : val == "key"                ? Field::Key
+                                                 : Field::None;
+        }
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override {
+        return false; // Abort; the caller discards partial results
+    }
+
+private:
+    enum class Field { None, Title, Author, Year, Cover, Subject, Key };
+
+    size_t maxSubjects_;
+    std::vector<OnlineBook>& out_;
+
+    size_t depth_ = 0;
+    bool expectDocs_ = false; // Last top-level key was "docs"
+    bool inDocs_ = false;
+    bool sawDocs_ = false;
+    bool docOpen_ = false;
+    bool authorSet_ = false;
+    Field field_ = Field::None;
+    OnlineBook book_;
+
+    bool inDoc() const { return inDocs_ && docOpen_; }
+
+    void startBook() {
+        // Same defaults the services used when fields are missing.
+        book_ = OnlineBook{};
+        book_.title = "N/A";
+        book_.author = "Unknown Author";
+        book_.publishYear = "N/A";
+        docOpen_ = true;
+        authorSet_ = false;
+        field_ = Field::None;
+    }
+
+    bool number(long long val) {
+        if (inDoc() && depth_ == 3) {
+            if (field_ == Field::Year) {
+                book_.publishYear = std::to_string(val);
+            } else if (field_ == Field::Cover) {
+                book_.coverId = val;
+            }
+        }
+        return scalarDone();
+    }
+
+    bool scalarDone() {
+        if (inDoc() && depth_ == 3) {
+            field_ = Field::None;
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+OpenLibraryParser::OpenLibraryParser(size_t maxSubjects)
+    : maxSubjects_(maxSubjects)
+{}
+
+bool OpenLibraryParser::parse(const std::string& body, std::vector<OnlineBook>& out) const {
+    ScopedTimer timer(Stage::JsonParse);
+    std::vector<OnlineBook> books;
+    SearchResponseHandler handler(maxSubjects_, books);
+    if (!json::sax_parse(body, &handler) || !handler.sawDocs()) {
+        return false;
+    }
+    out.insert(out.end(), std::make_move_iterator(books.begin()), std::make_move_iterator(books.end()));
+    return true;
+}
+
+bool OpenLibraryParser::parse(std::istream& in, std::vector<OnlineBook>& out) const {
+    ScopedTimer timer(Stage::JsonParse);
+    std::vector<OnlineBook> books;
+    SearchResponseHandler handler(maxSubjects_, books);
+    if (!json::sax_parse(in, &handler) || !handler.sawDocs()) {
+        return false;
+    }
+    out.insert(out.end(), std::make_move_iterator(books.begin()), std::make_move_iterator(books.end()));
+    return true;
+}
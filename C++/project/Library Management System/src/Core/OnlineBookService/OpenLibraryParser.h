@@ -0,0 +1,28 @@
+#pragma once
+#include <istream>
+#include <string>
+#include <vector>
+#include "OnlineBookService.h" // For the OnlineBook struct
+
+// Streaming parser for Open Library search.json responses.
+//
+// Built on nlohmann's SAX interface: no JSON DOM is ever materialized. Each
+// entry of the "docs" array is turned straight into an OnlineBook as its
+// tokens go by, and values we don't keep (extra subjects, extra authors,
+// unknown fields) are skipped without being stored.
+class OpenLibraryParser {
+public:
+    // Keep at most `maxSubjects` subjects per book.
+    explicit OpenLibraryParser(size_t maxSubjects);
+
+    // Parses a complete response body. Appends one OnlineBook per doc to `out`.
+    // Returns false (and leaves `out` unchanged) if the body is not valid JSON
+    // or has no top-level "docs" array.
+    bool parse(const std::string& body, std::vector<OnlineBook>& out) const;
+
+    // Same as above, but pulls bytes from a stream as the parser needs them.
+    bool parse(std::istream& in, std::vector<OnlineBook>& out) const;
+
+private:
+    size_t maxSubjects_;
+};
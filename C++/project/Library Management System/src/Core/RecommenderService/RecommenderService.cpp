@@ -1,10 +1,15 @@
 #include "RecommenderService.h"
-#include <cpr/cpr.h>
-#include <nlohmann/json.hpp>
-#include <iostream>
+#include "OpenLibraryParser.h"
+#include "ThreadPool.h"
+#include "HttpClient.h"
+#include "Metrics.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iterator>
 #include <sstream>
-
-using json = nlohmann::json;
+#include <unordered_map>
 
 // Helper to URL-encode strings (e.g., spaces to '%20', quotes to '%22')
 static std::string url_encode(const std::string& value) {
@@ -25,6 +30,14 @@ static std::string url_encode(const std::string& value) {
     return escaped.str();
 }
 
+// How long an AnySubject ranking is paged over before it is rebuilt, and how
+// many distinct subject lists are kept.
+static constexpr std::chrono::minutes kRankingTtl(10);
+static constexpr size_t kMaxCachedRankings = 32;
+
+RecommenderService::RecommenderService(HttpClient* http)
+    : http_(http ? http : &HttpClient::shared())
+{}
 
 // Provides a hardcoded list of popular and diverse subjects for a better UX.
 std::vector<std::string> RecommenderService::getPopularSubjects() const {
@@ -35,11 +48,21 @@ std::vector<std::string> RecommenderService::getPopularSubjects() const {
     };
 }
 
-std::vector<OnlineBook> RecommenderService::recommend(const std::vector<std::string>& subjects, size_t limit, size_t offset) const {
+std::vector<OnlineBook> RecommenderService::recommend(const std::vector<std::string>& subjects, size_t limit, size_t offset,
+                                                      RecommendMode mode) const {
+    return recommend(subjects, limit, offset, mode, CancellationToken());
+}
+
+std::vector<OnlineBook> RecommenderService::recommend(const std::vector<std::string>& subjects, size_t limit, size_t offset,
+                                                      RecommendMode mode, const CancellationToken& token) const {
+    ScopedTimer timer(Stage::Recommend);
     std::vector<OnlineBook> results;
     if (subjects.empty()) {
         return results;
     }
+    if (mode == RecommendMode::AnySubject && subjects.size() > 1) {
+        return recommendAny(subjects, limit, offset, token);
+    }
 
     // Construct a query by chaining subject filters.
     // e.g., subject:"Science Fiction" subject:"Adventure"
@@ -48,54 +71,173 @@ std::vector<OnlineBook> RecommenderService::recommend(const std::vector<std::str
         subjectQuery += "subject:\"" + subject + "\" ";
     }
 
-    auto url = "https://openlibrary.org/search.json?q=" + url_encode(subjectQuery)
+    return fetch(subjectQuery, limit, offset, token).value_or(std::vector<OnlineBook>{});
+}
+
+std::future<std::vector<OnlineBook>> RecommenderService::recommendAsync(std::vector<std::string> subjects, size_t limit,
+                                                                        size_t offset, RecommendMode mode,
+                                                                        CancellationToken token) const {
+    return ThreadPool::shared().submit(
+        [this, subjects = std::move(subjects), limit, offset, mode, token = std::move(token)]() {
+            return recommend(subjects, limit, offset, mode, token);
+        });
+}
+
+std::optional<std::vector<OnlineBook>> RecommenderService::fetch(const std::string& query, size_t limit, size_t offset,
+                                                                 const CancellationToken& token) const {
+    token.throwIfCancelled();
+    auto path = "/search.json?q=" + url_encode(query)
              + "&limit=" + std::to_string(limit)
              + "&offset=" + std::to_string(offset)
              + "&fields=key,title,author_name,first_publish_year,cover_i,subject";
 
-    auto resp = cpr::Get(cpr::Url{url});
-    if (resp.status_code != 200) {
-        std::cerr << "Error: Failed to fetch recommendations from Open Library (status code: " << resp.status_code << ")\n";
+    // The first caller for a path fetches; overlapping callers wait for its result.
+    return inflight_.run(path, token, [&]() -> std::optional<std::vector<OnlineBook>> {
+        // The body is parsed while it downloads, straight into OnlineBook records.
+        std::vector<OnlineBook> results;
+        bool parsed = false;
+        static const OpenLibraryParser parser(5); // Store up to 5 subjects
+        auto resp = http_->get(path, token, [&](std::istream& body) { parsed = parser.parse(body, results); });
+        if (resp.status != 200) {
+            token.throwIfCancelled(); // Deadline hit mid-request: not an Open Library failure
+            LOG_ERROR("RecommenderService", "Failed to fetch recommendations from Open Library; status code",
+                      static_cast<int64_t>(resp.status));
+            return std::nullopt;
+        }
+        if (!parsed || !resp.error.empty()) { // Not JSON, or cut short: a partial list is not an answer
+            token.throwIfCancelled();
+            LOG_ERROR("RecommenderService", "Unreadable recommendations from Open Library",
+                      resp.error.empty() ? std::string("not a search.json body") : resp.error);
+            return std::nullopt;
+        }
         return results;
-    }
+    });
+}
 
-    auto j = json::parse(resp.text, nullptr, false);
-    if (!j.is_object() || !j.contains("docs")) return results;
+std::vector<OnlineBook> RecommenderService::recommendAny(const std::vector<std::string>& subjects, size_t limit, size_t offset,
+                                                         const CancellationToken& token) const {
+    // Every page is cut from one ranking over a fixed window. Ranking a window
+    // that grows with the offset would let newer books from deeper down sort
+    // ahead of books already shown, repeating some and skipping others.
+    std::string key;
+    for (const auto& subject : subjects) {
+        key += subject + '\n';
+    }
+    Ranking ranking = cachedRanking(key);
+    if (!ranking) {
+        ranking = building_.run(key, token, [&]() { return buildRanking(key, subjects, token); });
+    }
 
-    for (auto& doc : j["docs"]) {
-        if (!doc.is_object()) continue;
-        OnlineBook b;
-        b.title = doc.value("title", "N/A");
+    std::vector<OnlineBook> results;
+    for (size_t i = offset; i < ranking->size() && i - offset < limit; ++i) {
+        results.push_back((*ranking)[i]);
+    }
+    return results;
+}
 
-        if (doc.contains("author_name") && doc["author_name"].is_array() && !doc["author_name"].empty()) {
-            b.author = doc["author_name"][0].get<std::string>();
-        } else {
-            b.author = "Unknown Author";
+RecommenderService::Ranking RecommenderService::buildRanking(const std::string& key, const std::vector<std::string>& subjects,
+                                                             const CancellationToken& token) const {
+    // One query per subject, all in flight together: total latency is roughly
+    // that of the slowest subject rather than the sum of them.
+    std::vector<std::vector<OnlineBook>> perSubject(subjects.size());
+    bool complete = true;
+    {
+        ThreadPool pool(std::min(subjects.size(), kMaxConcurrentSubjects));
+        std::vector<std::future<std::optional<std::vector<OnlineBook>>>> pending;
+        pending.reserve(subjects.size());
+        for (const auto& subject : subjects) {
+            pending.push_back(pool.submit([this, &subject, &token]() {
+                return fetch("subject:\"" + subject + "\"", kAnySubjectWindow, 0, token);
+            }));
         }
-
-        b.publishYear = doc.contains("first_publish_year") && doc["first_publish_year"].is_number()
-                       ? std::to_string(doc["first_publish_year"].get<int>())
-                       : "N/A";
-
-        if (doc.contains("cover_i") && doc["cover_i"].is_number()) {
-            b.coverUrl = "https://covers.openlibrary.org/b/id/"
-                       + std::to_string(doc["cover_i"].get<int>()) + "-M.jpg";
+        // If one sub-request throws OperationCancelled, the rest see the same
+        // token and stop too; the pool's destructor waits for them either way.
+        for (size_t i = 0; i < pending.size(); ++i) {
+            auto books = pending[i].get();
+            if (books) {
+                perSubject[i] = std::move(*books);
+            } else {
+                complete = false;
+            }
         }
+    }
 
-        if (doc.contains("subject") && doc["subject"].is_array()) {
-            for (const auto& sub : doc["subject"]) {
-                if (b.subjects.size() < 5) { // Store up to 5 subjects
-                    b.subjects.push_back(sub.get<std::string>());
-                } else {
-                    break;
-                }
+    // Merge and dedup by work key, remembering how many subjects each book matched
+    // and its best position in any subject's list.
+    struct Candidate {
+        OnlineBook book;
+        size_t matches = 0;
+        size_t bestRank = 0;
+        int year = 0;
+    };
+    std::vector<Candidate> candidates;
+    std::unordered_map<std::string, size_t> byKey;
+    for (auto& list : perSubject) {
+        for (size_t rank = 0; rank < list.size(); ++rank) {
+            auto& book = list[rank];
+            const std::string bookKey = !book.workKey.empty() ? book.workKey
+                                                              : book.title + '\n' + book.author;
+            auto it = byKey.find(bookKey);
+            if (it == byKey.end()) {
+                Candidate c;
+                c.year = std::atoi(book.publishYear.c_str()); // "N/A" -> 0
+                c.book = std::move(book);
+                c.matches = 1;
+                c.bestRank = rank;
+                byKey.emplace(bookKey, candidates.size());
+                candidates.push_back(std::move(c));
+            } else {
+                auto& c = candidates[it->second];
+                ++c.matches;
+                c.bestRank = std::min(c.bestRank, rank);
             }
         }
+    }
+
+    // Rank: books matching more of the chosen subjects first, then newer books,
+    // then whichever ranked higher with Open Library.
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        if (a.matches != b.matches) return a.matches > b.matches;
+        if (a.year != b.year) return a.year > b.year;
+        return a.bestRank < b.bestRank;
+    });
+
+    auto books = std::make_shared<std::vector<OnlineBook>>();
+    books->reserve(candidates.size());
+    for (auto& c : candidates) {
+        books->push_back(std::move(c.book));
+    }
+    Ranking ranking = std::move(books);
+    if (complete) {
+        cacheRanking(key, ranking); // A partial ranking is served once, then retried
+    }
+    return ranking;
+}
 
-        if (doc.contains("key") && doc["key"].is_string()) {
-            b.openLibraryUrl = "https://openlibrary.org" + doc["key"].get<std::string>();
+RecommenderService::Ranking RecommenderService::cachedRanking(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(rankingsMutex_);
+    auto it = rankings_.find(key);
+    if (it == rankings_.end()) return nullptr;
+    if (it->second.expiresAt <= std::chrono::steady_clock::now()) {
+        rankings_.erase(it);
+        return nullptr;
+    }
+    return it->second.books;
+}
+
+void RecommenderService::cacheRanking(const std::string& key, Ranking ranking) const {
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(rankingsMutex_);
+    if (rankings_.size() >= kMaxCachedRankings && !rankings_.count(key)) {
+        // Drop what has expired, or else the ranking closest to expiring.
+        for (auto it = rankings_.begin(); it != rankings_.end();) {
+            it = it->second.expiresAt <= now ? rankings_.erase(it) : std::next(it);
+        }
+        if (rankings_.size() >= kMaxCachedRankings) {
+            rankings_.erase(std::min_element(rankings_.begin(), rankings_.end(), [](const auto& a, const auto& b) {
+                return a.second.expiresAt < b.second.expiresAt;
+            }));
         }
-        results.push_back(std::move(b));
     }
-    return results;
-}
\ No newline at end of file
+    rankings_[key] = CachedRanking{std::move(ranking), now + kRankingTtl};
+}
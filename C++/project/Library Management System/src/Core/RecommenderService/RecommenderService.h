@@ -2,17 +2,90 @@
 #define RECOMMENDER_SERVICE_H
 
 #include "OnlineBookService.h" // For the OnlineBook struct
+#include "SingleFlight.h"
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+// How multiple chosen subjects are combined.
+enum class RecommendMode {
+    AllSubjects, // One query requiring every subject (subject:"A" subject:"B")
+    AnySubject   // One query per subject, run concurrently, then merged and ranked;
+                 // pages come from one merged ranking kept for a few minutes
+};
+
+class HttpClient; // Shared keep-alive HTTP session (see Http/HttpClient.h)
+
 class RecommenderService {
 public:
+    // `http` defaults to HttpClient::shared(); it is not owned and must outlive the service.
+    explicit RecommenderService(HttpClient* http = nullptr);
+
     // Provides a curated list of popular subjects/genres for the user to choose from.
     std::vector<std::string> getPopularSubjects() const;
 
     // Recommends books from the Open Library API based on a list of subjects.
     // Supports pagination with limit and offset.
-    std::vector<OnlineBook> recommend(const std::vector<std::string>& subjects, size_t limit = 5, size_t offset = 0) const;
+    std::vector<OnlineBook> recommend(const std::vector<std::string>& subjects, size_t limit = 5, size_t offset = 0,
+                                      RecommendMode mode = RecommendMode::AllSubjects) const;
+
+    // Same, but stops once `token` is cancelled or past its deadline by
+    // throwing OperationCancelled. In AnySubject mode every sub-request shares it.
+    std::vector<OnlineBook> recommend(const std::vector<std::string>& subjects, size_t limit, size_t offset,
+                                      RecommendMode mode, const CancellationToken& token) const;
+
+    // Runs recommend() on ThreadPool::shared() and returns at once. The future
+    // throws OperationCancelled if `token` stops the call. The service must
+    // outlive the future.
+    std::future<std::vector<OnlineBook>> recommendAsync(std::vector<std::string> subjects, size_t limit = 5,
+                                                        size_t offset = 0,
+                                                        RecommendMode mode = RecommendMode::AllSubjects,
+                                                        CancellationToken token = {}) const;
+
+    // Upper bound on simultaneous per-subject requests in AnySubject mode.
+    static constexpr size_t kMaxConcurrentSubjects = 8;
+
+    // AnySubject mode ranks each subject's top this-many books; pages past the
+    // merged ranking are empty.
+    static constexpr size_t kAnySubjectWindow = 100;
+
+private:
+    using Ranking = std::shared_ptr<const std::vector<OnlineBook>>;
+    struct CachedRanking {
+        Ranking books;
+        std::chrono::steady_clock::time_point expiresAt;
+    };
+
+    HttpClient* http_; // Shared by all sub-requests, including the AnySubject fan-out
+    // Identical queries that overlap in time (e.g. many sessions picking the same
+    // subject) share one request.
+    mutable SingleFlight<std::string, std::optional<std::vector<OnlineBook>>> inflight_;
+
+    // AnySubject rankings by subject list, so every page of a query is cut
+    // from the same list and earlier pages are not fetched again.
+    mutable std::mutex rankingsMutex_; // Guards rankings_
+    mutable std::unordered_map<std::string, CachedRanking> rankings_;
+    mutable SingleFlight<std::string, Ranking> building_;
+
+    // Runs one search.json query; returns nullopt on failure.
+    std::optional<std::vector<OnlineBook>> fetch(const std::string& query, size_t limit, size_t offset,
+                                                 const CancellationToken& token) const;
+
+    // AnySubject mode: pages over the merged ranking for `subjects`.
+    std::vector<OnlineBook> recommendAny(const std::vector<std::string>& subjects, size_t limit, size_t offset,
+                                         const CancellationToken& token) const;
+
+    // Fans out one query per subject and merges the results into one ranking.
+    // Cached unless a sub-request failed.
+    Ranking buildRanking(const std::string& key, const std::vector<std::string>& subjects,
+                         const CancellationToken& token) const;
+    Ranking cachedRanking(const std::string& key) const;
+    void cacheRanking(const std::string& key, Ranking ranking) const;
 };
 
 #endif // RECOMMENDER_SERVICE_H
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef DATE_UTILS_H
+#define DATE_UTILS_H
+
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <optional>
+#include <string>
+
+namespace util {
+
+// Dates are stored as "epoch days": whole days since 1970-01-01 (proleptic
+// Gregorian). One integer per date, so ranges compare and index as numbers.
+using EpochDay = int32_t;
+
+// Days since 1970-01-01 for a calendar date (Howard Hinnant's days_from_civil).
+inline EpochDay toEpochDay(int year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return static_cast<EpochDay>(era * 146097 + static_cast<int>(doe) - 719468);
+}
+
+// "YYYY-MM-DD" for an epoch day (inverse of toEpochDay).
+inline std::string formatEpochDay(EpochDay days) {
+    const int z = days + 719468;
+    const int era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned day = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned month = mp < 10 ? mp + 3 : mp - 9;
+    const int year = static_cast<int>(yoe) + era * 400 + (month <= 2);
+
+    char buf[36]; // Room for any int year and unsigned month and day, so GCC can see nothing is cut
+    std::snprintf(buf, sizeof(buf), "%04d-%02u-%02u", year, month, day);
+    return buf;
+}
+
+// Parses "YYYY-MM-DD". Returns empty optional if the text is not a valid date.
+inline std::optional<EpochDay> parseEpochDay(const std::string& text) {
+    int year = 0;
+    unsigned month = 0, day = 0;
+    char tail = 0;
+    if (std::sscanf(text.c_str(), "%4d-%2u-%2u%c", &year, &month, &day, &tail) != 3 ||
+        month < 1 || month > 12 || day < 1 || day > 31) {
+        return std::nullopt;
+    }
+    const EpochDay days = toEpochDay(year, month, day);
+    if (formatEpochDay(days) != text) {
+        return std::nullopt; // e.g. February 30th rolled over into March
+    }
+    return days;
+}
+
+// Today's date in the local time zone.
+inline EpochDay todayEpochDay() {
+    std::time_t now = std::time(nullptr);
+    std::tm local = *std::localtime(&now);
+    return toEpochDay(local.tm_year + 1900, static_cast<unsigned>(local.tm_mon + 1),
+                      static_cast<unsigned>(local.tm_mday));
+}
+
+} // namespace util
+
+#endif // DATE_UTILS_H
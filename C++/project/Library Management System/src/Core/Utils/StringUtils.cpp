@@ -1,2 +1,385 @@
-// (all functions are inline in header; this file can remain empty or be omitted)
 #include "StringUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRING_UTILS_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(STRING_UTILS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+// Built without -mavx2: the AVX2 kernels are compiled for it one function at
+// a time and only called once the CPU says it has it.
+#define STRING_UTILS_AVX2 1
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace util {
+
+namespace {
+
+// Which bytes the normalizers keep; runs of all other bytes become one space.
+enum class Words { AlphaNumeric, NonSpace };
+
+bool isWordByte(unsigned char c, Words words) {
+    if (words == Words::AlphaNumeric) {
+        return static_cast<unsigned>((c | 0x20) - 'a') < 26u || static_cast<unsigned>(c - '0') < 10u;
+    }
+    return !(c == ' ' || (c >= '\t' && c <= '\r')); // The std::isspace set
+}
+
+void toLowerScalar(char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) data[i] = toLowerAscii(data[i]);
+}
+
+unsigned countTrailingZeros(uint64_t x) { // x != 0
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+}
+
+// Output side of the normalizers. Each byte is kept (word bytes, lowered)
+// or becomes a space (the first separator after a word) or is dropped, so
+// the output never overtakes the input and the two can share a buffer
+// (output at or before input). A trailing space is trimmed once all input
+// is seen.
+struct Writer {
+    char* data;
+    size_t out = 0;
+    bool afterWord = false; // The last byte read was a word byte
+
+    // Bytes of `block` whose bit is set in `keep`, copied in runs.
+    void copyKept(const char* block, uint64_t keep, unsigned width) {
+        unsigned pos = 0;
+        while (pos < width && (keep >> pos) != 0) {
+            pos += countTrailingZeros(keep >> pos);
+            const unsigned run = std::min(width - pos, countTrailingZeros(~(keep >> pos)));
+            std::memmove(data + out, block + pos, run);
+            out += run;
+            pos += run;
+        }
+    }
+};
+
+void normalizeScalar(Writer& w, const char* p, size_t size, Words words) {
+    for (size_t i = 0; i < size; ++i) {
+        const bool word = isWordByte(static_cast<unsigned char>(p[i]), words);
+        if (word) {
+            w.data[w.out++] = toLowerAscii(p[i]);
+        } else if (w.afterWord) {
+            w.data[w.out++] = ' '; // Leading separators are dropped: nothing came before
+        }
+        w.afterWord = word;
+    }
+}
+
+// Bookkeeping for the first `width` bytes of a block, given bit i of
+// `wordMask` set where byte i is a word byte. Returns the bits of the bytes
+// to keep.
+uint64_t blockKeepMask(Writer& w, uint64_t wordMask, unsigned width) {
+    const uint64_t all = (uint64_t(1) << width) - 1;
+    const uint64_t keep = (wordMask | (wordMask << 1) | (w.afterWord ? 1 : 0)) & all;
+    w.afterWord = (wordMask >> (width - 1)) & 1;
+    return keep;
+}
+
+#ifdef STRING_UTILS_SSE2
+// Bytes in [first, first + count), by the usual bias trick: SSE2 only has
+// signed compares, so shift the range down to start at -128.
+__m128i inRange16(__m128i v, char first, int count) {
+    const __m128i shifted = _mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(0x80 - first)));
+    return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(-128 + count)));
+}
+
+__m128i lower16(__m128i v) {
+    return _mm_or_si128(v, _mm_and_si128(inRange16(v, 'A', 26), _mm_set1_epi8(0x20)));
+}
+
+__m128i wordBytes16(__m128i v, __m128i lowered, Words words) {
+    if (words == Words::AlphaNumeric) {
+        return _mm_or_si128(inRange16(lowered, 'a', 26), inRange16(v, '0', 10));
+    }
+    const __m128i space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), inRange16(v, '\t', 5));
+    return _mm_xor_si128(space, _mm_set1_epi8(-1));
+}
+
+void toLowerSse2(char* data, size_t size) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i);
+        _mm_storeu_si128(p, lower16(_mm_loadu_si128(p)));
+    }
+    toLowerScalar(data + i, size - i);
+}
+
+size_t normalizeSse2(const char* src, size_t size, char* dst, Words words, bool padded) {
+    Writer w{dst};
+    alignas(16) char block[16];
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i low = lower16(v);
+        const __m128i word = wordBytes16(v, low, words);
+        // Word bytes lowered, separators as spaces
+        const __m128i out = _mm_or_si128(_mm_and_si128(word, low), _mm_andnot_si128(word, _mm_set1_epi8(' ')));
+        const uint64_t keep = blockKeepMask(w, static_cast<uint32_t>(_mm_movemask_epi8(word)), 16);
+        if (keep == 0xFFFFu) { // Words and single separators: the common case
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + w.out), out);
+            w.out += 16;
+        } else if (keep != 0) {
+            _mm_store_si128(reinterpret_cast<__m128i*>(block), out);
+            w.copyKept(block, keep, 16);
+        }
+    }
+    if (padded && i < size) { // The last block may read past the text; only its first bytes count
+        const unsigned rest = static_cast<unsigned>(size - i);
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i low = lower16(v);
+        const __m128i word = wordBytes16(v, low, words);
+        const __m128i out = _mm_or_si128(_mm_and_si128(word, low), _mm_andnot_si128(word, _mm_set1_epi8(' ')));
+        _mm_store_si128(reinterpret_cast<__m128i*>(block), out);
+        w.copyKept(block, blockKeepMask(w, static_cast<uint32_t>(_mm_movemask_epi8(word)), rest), rest);
+        return w.out;
+    }
+    normalizeScalar(w, src + i, size - i, words);
+    return w.out;
+}
+#endif // STRING_UTILS_SSE2
+
+#ifdef STRING_UTILS_AVX2
+TARGET_AVX2 __m256i inRange32(__m256i v, char first, int count) {
+    const __m256i shifted = _mm256_add_epi8(v, _mm256_set1_epi8(static_cast<char>(0x80 - first)));
+    return _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(-128 + count)), shifted);
+}
+
+TARGET_AVX2 __m256i lower32(__m256i v) {
+    return _mm256_or_si256(v, _mm256_and_si256(inRange32(v, 'A', 26), _mm256_set1_epi8(0x20)));
+}
+
+TARGET_AVX2 __m256i wordBytes32(__m256i v, __m256i lowered, Words words) {
+    if (words == Words::AlphaNumeric) {
+        return _mm256_or_si256(inRange32(lowered, 'a', 26), inRange32(v, '0', 10));
+    }
+    const __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), inRange32(v, '\t', 5));
+    return _mm256_xor_si256(space, _mm256_set1_epi8(-1));
+}
+
+TARGET_AVX2 void toLowerAvx2(char* data, size_t size) {
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i* p = reinterpret_cast<__m256i*>(data + i);
+        _mm256_storeu_si256(p, lower32(_mm256_loadu_si256(p)));
+    }
+    toLowerSse2(data + i, size - i);
+}
+
+TARGET_AVX2 size_t normalizeAvx2(const char* src, size_t size, char* dst, Words words, bool padded) {
+    Writer w{dst};
+    alignas(32) char block[32];
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i low = lower32(v);
+        const __m256i word = wordBytes32(v, low, words);
+        const __m256i out = _mm256_blendv_epi8(_mm256_set1_epi8(' '), low, word);
+        const uint64_t keep = blockKeepMask(w, static_cast<uint32_t>(_mm256_movemask_epi8(word)), 32);
+        if (keep == 0xFFFFFFFFu) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + w.out), out);
+            w.out += 32;
+        } else if (keep != 0) {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(block), out);
+            w.copyKept(block, keep, 32);
+        }
+    }
+    if (padded && i < size) {
+        const unsigned rest = static_cast<unsigned>(size - i);
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i low = lower32(v);
+        const __m256i word = wordBytes32(v, low, words);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(block), _mm256_blendv_epi8(_mm256_set1_epi8(' '), low, word));
+        w.copyKept(block, blockKeepMask(w, static_cast<uint32_t>(_mm256_movemask_epi8(word)), rest), rest);
+        return w.out;
+    }
+    normalizeScalar(w, src + i, size - i, words);
+    return w.out;
+}
+#endif // STRING_UTILS_AVX2
+
+SimdLevel supportedLevel() {
+#if defined(STRING_UTILS_AVX2)
+    return __builtin_cpu_supports("avx2") ? SimdLevel::AVX2 : SimdLevel::SSE2;
+#elif defined(STRING_UTILS_SSE2)
+    return SimdLevel::SSE2;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+std::atomic<SimdLevel>& activeLevel() {
+    static std::atomic<SimdLevel> level{supportedLevel()};
+    return level;
+}
+
+// Bytes readable past the end of a text for `padded` normalization.
+constexpr size_t kPadding = 32;
+
+// Normalizes [src, src + size) to dst (at or before src) and returns the
+// output length. With `padded`, kPadding bytes past the text may be read.
+size_t normalize(const char* src, size_t size, char* dst, Words words, bool padded) {
+    size_t out;
+    switch (activeLevel().load(std::memory_order_relaxed)) {
+#ifdef STRING_UTILS_AVX2
+    case SimdLevel::AVX2: out = normalizeAvx2(src, size, dst, words, padded); break;
+#endif
+#ifdef STRING_UTILS_SSE2
+    case SimdLevel::SSE2: out = normalizeSse2(src, size, dst, words, padded); break;
+#endif
+    default: {
+        Writer w{dst};
+        normalizeScalar(w, src, size, words);
+        out = w.out;
+    }
+    }
+    if (out > 0 && dst[out - 1] == ' ') --out; // Separators ended the text
+    return out;
+}
+
+// Simple case folding (CaseFolding.txt, status C and S) of the two-byte
+// UTF-8 range this handles.
+uint32_t foldCodePoint(uint32_t c) {
+    if (c == 0xB5) return 0x3BC;                                    // Micro sign -> mu
+    if (c >= 0xC0 && c <= 0xDE && c != 0xD7) return c + 0x20;       // Latin-1
+    if (c >= 0x100 && c <= 0x17F) {                                 // Latin Extended-A
+        if (c == 0x178) return 0xFF;
+        if (c == 0x17F) return 's';
+        if (c == 0x130 || c == 0x131 || c == 0x138 || c == 0x149) return c;
+        const bool oddUpper = (c >= 0x139 && c <= 0x148) || (c >= 0x179 && c <= 0x17E);
+        return ((c & 1) != 0) == oddUpper ? c + 1 : c;
+    }
+    if (c == 0x386) return 0x3AC;                                   // Greek
+    if (c >= 0x388 && c <= 0x38A) return c + 0x25;
+    if (c == 0x38C) return 0x3CC;
+    if (c == 0x38E || c == 0x38F) return c + 0x3F;
+    if (c >= 0x391 && c <= 0x3AB && c != 0x3A2) return c + 0x20;
+    if (c == 0x3C2) return 0x3C3;                                   // Final sigma
+    if (c >= 0x400 && c <= 0x40F) return c + 0x50;                  // Cyrillic
+    if (c >= 0x410 && c <= 0x42F) return c + 0x20;
+    return c;
+}
+
+} // namespace
+
+SimdLevel simdLevel() {
+    return activeLevel().load(std::memory_order_relaxed);
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::AVX2: return "avx2";
+    case SimdLevel::SSE2: return "sse2";
+    default: return "scalar";
+    }
+}
+
+SimdLevel setSimdLevel(SimdLevel level) {
+    const SimdLevel used = std::min(level, supportedLevel());
+    activeLevel().store(used, std::memory_order_relaxed);
+    return used;
+}
+
+void toLowerAsciiInPlace(char* data, size_t size) {
+    switch (simdLevel()) {
+#ifdef STRING_UTILS_AVX2
+    case SimdLevel::AVX2: toLowerAvx2(data, size); return;
+#endif
+#ifdef STRING_UTILS_SSE2
+    case SimdLevel::SSE2: toLowerSse2(data, size); return;
+#endif
+    default: toLowerScalar(data, size);
+    }
+}
+
+std::string_view normalizeTitleInPlace(char* data, size_t size) {
+    return std::string_view(data, normalize(data, size, data, Words::AlphaNumeric, false));
+}
+
+std::string normalizeTitle(std::string_view title) {
+    std::string out(title);
+    out.resize(normalizeTitleInPlace(out.data(), out.size()).size());
+    return out;
+}
+
+std::string_view normalizeQueryInPlace(char* data, size_t size) {
+    return std::string_view(data, normalize(data, size, data, Words::NonSpace, false));
+}
+
+std::string foldCase(std::string_view text) {
+    std::string out(text);
+    toLowerAsciiInPlace(out.data(), out.size());
+    size_t i = 0;
+    while (i < out.size() && static_cast<unsigned char>(out[i]) < 0x80) ++i;
+
+    // Every folding here maps two bytes to at most two, so it is done in place.
+    size_t o = i;
+    while (i < out.size()) {
+        const unsigned char c = static_cast<unsigned char>(out[i]);
+        if (c >= 0xC2 && c <= 0xDF && i + 1 < out.size() && (static_cast<unsigned char>(out[i + 1]) & 0xC0) == 0x80) {
+            const uint32_t code = ((c & 0x1Fu) << 6) | (static_cast<unsigned char>(out[i + 1]) & 0x3Fu);
+            i += 2;
+            if (code == 0xDF) { // Sharp s folds to "ss"
+                out[o++] = 's';
+                out[o++] = 's';
+                continue;
+            }
+            const uint32_t folded = foldCodePoint(code);
+            if (folded < 0x80) {
+                out[o++] = static_cast<char>(folded);
+            } else {
+                out[o++] = static_cast<char>(0xC0 | (folded >> 6));
+                out[o++] = static_cast<char>(0x80 | (folded & 0x3F));
+            }
+        } else {
+            out[o++] = out[i++]; // ASCII (already lowered), longer sequences, stray bytes
+        }
+    }
+    out.resize(o);
+    return out;
+}
+
+NormalizedTitles normalizeTitles(const std::vector<std::string>& titles) {
+    // All titles are copied in first, then normalized one after another
+    // towards the front of the same buffer. Each title is then followed by
+    // readable bytes (the next titles, then padding), so its last partial
+    // block is done with vector instructions too.
+    NormalizedTitles result;
+    size_t total = 0;
+    for (const auto& t : titles) total += t.size();
+    result.text.resize(total + kPadding);
+    char* text = result.text.data();
+    size_t in = 0;
+    for (const auto& t : titles) {
+        std::memcpy(text + in, t.data(), t.size());
+        in += t.size();
+    }
+    result.offsets.reserve(titles.size() + 1);
+    size_t out = 0;
+    in = 0;
+    for (const auto& t : titles) {
+        result.offsets.push_back(static_cast<uint32_t>(out));
+        out += normalize(text + in, t.size(), text + out, Words::AlphaNumeric, true);
+        in += t.size();
+    }
+    result.offsets.push_back(static_cast<uint32_t>(out));
+    result.text.resize(out);
+    return result;
+}
+
+} // namespace util
@@ -1,25 +1,84 @@
 #ifndef STRING_UTILS_H
 #define STRING_UTILS_H
 
+#include <cstdint>
 #include <string>
-#include <algorithm>
-#include <cctype>
+#include <string_view>
+#include <vector>
 
 namespace util {
 
-inline std::string trim(const std::string& s) {
+// `s` without leading and trailing spaces, tabs and line breaks.
+inline std::string_view trimView(std::string_view s) {
     auto begin = s.find_first_not_of(" \t\n\r");
-    if (begin == std::string::npos) return "";
+    if (begin == std::string_view::npos) return {};
     auto end = s.find_last_not_of(" \t\n\r");
     return s.substr(begin, end - begin + 1);
 }
 
+inline std::string trim(const std::string& s) {
+    return std::string(trimView(s));
+}
+
+// ASCII-only lowercasing: bytes outside A-Z (UTF-8 included) are left alone,
+// whatever the C locale says.
+inline char toLowerAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+void toLowerAsciiInPlace(char* data, size_t size);
+
 inline std::string toLower(std::string s) {
-    std::transform(s.begin(), s.end(), s.begin(),
-                   [](unsigned char c){ return std::tolower(c); });
+    toLowerAsciiInPlace(s.data(), s.size());
     return s;
 }
 
+// --- Normalization kernels ---
+//
+// The kernels below classify and lowercase 16 (SSE2) or 32 (AVX2) bytes at a
+// time; the widest the CPU supports is picked on first use. The in-place
+// forms never grow the text: they rewrite [data, data + size) and return the
+// normalized prefix.
+
+enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+SimdLevel simdLevel();
+const char* simdLevelName(SimdLevel level);
+
+// Forces a kernel width, for tests and benchmarks. Capped at what the CPU
+// supports; returns the level now in use.
+SimdLevel setSimdLevel(SimdLevel level);
+
+// Title form used by the fuzzy index: ASCII lowercased, every run of bytes
+// other than letters and digits (punctuation, whitespace, non-ASCII) folded
+// to one space, trimmed. "The Lord of the Rings: Return!" -> "the lord of the
+// rings return".
+std::string_view normalizeTitleInPlace(char* data, size_t size);
+std::string normalizeTitle(std::string_view title);
+
+// Query form used for cache keys: ASCII lowercased, whitespace runs folded to
+// one space, trimmed; punctuation is kept. "  The   Hobbit " -> "the hobbit".
+std::string_view normalizeQueryInPlace(char* data, size_t size);
+
+// Simple Unicode case folding of UTF-8 text: ASCII, Latin-1, Latin
+// Extended-A, Greek and Cyrillic capitals fold to lowercase ("ß" to "ss").
+// Other characters, and malformed UTF-8, are copied unchanged.
+std::string foldCase(std::string_view text);
+
+// Many titles normalized into one buffer (one allocation instead of one per
+// title). Title i is text[offsets[i], offsets[i + 1]).
+struct NormalizedTitles {
+    std::string text;
+    std::vector<uint32_t> offsets;
+
+    size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    std::string_view operator[](size_t i) const {
+        return std::string_view(text).substr(offsets[i], offsets[i + 1] - offsets[i]);
+    }
+};
+
+NormalizedTitles normalizeTitles(const std::vector<std::string>& titles);
+
 } // namespace util
 
 #endif // STRING_UTILS_H
@@ -1,6 +1,7 @@
 #include "LoanUI.h"
 #include <iostream>
 #include <limits> // For std::numeric_limits
+#include "DateUtils.h" // For formatting due dates
 
 // Constructor: Takes a reference to the LoanService.
 LoanUI::LoanUI(LoanService& svc)
@@ -12,11 +13,13 @@ void LoanUI::runMenu() {
     do {
         std::cout << "\n=== Loan Menu ===\n"
                   << "1) Borrow a book\n"
-                  << "2) Back to Main Menu\n"
+                  << "2) Borrow several books\n"
+                  << "3) Show overdue loans\n"
+                  << "4) Back to Main Menu\n"
                   << "Choice: ";
         // Input validation loop for menu choice
-        while (!(std::cin >> choice) || (choice < 1 || choice > 2)) {
-            std::cout << "Invalid choice. Please enter 1 or 2: ";
+        while (!(std::cin >> choice) || (choice < 1 || choice > 4)) {
+            std::cout << "Invalid choice. Please enter 1, 2, 3 or 4: ";
             std::cin.clear(); // Clear error flags
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Discard invalid input
         }
@@ -24,11 +27,13 @@ void LoanUI::runMenu() {
 
         switch (choice) {
             case 1: doBorrow(); break;
-            case 2: break; // Exit loop
+            case 2: doBatchBorrow(); break;
+            case 3: doShowOverdue(); break;
+            case 4: break; // Exit loop
             default: // This default should theoretically not be reached due to validation loop
                 std::cout << "An unexpected error occurred with choice selection.\n";
         }
-    } while (choice != 2);
+    } while (choice != 4);
 }
 
 void LoanUI::doBorrow() {
@@ -48,3 +53,57 @@ void LoanUI::doBorrow() {
                   << "  Due Date:    " << result->dueDate   << "\n";
     }
 }
+
+void LoanUI::doBatchBorrow() {
+    std::cout << "Enter one book title per line (empty line to finish):\n";
+    std::vector<std::string> titles;
+    std::string title;
+    while (std::getline(std::cin, title) && !title.empty()) {
+        titles.push_back(title);
+    }
+    if (titles.empty()) {
+        std::cout << "No titles entered.\n";
+        return;
+    }
+
+    auto results = svc_.borrowBooks(titles); // Checked concurrently, saved in one transaction
+
+    size_t borrowed = 0;
+    for (size_t i = 0; i < titles.size(); ++i) {
+        if (results[i]) {
+            ++borrowed;
+            std::cout << "  \"" << titles[i] << "\": due " << results[i]->dueDate << "\n";
+        } else {
+            std::cout << "  \"" << titles[i] << "\": not borrowed\n";
+        }
+    }
+    std::cout << borrowed << " of " << titles.size() << " books borrowed.\n";
+}
+
+void LoanUI::doShowOverdue() {
+    const size_t pageSize = 10;
+    std::optional<LoanCursor> cursor;
+    size_t shown = 0;
+    do {
+        LoanPage page = svc_.overdueLoans(pageSize, cursor);
+        for (const auto& loan : page.loans) {
+            std::cout << "  #" << loan.id << " \"" << loan.bookTitle << "\": due "
+                      << util::formatEpochDay(loan.dueDay) << "\n";
+        }
+        shown += page.loans.size();
+        cursor = page.next;
+        if (!cursor) {
+            break;
+        }
+        std::cout << "Show more? (y/n): ";
+        std::string answer;
+        std::getline(std::cin, answer);
+        if (answer != "y" && answer != "Y") {
+            break;
+        }
+    } while (true);
+
+    if (shown == 0) {
+        std::cout << "No overdue loans.\n";
+    }
+}
@@ -11,6 +11,8 @@ public:
 private:
     LoanService& svc_;
     void doBorrow();
+    void doBatchBorrow();
+    void doShowOverdue();
 };
 
 #endif // LOAN_UI_H
@@ -5,24 +5,60 @@
 #include "OnlineBookService.h"
 #include "RecommenderService.h"
 #include "LoanService.h"
+#include "SearchCache.h"
+#include "DatabasePool.h"
+#include "HttpClient.h"
+#include "CatalogDB.h"
+#include "CatalogSnapshot.h"
+#include <memory>
 #include <iostream>
 #include <limits>
 
+MainMenuUI::MainMenuUI(SearchMode searchMode, std::string catalogPath, std::string snapshotPath)
+    : searchMode_(searchMode), catalogPath_(std::move(catalogPath)), snapshotPath_(std::move(snapshotPath))
+{}
+
 void MainMenuUI::run() {
     // --- Service and Database Initialization ---
     // Define the paths to your SQLite database files in the 'data' directory.
     const std::string readListDbPath = "data/test_readlist.db";
     const std::string loanDbPath     = "data/test_loan_requests.db";
+    const std::string cacheDbPath    = "data/search_cache.db";
+
+    // One keep-alive HTTP client for all Open Library traffic, so services reuse
+    // warm TLS connections instead of handshaking on every request.
+    HttpClientOptions httpOptions;
+    httpOptions.connectTimeout = std::chrono::seconds(3);
+    httpOptions.requestTimeout = std::chrono::seconds(10);
+    HttpClient httpClient(httpOptions);
+
+    // One search cache for the whole session, shared by every OnlineBookService.
+    SearchCache searchCache(cacheDbPath);
+
+    // Open each database exactly once; every component below shares these connections.
+    DatabasePool databasePool;
+    auto readListDb = databasePool.readList(readListDbPath);
+    auto loanDb     = databasePool.loanRequests(loanDbPath);
+
+    // Searches and borrow checks try the local catalog first, when there is one.
+    std::unique_ptr<CatalogDB> catalog;
+    if (!catalogPath_.empty()) {
+        catalog = std::make_unique<CatalogDB>(catalogPath_);
+    }
+    std::unique_ptr<SnapshotWatcher> snapshot; // Re-mapped when the file is replaced
+    if (!snapshotPath_.empty()) {
+        snapshot = std::make_unique<SnapshotWatcher>(snapshotPath_, std::chrono::seconds(5), true); // With typo matching
+    }
 
     // Instantiate the services. OnlineBookService is now required by LoanService.
-    OnlineBookService onlineBookService; 
-    RecommenderService recommenderService; // This service is self-contained.
-    LoanService loanService(onlineBookService, loanDbPath); // LoanService needs the online service and its DB path.
+    OnlineBookService onlineBookService(&searchCache, &httpClient, catalog.get());
+    LoanService loanService(onlineBookService, loanDb, {}, snapshot.get()); // LoanService needs the online service and its DB.
 
-    // Instantiate the UI components, passing them the services or DB paths they need.
-    OnlineBookUI  onlineBookUI(readListDbPath);
-    RecommenderUI recommenderUI(readListDbPath);
+    // Instantiate the UI components, passing them the services or databases they need.
+    OnlineBookUI  onlineBookUI(readListDb, &searchCache, &httpClient, catalog.get());
+    RecommenderUI recommenderUI(readListDb, &httpClient);
     LoanUI        loanUI(loanService);
+    onlineBookUI.setSearchMode(searchMode_);
 
     int choice = 0;
     do {
@@ -51,9 +87,13 @@ void MainMenuUI::run() {
             case 3: 
                 loanUI.runMenu(); 
                 break;
-            case 4: 
+            case 4: {
+                auto stats = searchCache.stats();
+                std::cout << "Search cache: " << stats.memoryHits << " memory hits, "
+                          << stats.diskHits << " disk hits, " << stats.misses << " misses.\n";
                 std::cout << "Goodbye!\n"; 
                 break;
+            }
             default:
                 // This case is handled by the validation loop, but good practice to keep.
                 std::cout << "Invalid choice. Please try again.\n";
@@ -1,9 +1,23 @@
 #ifndef MAIN_MENU_UI_H
 #define MAIN_MENU_UI_H
 
+#include "OnlineBookUI.h" // For SearchMode
+#include <string>
+
 class MainMenuUI {
 public:
+    // `searchMode` controls whether book searches use the local read list
+    // (e.g. on kiosks with unreliable connectivity). A non-empty `catalogPath`
+    // names a local catalog (built by catalog_ingest) consulted before Open Library;
+    // a non-empty `snapshotPath` a catalog snapshot used for borrow checks.
+    explicit MainMenuUI(SearchMode searchMode = SearchMode::Online, std::string catalogPath = "",
+                        std::string snapshotPath = "");
     void run();
+
+private:
+    SearchMode searchMode_;
+    std::string catalogPath_;
+    std::string snapshotPath_;
 };
 
 #endif // MAIN_MENU_UI_H
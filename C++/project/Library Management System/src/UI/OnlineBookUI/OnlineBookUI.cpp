@@ -6,8 +6,13 @@
 #include <algorithm> // Required for std::sort and std::unique
 
 // Constructor: Initialize the ReadListDB with the provided database path.
-OnlineBookUI::OnlineBookUI(const std::string& dbPath)
-  : svc_(), db_(dbPath), currentOffset_(0) // Initialize db_ member
+OnlineBookUI::OnlineBookUI(const std::string& dbPath, SearchCache* cache)
+  : svc_(cache), db_(std::make_shared<ReadListDB>(dbPath)), currentOffset_(0) // Open a private connection
+{}
+
+OnlineBookUI::OnlineBookUI(std::shared_ptr<ReadListDB> db, SearchCache* cache, HttpClient* http,
+                           CatalogDB* catalog)
+  : svc_(cache, http, catalog), db_(std::move(db)), currentOffset_(0)
 {}
 
 void OnlineBookUI::run() {
@@ -15,11 +20,20 @@ void OnlineBookUI::run() {
 }
 
 void OnlineBookUI::doSearch() {
+    prefetcher_.cancel(); // Any page prefetched for the previous query is now useless
     currentOffset_ = 0; // Reset offset for a new search
     
     std::cout << "Enter book name: ";
     std::getline(std::cin, currentQuery_); // Store the query
 
+    // Local hits never touch the network; in LocalFirst mode only fall back online
+    // when the read list has nothing for this query.
+    localSession_ = mode_ == SearchMode::OfflineOnly ||
+                    (mode_ == SearchMode::LocalFirst && !db_->searchLocal(currentQuery_, 1).empty());
+    if (localSession_) {
+        std::cout << "(Showing matches from your read list)\n";
+    }
+
     handleSearchResults(); // Call the function to manage search and pagination
 }
 
@@ -48,8 +62,8 @@ void OnlineBookUI::displayResults(const std::vector<OnlineBook>& books) {
         }
 
         // Display Open Library URL
-        if (!b.openLibraryUrl.empty()) {
-            std::cout << "   URL: " << b.openLibraryUrl << "\n";
+        if (!b.workKey.empty()) {
+            std::cout << "   URL: " << b.openLibraryUrl() << "\n";
         }
         std::cout << "\n";
     }
@@ -123,15 +137,21 @@ void OnlineBookUI::promptAndAddBooksToReadList(const std::vector<OnlineBook>& av
             validIndicesToProcess.erase(std::unique(validIndicesToProcess.begin(), validIndicesToProcess.end()), validIndicesToProcess.end());
 
             bool anyAddedSuccessfully = false;
+            db_->beginBatch(); // Several selections are written in one transaction
             for (size_t index : validIndicesToProcess) {
                 const OnlineBook& bookToAdd = availableBooks[index];
-                if (db_.insertBook(bookToAdd)) { // Use the database class to insert
+                if (db_->exists(bookToAdd.workKey)) {
+                    std::cout << "“" << bookToAdd.title << "” is already in your read list.\n";
+                    continue;
+                }
+                if (db_->insertBook(bookToAdd)) { // Use the database class to insert
                     std::cout << "Successfully added “" << bookToAdd.title << "” to read list.\n";
                     anyAddedSuccessfully = true;
                 } else {
                     std::cerr << "Failed to add “" << bookToAdd.title << "” to the database.\n";
                 }
             }
+            db_->commitBatch();
 
             if (anyAddedSuccessfully) {
                 std::cout << "Read list update complete.\n";
@@ -151,7 +171,13 @@ void OnlineBookUI::handleSearchResults() {
     bool continue_pagination_session = true; 
 
     while (continue_pagination_session) {
-        auto results = svc_.search(currentQuery_, limit_, currentOffset_);
+        // Use the page prefetched while the previous one was on screen, if any.
+        std::vector<OnlineBook> results;
+        if (auto prefetched = prefetcher_.take(currentQuery_, currentOffset_)) {
+            results = std::move(*prefetched);
+        } else {
+            results = fetchPage(currentOffset_);
+        }
         
         if (results.empty() && currentOffset_ == 0) {
             std::cout << "No results found for “" << currentQuery_ << "”.\n";
@@ -162,6 +188,13 @@ void OnlineBookUI::handleSearchResults() {
 
         if (results.size() < limit_) {
             std::cout << "--- End of results ---\n";
+        } else if (!localSession_) { // Local pages are instant; nothing to prefetch
+            // A full page means there may be another; start fetching it now.
+            const std::string query = currentQuery_;
+            const size_t nextOffset = currentOffset_ + limit_;
+            prefetcher_.prefetch(query, nextOffset, [this, query, nextOffset](const CancellationToken& token) {
+                return svc_.search(query, limit_, nextOffset, token);
+            });
         }
         
         promptAndAddBooksToReadList(results);
@@ -170,7 +203,9 @@ void OnlineBookUI::handleSearchResults() {
         while (!validChoiceMade) {
             char choice;
             // Changed "(Q)uit" to "(M)ain Menu"
-            std::cout << "\nOptions: (N)ext Page, (S)earch again, (M)ain Menu -> ";
+            const bool canGoOnline = localSession_ && mode_ == SearchMode::LocalFirst;
+            std::cout << "\nOptions: (N)ext Page, (S)earch again, "
+                      << (canGoOnline ? "(O)nline results, " : "") << "(M)ain Menu -> ";
             std::cin >> choice;
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 
@@ -187,8 +222,19 @@ void OnlineBookUI::handleSearchResults() {
                 case 'S':
                     doSearch();
                     return;
+                case 'O':
+                    if (!canGoOnline) {
+                        std::cout << "Invalid choice. Please enter (N), (S), or (M).\n";
+                        break;
+                    }
+                    // Same query, but from Open Library starting at the first page
+                    localSession_ = false;
+                    currentOffset_ = 0;
+                    validChoiceMade = true;
+                    break;
                 case 'M': // Changed from 'Q'
                     // Set flags to exit the loops and return to main menu
+                    prefetcher_.cancel();
                     continue_pagination_session = false;
                     validChoiceMade = true;
                     break;
@@ -198,4 +244,21 @@ void OnlineBookUI::handleSearchResults() {
             }
         }
     }
-}
\ No newline at end of file
+}
+
+std::vector<OnlineBook> OnlineBookUI::fetchPage(size_t offset) {
+    if (localSession_) {
+        return db_->searchLocal(currentQuery_, limit_, offset);
+    }
+    if (auto online = svc_.trySearch(currentQuery_, limit_, offset)) {
+        return *online;
+    }
+    // Open Library is unreachable (or being avoided while its circuit is open):
+    // a new search falls back to the read list instead of showing nothing.
+    if (offset == 0 && !db_->searchLocal(currentQuery_, 1).empty()) {
+        std::cout << "(Open Library is unavailable; showing matches from your read list)\n";
+        localSession_ = true;
+        return db_->searchLocal(currentQuery_, limit_, offset);
+    }
+    return {};
+}
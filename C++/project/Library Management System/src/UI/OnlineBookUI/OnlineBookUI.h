@@ -1,25 +1,50 @@
 #pragma once
 #include "OnlineBookService.h"
 #include "ReadListDB.h" // Include the new database class
+#include "PagePrefetcher.h"
+#include <memory>
 #include <string>
 #include <vector>
 
+// Where book searches are answered from.
+enum class SearchMode {
+    Online,     // Always query Open Library (default)
+    LocalFirst, // Search the saved read list first; fall back to Open Library if nothing matches
+    OfflineOnly // Only ever search the saved read list
+};
+
 class OnlineBookUI {
 public:
-    explicit OnlineBookUI(const std::string& dbPath);
+    // The search cache is optional and shared with other services; it is not owned.
+    explicit OnlineBookUI(const std::string& dbPath, SearchCache* cache = nullptr);
+
+    // Uses an already-open read list shared with the rest of the app (see DatabasePool),
+    // and optionally the app's shared HTTP client and local catalog.
+    explicit OnlineBookUI(std::shared_ptr<ReadListDB> db, SearchCache* cache = nullptr, HttpClient* http = nullptr,
+                          CatalogDB* catalog = nullptr);
     void run();
 
+    void setSearchMode(SearchMode mode) { mode_ = mode; }
+
 private:
     OnlineBookService svc_;
-    ReadListDB db_; // The new database member
+    std::shared_ptr<ReadListDB> db_; // Shared read-list connection
     
     std::string currentQuery_;
     size_t currentOffset_;
     const size_t limit_ = 5;
+    SearchMode mode_ = SearchMode::Online;
+    bool localSession_ = false; // Current query is being answered from the read list
+
+    // Fetches page N+1 while page N is shown. Declared after svc_ so it is
+    // destroyed (and its workers joined) before the service it calls into.
+    PagePrefetcher prefetcher_;
 
     void doSearch();
     void displayResults(const std::vector<OnlineBook>& books);
     // Renamed and modified: This function now handles prompting and validating user input for adding books.
     void promptAndAddBooksToReadList(const std::vector<OnlineBook>& availableBooks);
     void handleSearchResults();
+    // Fetches one page for the current query from the read list or Open Library.
+    std::vector<OnlineBook> fetchPage(size_t offset);
 };
@@ -7,13 +7,17 @@
 #include <cctype>
 
 RecommenderUI::RecommenderUI(const std::string& dbPath)
-  : svc_(), db_(dbPath), currentOffset_(0) {}
+  : svc_(), db_(std::make_shared<ReadListDB>(dbPath)), currentOffset_(0) {}
+
+RecommenderUI::RecommenderUI(std::shared_ptr<ReadListDB> db, HttpClient* http)
+  : svc_(http), db_(std::move(db)), currentOffset_(0) {}
 
 void RecommenderUI::run() {
     selectGenres();
 }
 
 void RecommenderUI::selectGenres() {
+    prefetcher_.cancel(); // The subjects are about to change
     auto available_genres = svc_.getPopularSubjects();
     
     while (true) {
@@ -56,12 +60,28 @@ void RecommenderUI::selectGenres() {
         chosen_genres.erase(std::unique(chosen_genres.begin(), chosen_genres.end()), chosen_genres.end());
         
         currentSubjects_ = chosen_genres;
+        currentMode_ = currentSubjects_.size() > 1 ? askMatchMode() : RecommendMode::AllSubjects;
         handleRecommendations();
         break; // Exit genre selection loop
     }
 }
 
 
+RecommendMode RecommenderUI::askMatchMode() {
+    while (true) {
+        char choice;
+        std::cout << "Books must match (A)ll selected genres, or (O)ne or more of them? ";
+        std::cin >> choice;
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        switch (toupper(choice)) {
+            case 'A': return RecommendMode::AllSubjects;
+            case 'O': return RecommendMode::AnySubject;
+            default:
+                std::cout << "Invalid choice. Please enter 'A' or 'O'.\n";
+        }
+    }
+}
+
 // In src/UI/RecommenderUI/RecommenderUI.cpp
 
 void RecommenderUI::handleRecommendations() {
@@ -75,7 +95,13 @@ void RecommenderUI::handleRecommendations() {
     std::cout << "\n";
 
     while (continue_recommendation_session) {
-        auto recommendations = svc_.recommend(currentSubjects_, limit_, currentOffset_);
+        // Use the page prefetched while the previous one was on screen, if any.
+        std::vector<OnlineBook> recommendations;
+        if (auto prefetched = prefetcher_.take(sessionKey(), currentOffset_)) {
+            recommendations = std::move(*prefetched);
+        } else {
+            recommendations = svc_.recommend(currentSubjects_, limit_, currentOffset_, currentMode_);
+        }
         
         if (recommendations.empty() && currentOffset_ == 0) {
             std::cout << "No recommendations found for the selected combination of genres.\n";
@@ -87,6 +113,15 @@ void RecommenderUI::handleRecommendations() {
         
         if (recommendations.size() < limit_) {
             std::cout << "--- End of results ---\n";
+        } else {
+            // A full page means there may be another; start fetching it now.
+            const std::vector<std::string> subjects = currentSubjects_;
+            const RecommendMode mode = currentMode_;
+            const size_t nextOffset = currentOffset_ + limit_;
+            prefetcher_.prefetch(sessionKey(), nextOffset,
+                                 [this, subjects, mode, nextOffset](const CancellationToken& token) {
+                return svc_.recommend(subjects, limit_, nextOffset, mode, token);
+            });
         }
 
         promptAndAddBooksToReadList(recommendations);
@@ -113,6 +148,7 @@ void RecommenderUI::handleRecommendations() {
                     return; 
                 case 'M': // Changed from 'Q'
                     // Set flags to exit both the inner and outer loops of this function
+                    prefetcher_.cancel();
                     continue_recommendation_session = false;
                     validChoiceMade = true;
                     break;
@@ -124,6 +160,14 @@ void RecommenderUI::handleRecommendations() {
     }
 }
 
+std::string RecommenderUI::sessionKey() const {
+    std::string key = currentMode_ == RecommendMode::AnySubject ? "any\n" : "all\n";
+    for (const auto& subject : currentSubjects_) {
+        key += subject + '\n'; // Subject names never contain newlines
+    }
+    return key;
+}
+
 void RecommenderUI::displayRecommendations(const std::vector<OnlineBook>& books) {
     if (books.empty()) {
         std::cout << "No more recommendations found.\n";
@@ -144,8 +188,8 @@ void RecommenderUI::displayRecommendations(const std::vector<OnlineBook>& books)
             }
             std::cout << "\n";
         }
-        if (!b.openLibraryUrl.empty()) {
-            std::cout << "   URL: " << b.openLibraryUrl << "\n";
+        if (!b.workKey.empty()) {
+            std::cout << "   URL: " << b.openLibraryUrl() << "\n";
         }
         std::cout << "\n";
     }
@@ -196,15 +240,21 @@ void RecommenderUI::promptAndAddBooksToReadList(const std::vector<OnlineBook>& a
         validIndices.erase(std::unique(validIndices.begin(), validIndices.end()), validIndices.end());
         
         bool anyAdded = false;
+        db_->beginBatch(); // Several selections are written in one transaction
         for (size_t index : validIndices) {
             const OnlineBook& bookToAdd = availableBooks[index];
-            if (db_.insertBook(bookToAdd)) {
+            if (db_->exists(bookToAdd.workKey)) {
+                std::cout << "“" << bookToAdd.title << "” is already in your read list.\n";
+                continue;
+            }
+            if (db_->insertBook(bookToAdd)) {
                 std::cout << "Successfully added “" << bookToAdd.title << "” to read list.\n";
                 anyAdded = true;
             } else {
                 std::cerr << "Failed to add “" << bookToAdd.title << "” to the database.\n";
             }
         }
+        db_->commitBatch();
 
         if (anyAdded) {
             std::cout << "Read list update complete.\n";
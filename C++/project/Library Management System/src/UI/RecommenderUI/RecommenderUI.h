@@ -3,23 +3,38 @@
 
 #include "RecommenderService.h"
 #include "ReadListDB.h" // For adding books to the database
+#include "PagePrefetcher.h"
+#include <memory>
 #include <string>
 #include <vector>
 
 class RecommenderUI {
 public:
     explicit RecommenderUI(const std::string& dbPath);
+
+    // Uses an already-open read list shared with the rest of the app (see DatabasePool),
+    // and optionally the app's shared HTTP client.
+    explicit RecommenderUI(std::shared_ptr<ReadListDB> db, HttpClient* http = nullptr);
     void run();
 
 private:
     RecommenderService svc_;
-    ReadListDB db_;
+    std::shared_ptr<ReadListDB> db_; // Shared read-list connection
 
     std::vector<std::string> currentSubjects_;
+    RecommendMode currentMode_ = RecommendMode::AllSubjects;
     size_t currentOffset_;
     const size_t limit_ = 5;
 
+    // Fetches page N+1 while page N is shown; declared after svc_ (see OnlineBookUI).
+    PagePrefetcher prefetcher_;
+
+    // Identifies the current subject selection for the prefetcher.
+    std::string sessionKey() const;
+
     void selectGenres();
+    // With several genres chosen, asks whether books must match all of them or any.
+    RecommendMode askMatchMode();
     void handleRecommendations();
     void displayRecommendations(const std::vector<OnlineBook>& books);
     void promptAndAddBooksToReadList(const std::vector<OnlineBook>& availableBooks);
@@ -0,0 +1,79 @@
+#include "DumpIngester.h"
+#include "CatalogDB.h"
+#include "CatalogSnapshot.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Builds a local catalog for `library_app --catalog` from Open Library data dumps
+// (https://openlibrary.org/developers/dumps), e.g.
+//   catalog_ingest data/catalog.db ol_dump_authors_latest.txt.gz ol_dump_works_latest.txt.gz
+// With --snapshot FILE it then writes a snapshot of the catalog for
+// `library_app --snapshot` (dumps may be omitted to only re-export).
+int main(int argc, char* argv[]) {
+    std::string catalogPath;
+    std::vector<std::string> dumps;
+    IngestOptions options;
+    std::string snapshotPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc && std::atoi(argv[i + 1]) > 0) {
+            options.parserThreads = static_cast<size_t>(std::atoi(argv[++i]));
+        } else if (arg == "--snapshot" && i + 1 < argc) {
+            snapshotPath = argv[++i];
+        } else if (!arg.empty() && arg[0] != '-' && catalogPath.empty()) {
+            catalogPath = arg;
+        } else if (!arg.empty() && arg[0] != '-') {
+            dumps.push_back(arg);
+        } else {
+            catalogPath.clear();
+            break;
+        }
+    }
+    if (catalogPath.empty() || (dumps.empty() && snapshotPath.empty())) {
+        std::cerr << "Usage: catalog_ingest CATALOG.db DUMP[.gz]... [--threads N] [--snapshot FILE]\n";
+        return 1;
+    }
+
+    options.onProgress = [](const IngestStats& s) {
+        std::cerr << "  " << s.works << " works, " << s.authors << " authors ("
+                  << static_cast<uint64_t>((s.works + s.authors) / (s.seconds > 0 ? s.seconds : 1)) << " rows/s)\n";
+    };
+
+    int status = 0;
+    if (!dumps.empty()) {
+        DumpIngester ingester(catalogPath, options);
+        if (!ingester.ok()) {
+            std::cerr << "Error: Cannot open catalog '" << catalogPath << "'\n";
+            return 1;
+        }
+        for (const auto& dump : dumps) {
+            std::cerr << "Ingesting " << dump << "\n";
+            const IngestStats s = ingester.ingestFile(dump);
+            std::cerr << dump << ": " << s.lines << " lines, " << s.works << " works, " << s.authors << " authors, "
+                      << s.skipped << " skipped, " << s.malformed << " malformed, " << s.seconds << " s\n";
+            if (!s.error.empty()) {
+                std::cerr << "Error: " << s.error << "\n";
+                status = 2;
+            }
+        }
+        std::cerr << "Indexing...\n";
+        if (!ingester.finish()) {
+            return 2;
+        }
+    }
+
+    CatalogDB catalog(catalogPath);
+    std::cerr << "Catalog has " << catalog.countWorks() << " works\n";
+
+    if (!snapshotPath.empty()) {
+        std::string error;
+        if (!CatalogSnapshot::write(snapshotPath, catalog.allWorks(), error)) {
+            std::cerr << "Error: " << error << "\n";
+            return 2;
+        }
+        std::cerr << "Snapshot written to " << snapshotPath << "\n";
+    }
+    return status;
+}
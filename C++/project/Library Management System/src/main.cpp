@@ -1,6 +1,154 @@
-#include <MainMenuUI.h>
-
-int main() {
-    MainMenuUI().run();
-    return 0;
-}
+#include <MainMenuUI.h>
+#include "BatchRunner.h"
+#include "OnlineBookService.h"
+#include "RecommenderService.h"
+#include "LoanService.h"
+#include "SearchCache.h"
+#include "DatabasePool.h"
+#include "HttpClient.h"
+#include "CatalogDB.h"
+#include "CatalogSnapshot.h"
+#include "Metrics.h"
+#include "MetricsDumper.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+// Headless mode: runs NDJSON commands from `inputPath` ("-" = stdin) and writes
+// one JSON result line per command to stdout. Uses the same files as the menus.
+// `rateLimit` caps requests per second to Open Library (0 = no limit); a
+// non-empty `catalogPath` is searched before Open Library, and a non-empty
+// `snapshotPath` answers borrow checks.
+static int runBatch(const std::string& inputPath, const BatchOptions& options, const RateLimitOptions& rateLimit,
+                    const std::string& catalogPath, const std::string& snapshotPath) {
+    // LoanService still reports refused borrows on std::cout (the logger already
+    // writes to stderr); send those to stderr so stdout carries nothing but result lines.
+    std::ostream results(std::cout.rdbuf());
+    std::streambuf* savedCout = std::cout.rdbuf(std::cerr.rdbuf());
+
+    std::ifstream file;
+    if (inputPath != "-") {
+        file.open(inputPath);
+        if (!file) {
+            std::cerr << "Error: Cannot open batch file '" << inputPath << "'\n";
+            std::cout.rdbuf(savedCout);
+            return 1;
+        }
+    }
+    std::istream& input = inputPath == "-" ? std::cin : file;
+
+    int status = 0;
+    {
+        HttpClientOptions httpOptions;
+        httpOptions.maxIdleSessions = options.workers; // One warm connection per worker
+        httpOptions.rateLimit = rateLimit;
+        HttpClient httpClient(httpOptions);
+        SearchCache searchCache("data/search_cache.db");
+        DatabasePool databasePool;
+        std::unique_ptr<CatalogDB> catalog;
+        if (!catalogPath.empty()) {
+            catalog = std::make_unique<CatalogDB>(catalogPath);
+        }
+        std::unique_ptr<SnapshotWatcher> snapshot;
+        if (!snapshotPath.empty()) {
+            snapshot = std::make_unique<SnapshotWatcher>(snapshotPath, std::chrono::seconds(5), true); // With typo matching
+        }
+
+        OnlineBookService onlineBookService(&searchCache, &httpClient, catalog.get());
+        RecommenderService recommenderService(&httpClient);
+        LoanService loanService(onlineBookService, databasePool.loanRequests("data/test_loan_requests.db"), {},
+                                snapshot.get());
+        BatchRunner runner(onlineBookService, recommenderService, loanService,
+                           databasePool.readList("data/test_readlist.db"), options);
+
+        const auto start = std::chrono::steady_clock::now();
+        const BatchStats stats = runner.run(input, results);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cerr << "Batch: " << stats.commands << " commands, " << stats.failed << " failed, "
+                  << elapsed.count() << " s\n";
+        for (size_t i = 0; i < kStageCount; ++i) {
+            const LatencySnapshot latency = metrics::snapshot(static_cast<Stage>(i));
+            if (latency.count == 0) continue;
+            std::cerr << "  " << stageName(static_cast<Stage>(i)) << ": " << latency.count << " calls, p50 "
+                      << latency.quantileNs(0.5) / 1e6 << " ms, p99 " << latency.quantileNs(0.99) / 1e6 << " ms\n";
+        }
+        status = stats.failed == 0 ? 0 : 2;
+    }
+    std::cout.rdbuf(savedCout);
+    return status;
+}
+
+static void printUsage() {
+    std::cerr << "Usage: library_app [--local-first | --offline] [--catalog FILE] [--snapshot FILE] [--metrics FILE]\n"
+              << "       library_app --batch [FILE] [--workers N] [--rate R] [--catalog FILE] [--snapshot FILE]\n"
+              << "                   [--metrics FILE]\n";
+}
+
+int main(int argc, char* argv[]) {
+    // --local-first: answer searches from the saved read list when it has matches
+    // --offline:     never contact Open Library for searches
+    // --batch [FILE]: headless; run NDJSON commands from FILE (default: stdin)
+    // --workers N:   commands run at once in batch mode
+    // --rate R:      Open Library requests per second in batch mode (0 = unlimited)
+    // --metrics FILE: write latency metrics (Prometheus text) to FILE on SIGUSR1 and at exit
+    // --catalog FILE: answer searches and borrow checks from a local catalog (see catalog_ingest) when it matches
+    // --snapshot FILE: answer borrow checks from a mapped catalog snapshot, reloaded when the file is replaced
+    SearchMode searchMode = SearchMode::Online;
+    bool batch = false;
+    std::string batchInput = "-";
+    BatchOptions batchOptions;
+    RateLimitOptions rateLimit;
+    std::string metricsPath;
+    std::string catalogPath;
+    std::string snapshotPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--local-first") {
+            searchMode = SearchMode::LocalFirst;
+        } else if (arg == "--offline") {
+            searchMode = SearchMode::OfflineOnly;
+        } else if (arg == "--batch") {
+            batch = true;
+            if (i + 1 < argc && (argv[i + 1][0] != '-' || std::string(argv[i + 1]) == "-")) {
+                batchInput = argv[++i];
+            }
+        } else if (arg == "--workers" && i + 1 < argc && std::atoi(argv[i + 1]) > 0) {
+            batchOptions.workers = static_cast<size_t>(std::atoi(argv[++i]));
+        } else if (arg == "--rate" && i + 1 < argc && std::atof(argv[i + 1]) >= 0) {
+            rateLimit.requestsPerSecond = std::atof(argv[++i]);
+            rateLimit.burst = std::max(rateLimit.burst, rateLimit.requestsPerSecond);
+        } else if (arg == "--metrics" && i + 1 < argc) {
+            metricsPath = argv[++i];
+        } else if (arg == "--catalog" && i + 1 < argc) {
+            catalogPath = argv[++i];
+        } else if (arg == "--snapshot" && i + 1 < argc) {
+            snapshotPath = argv[++i];
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+    if (batch && searchMode != SearchMode::Online) {
+        // The read-list search modes live in the search menu; batch searches
+        // would silently take a different path than the flag asks for.
+        std::cerr << "--local-first and --offline apply to the menus only, not to --batch\n";
+        printUsage();
+        return 1;
+    }
+
+    std::unique_ptr<MetricsDumper> metricsDumper;
+    if (!metricsPath.empty()) {
+        metricsDumper = std::make_unique<MetricsDumper>(metricsPath);
+    }
+
+    if (batch) {
+        return runBatch(batchInput, batchOptions, rateLimit, catalogPath, snapshotPath);
+    }
+    MainMenuUI(searchMode, catalogPath, snapshotPath).run();
+    return 0;
+}
@@ -0,0 +1,216 @@
+#include "OnlineBookService.h"     // Include the services whose async calls you want to test
+#include "RecommenderService.h"
+#include "LoanService.h"
+#include "HttpClient.h"
+#include "SingleFlight.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>                  // For std::remove
+#include <filesystem>              // For creating the data folder
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Define DATA_DIR macro if it's not picked up from CMake for standalone test
+#ifndef DATA_DIR
+#define DATA_DIR "data"
+#endif
+
+// Helper function to print a test status
+static bool printTestStatus(const std::string& testName, bool passed) {
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << std::endl;
+    return passed;
+}
+
+// A local port that accepts connections but never answers, so every request
+// to it hangs until its timeout: a stand-in for a stalled Open Library.
+class SilentServer {
+public:
+    SilentServer() {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        listen(fd_, 64);
+        socklen_t len = sizeof(addr);
+        getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+
+        // Accept (and count) connections, then leave them hanging.
+        acceptor_ = std::thread([this]() {
+            int client;
+            while ((client = accept(fd_, nullptr, nullptr)) >= 0) {
+                clients_.push_back(client);
+                ++connections_;
+            }
+        });
+    }
+    ~SilentServer() {
+        shutdown(fd_, SHUT_RDWR); // Wakes the blocked accept()
+        acceptor_.join();
+        close(fd_);
+        for (int client : clients_) close(client);
+    }
+
+    std::string baseUrl() const { return "http://127.0.0.1:" + std::to_string(port_); }
+    int connections() const { return connections_.load(); }
+
+private:
+    int fd_ = -1;
+    unsigned short port_ = 0;
+    std::thread acceptor_;
+    std::vector<int> clients_; // Only touched by acceptor_ until it is joined
+    std::atomic<int> connections_{0};
+};
+
+// True if waiting on `future` throws OperationCancelled.
+template <class T>
+static bool throwsCancelled(std::future<T>& future) {
+    try {
+        future.get();
+    } catch (const OperationCancelled&) {
+        return true;
+    }
+    return false;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    std::cout << "--- Running Automated Async Service Tests ---\n\n";
+    bool allPassed = true;
+
+    // Test Case 1: Copies share cancellation; timeouts cancel on their own
+    {
+        CancellationToken token;
+        CancellationToken copy = token;
+        const bool freshOk = !token.cancelled() && !token.remaining();
+        copy.cancel();
+        auto timed = CancellationToken::withTimeout(std::chrono::milliseconds(20));
+        const bool liveBefore = !timed.cancelled() && timed.remaining()->count() > 0;
+        std::this_thread::sleep_for(std::chrono::milliseconds(40));
+        allPassed &= printTestStatus("Test 1: Token sharing and deadlines",
+            freshOk && token.cancelled() && liveBefore && timed.cancelled() && timed.remaining()->count() == 0);
+    }
+
+    SilentServer server;
+    HttpClientOptions options;
+    options.baseUrl = server.baseUrl();
+    options.http2 = false;
+    HttpClient http(options); // requestTimeout stays at 10 s: only deadlines end requests early
+    OnlineBookService onlineSvc(nullptr, &http);
+
+    // Test Case 2: An already-cancelled call sends nothing and fails fast
+    {
+        CancellationToken token;
+        token.cancel();
+        auto start = std::chrono::steady_clock::now();
+        auto future = onlineSvc.searchAsync("dune", 5, 0, token);
+        allPassed &= printTestStatus("Test 2: Pre-cancelled search",
+            throwsCancelled(future) && secondsSince(start) < 0.5);
+    }
+
+    // Test Case 3: A deadline cuts a stalled request short
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto future = onlineSvc.searchAsync("dune", 5, 0, CancellationToken::withTimeout(std::chrono::milliseconds(200)));
+        const bool cancelled = throwsCancelled(future);
+        const double elapsed = secondsSince(start);
+        allPassed &= printTestStatus("Test 3: Deadline on a stalled search", cancelled && elapsed < 2.0);
+    }
+
+    // Test Case 4: Concurrent calls wait side by side on the shared executor,
+    // so eight stalled searches take about one deadline, not eight
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::future<std::vector<OnlineBook>>> futures;
+        for (int i = 0; i < 8; ++i) {
+            futures.push_back(onlineSvc.searchAsync("query " + std::to_string(i), 5, 0,
+                                                    CancellationToken::withTimeout(std::chrono::milliseconds(300))));
+        }
+        bool allCancelled = true;
+        for (auto& f : futures) allCancelled &= throwsCancelled(f);
+        const double elapsed = secondsSince(start);
+        allPassed &= printTestStatus("Test 4: Concurrent searches overlap", allCancelled && elapsed < 1.5);
+    }
+
+    // Test Case 5: An AnySubject fan-out shares one deadline across sub-requests
+    {
+        RecommenderService recommender(&http);
+        auto start = std::chrono::steady_clock::now();
+        auto future = recommender.recommendAsync({"Fantasy", "Horror", "Science"}, 5, 0, RecommendMode::AnySubject,
+                                                 CancellationToken::withTimeout(std::chrono::milliseconds(200)));
+        allPassed &= printTestStatus("Test 5: Deadline on a recommendation fan-out",
+            throwsCancelled(future) && secondsSince(start) < 2.0);
+    }
+
+    // Test Case 6: A cancelled borrow saves nothing
+    {
+        std::filesystem::create_directories(DATA_DIR);
+        const std::string dbPath = DATA_DIR "/test_async_loans.db";
+        std::remove(dbPath.c_str());
+        auto loanDb = std::make_shared<LoanRequestDB>(dbPath);
+        LoanService loanSvc(onlineSvc, loanDb);
+        auto future = loanSvc.borrowBookAsync("Dune", CancellationToken::withTimeout(std::chrono::milliseconds(100)));
+        allPassed &= printTestStatus("Test 6: Cancelled borrow is not saved",
+            throwsCancelled(future) && loanDb->getActiveLoans(10).loans.empty());
+    }
+
+    // Test Case 7: Overlapping calls for one key run the work once and share its value
+    {
+        SingleFlight<std::string, int> flight;
+        std::atomic<int> calls{0};
+        std::vector<std::thread> threads;
+        std::vector<int> values(8, 0);
+        for (int i = 0; i < 8; ++i) {
+            threads.emplace_back([&, i]() {
+                values[i] = flight.run("dune", CancellationToken(), [&]() {
+                    ++calls;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                    return 42;
+                });
+            });
+        }
+        for (auto& t : threads) t.join();
+        bool allSame = true;
+        for (int v : values) allSame &= v == 42;
+        const int later = flight.run("dune", CancellationToken(), [&]() { ++calls; return 7; });
+        allPassed &= printTestStatus("Test 7: Single-flight coalescing",
+            calls == 2 && allSame && flight.coalesced() == 7 && later == 7);
+    }
+
+    // Test Case 8: Identical concurrent searches share one request, and each
+    // waiter still gives up at its own deadline
+    {
+        SilentServer quiet;
+        HttpClientOptions quietOptions;
+        quietOptions.baseUrl = quiet.baseUrl();
+        quietOptions.http2 = false;
+        HttpClient quietHttp(quietOptions);
+        OnlineBookService shared(nullptr, &quietHttp);
+
+        auto leader = shared.searchAsync("dune", 5, 0, CancellationToken::withTimeout(std::chrono::milliseconds(500)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50)); // Let the leader's request go out first
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::future<std::vector<OnlineBook>>> waiters;
+        for (int i = 0; i < 6; ++i) {
+            waiters.push_back(shared.searchAsync(" dune ", 5, 0, CancellationToken::withTimeout(std::chrono::milliseconds(150))));
+        }
+        bool waitersCancelled = true;
+        for (auto& f : waiters) waitersCancelled &= throwsCancelled(f);
+        const double waited = secondsSince(start);
+        allPassed &= printTestStatus("Test 8: Concurrent identical searches coalesce",
+            waitersCancelled && waited < 0.4 && throwsCancelled(leader) && quiet.connections() == 1);
+    }
+
+    std::cout << "\n--- Automated Async Service Tests Complete ---\n";
+    return allPassed ? 0 : 1;
+}
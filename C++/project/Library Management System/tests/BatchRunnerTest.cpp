@@ -0,0 +1,109 @@
+#include "BatchRunner.h"            // Include the runner you want to test
+#include "OnlineBookService.h"
+#include "RecommenderService.h"
+#include "LoanService.h"
+#include "ReadListDB.h"
+#include "HttpClient.h"
+#include <cstdio>                   // For std::remove
+#include <filesystem>               // For creating the data folder
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+
+// Define DATA_DIR macro if it's not picked up from CMake for standalone test
+#ifndef DATA_DIR
+#define DATA_DIR "data"
+#endif
+
+using json = nlohmann::json;
+
+// Helper function to print a test status
+static bool printTestStatus(const std::string& testName, bool passed) {
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << std::endl;
+    return passed;
+}
+
+static std::string addCommand(int n) {
+    json book = {{"title", "Book " + std::to_string(n)}, {"author", "Author"}, {"workKey", "OL" + std::to_string(n) + "W"},
+                 {"subjects", {"Fantasy"}}};
+    return json{{"id", n}, {"op", "addToReadList"}, {"book", book}}.dump();
+}
+
+int main() {
+    std::cout << "--- Running Automated BatchRunner Tests ---\n\n";
+    bool allPassed = true;
+
+    std::filesystem::create_directories(DATA_DIR);
+    const std::string readListPath = DATA_DIR "/test_batch_readlist.db";
+    const std::string loanPath = DATA_DIR "/test_batch_loans.db";
+    std::remove(readListPath.c_str()); // Start from empty databases
+    std::remove(loanPath.c_str());
+
+    // Nothing listens on port 1, so every network call fails at once.
+    HttpClientOptions httpOptions;
+    httpOptions.baseUrl = "http://127.0.0.1:1";
+    httpOptions.http2 = false;
+    HttpClient http(httpOptions);
+    OnlineBookService onlineSvc(nullptr, &http);
+    RecommenderService recommender(&http);
+    LoanService loans(onlineSvc, loanPath);
+    auto readList = std::make_shared<ReadListDB>(readListPath);
+
+    BatchOptions options;
+    options.workers = 4;
+    options.maxQueued = 3; // Smaller than the input, so reading has to wait for workers
+    BatchRunner runner(onlineSvc, recommender, loans, readList, options);
+
+    // Test Case 1: addToReadList saves a book once and echoes the id
+    json first = runner.execute(json::parse(addCommand(1)));
+    json again = runner.execute(json::parse(addCommand(1)));
+    allPassed &= printTestStatus("Test 1: Add to read list",
+        first["ok"] == true && first["id"] == 1 && first["result"]["added"] == true &&
+        again["ok"] == true && again["result"]["added"] == false && readList->countBooks() == 1);
+
+    // Test Case 2: Bad commands are answered with an error, not dropped
+    json unknown = runner.execute({{"op", "renew"}});
+    json missing = runner.execute({{"op", "borrow"}});
+    json notObject = runner.execute(json::array());
+    allPassed &= printTestStatus("Test 2: Invalid commands",
+        unknown["ok"] == false && unknown["error"] == "unknown op \"renew\"" &&
+        missing["ok"] == false && notObject["ok"] == false);
+
+    // Test Case 3: A command past its deadline fails as such
+    json late = runner.execute({{"op", "search"}, {"query", "dune"}, {"timeoutMs", 0}});
+    allPassed &= printTestStatus("Test 3: Per-command deadline",
+        late["ok"] == false && late["error"] == "deadline exceeded");
+
+    // Test Case 4: Network failures still produce well-formed answers
+    json borrow = runner.execute({{"op", "borrow"}, {"title", "Dune"}});
+    json recommend = runner.execute({{"op", "recommend"}, {"subjects", {"Fantasy", "Horror"}}, {"mode", "any"}});
+    json badMode = runner.execute({{"op", "recommend"}, {"subjects", {"Fantasy"}}, {"mode", "some"}});
+    allPassed &= printTestStatus("Test 4: Offline borrow and recommend",
+        borrow["ok"] == true && borrow["result"]["borrowed"] == false &&
+        recommend["ok"] == true && recommend["result"].empty() && badMode["ok"] == false);
+
+    // Test Case 5: run() answers every non-blank line exactly once, on a worker pool
+    std::stringstream input;
+    for (int n = 2; n <= 41; ++n) {
+        input << addCommand(n) << "\n";
+        if (n == 20) input << "\n{not json\n"; // A blank line (skipped) and a malformed one
+    }
+    std::stringstream output;
+    BatchStats stats = runner.run(input, output);
+
+    std::set<size_t> lines;
+    std::string line;
+    bool wellFormed = true;
+    while (std::getline(output, line)) {
+        json response = json::parse(line, nullptr, false);
+        wellFormed &= !response.is_discarded() && response.contains("line");
+        if (wellFormed) lines.insert(response["line"].get<size_t>());
+    }
+    allPassed &= printTestStatus("Test 5: Streaming run over a worker pool",
+        wellFormed && stats.commands == 41 && stats.failed == 1 && lines.size() == 41 &&
+        readList->countBooks() == 41);
+
+    std::cout << "\n--- Automated BatchRunner Tests Complete ---\n";
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+#include "CatalogExistenceCache.h"  // Include the cache you want to test
+#include "LoanService.h"
+#include "SearchCache.h"
+#include "HttpClient.h"
+#include <chrono>
+#include <cstdio>                   // For std::remove
+#include <filesystem>               // For creating the data folder
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Define DATA_DIR macro if it's not picked up from CMake for standalone test
+#ifndef DATA_DIR
+#define DATA_DIR "data"
+#endif
+
+using Status = CatalogExistenceCache::Status;
+
+// Helper function to print a test status
+static bool printTestStatus(const std::string& testName, bool passed) {
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << std::endl;
+    return passed;
+}
+
+int main() {
+    std::cout << "--- Running Automated CatalogExistenceCache Tests ---\n\n";
+    bool allPassed = true;
+
+    // Test Case 1: Titles are keyed trimmed and lowercased
+    allPassed &= printTestStatus("Test 1: Title normalization",
+        CatalogExistenceCache::normalize("  The Hobbit\n") == "the hobbit");
+
+    // Test Case 2: Missing and found titles are remembered, whatever their spelling case
+    {
+        CatalogExistenceCache cache;
+        const bool unknownFirst = cache.lookup("NonExistentBookXYZ123") == Status::Unknown;
+        cache.recordMissing("NonExistentBookXYZ123");
+        cache.recordFound("The Hobbit");
+        allPassed &= printTestStatus("Test 2: Found and missing titles",
+            unknownFirst && cache.lookup(" nonexistentbookxyz123 ") == Status::Missing &&
+            cache.lookup("THE HOBBIT") == Status::Found && cache.stats().missingHits == 1 &&
+            cache.stats().foundHits == 1 && cache.stats().misses == 1);
+
+        // Test Case 3: A later answer replaces an earlier one
+        cache.recordFound("NonExistentBookXYZ123");
+        allPassed &= printTestStatus("Test 3: Found overrides missing",
+            cache.lookup("NonExistentBookXYZ123") == Status::Found);
+    }
+
+    // Test Case 4: Missing titles expire after their (shorter) TTL
+    {
+        CatalogCacheOptions options;
+        options.missingTtl = std::chrono::milliseconds(30);
+        CatalogExistenceCache cache(options);
+        cache.recordMissing("Dune II");
+        cache.recordFound("Dune");
+        const bool freshHit = cache.lookup("Dune II") == Status::Missing;
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+        allPassed &= printTestStatus("Test 4: Missing entries expire",
+            freshHit && cache.lookup("Dune II") == Status::Unknown && cache.lookup("Dune") == Status::Found);
+    }
+
+    // Test Case 5: Over capacity, the oldest titles are dropped first
+    {
+        CatalogCacheOptions options;
+        options.capacity = 4;
+        CatalogExistenceCache cache(options);
+        for (int i = 0; i < 6; ++i) {
+            cache.recordMissing("title " + std::to_string(i));
+        }
+        allPassed &= printTestStatus("Test 5: Capacity bound",
+            cache.lookup("title 0") == Status::Unknown && cache.lookup("title 1") == Status::Unknown &&
+            cache.lookup("title 2") == Status::Missing && cache.lookup("title 5") == Status::Missing);
+    }
+
+    // Test Case 6: The Bloom filter never misses a key and rarely claims others
+    {
+        BloomFilter filter(1000);
+        bool noFalseNegatives = true;
+        for (int i = 0; i < 1000; ++i) {
+            filter.add("missing " + std::to_string(i));
+        }
+        for (int i = 0; i < 1000; ++i) {
+            noFalseNegatives &= filter.mightContain("missing " + std::to_string(i));
+        }
+        int falsePositives = 0;
+        for (int i = 0; i < 10000; ++i) {
+            falsePositives += filter.mightContain("other " + std::to_string(i));
+        }
+        allPassed &= printTestStatus("Test 6: Bloom filter accuracy",
+            noFalseNegatives && falsePositives < 300); // ~1% expected, 3% allowed
+    }
+
+    // Test Case 7: LoanService asks the catalog once per title, and never caches a failed request
+    {
+        // Catalog answers come from a pre-filled search cache; the network is unreachable.
+        SearchCache searchCache("");
+        OnlineBook dune;
+        dune.title = "Dune";
+        dune.workKey = "OL893415W";
+        searchCache.put(SearchCache::makeKey("Dune", 1, 0), {dune});
+        searchCache.put(SearchCache::makeKey("NonExistentBookXYZ123", 1, 0), {});
+
+        HttpClientOptions httpOptions;
+        httpOptions.baseUrl = "http://127.0.0.1:1";
+        HttpClient http(httpOptions);
+        OnlineBookService onlineSvc(&searchCache, &http);
+
+        std::filesystem::create_directories(DATA_DIR);
+        const std::string loanDbPath = DATA_DIR "/test_catalog_cache_loans.db";
+        std::remove(loanDbPath.c_str());
+        LoanService loans(onlineSvc, loanDbPath);
+
+        const bool borrowed = loans.borrowBook("Dune") && loans.borrowBook(" dune ");
+        const bool refused = !loans.borrowBook("NonExistentBookXYZ123") && !loans.borrowBook("nonexistentbookxyz123");
+        const bool unreachable = !loans.borrowBook("Emma") && !loans.borrowBook("Emma");
+        auto stats = loans.catalogCacheStats();
+        allPassed &= printTestStatus("Test 7: Borrow checks use the cache",
+            borrowed && refused && unreachable && stats.foundHits == 1 && stats.missingHits == 1 &&
+            stats.misses == 4 && searchCache.stats().memoryHits == 2);
+    }
+
+    std::cout << "\n--- Automated CatalogExistenceCache Tests Complete ---\n";
+    return allPassed ? 0 : 1;
+}
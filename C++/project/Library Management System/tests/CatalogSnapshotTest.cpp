@@ -0,0 +1,117 @@
+#include "CatalogSnapshot.h"  // Include the snapshot you want to test
+#include "LoanService.h"
+#include "HttpClient.h"
+#include <chrono>
+#include <cstdio>             // For std::remove
+#include <filesystem>         // For creating the data folder
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Define DATA_DIR macro if it's not picked up from CMake for standalone test
+#ifndef DATA_DIR
+#define DATA_DIR "data"
+#endif
+
+// Helper function to print a test status
+static bool printTestStatus(const std::string& testName, bool passed) {
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << std::endl;
+    return passed;
+}
+
+static OnlineBook makeBook(const std::string& title, const std::string& author, const std::string& workKey) {
+    OnlineBook b;
+    b.title = title;
+    b.author = author;
+    b.publishYear = "1937";
+    b.workKey = workKey;
+    b.coverId = 42;
+    return b;
+}
+
+int main() {
+    std::cout << "--- Running Automated CatalogSnapshot Tests ---\n\n";
+    bool allPassed = true;
+    std::filesystem::create_directories(DATA_DIR);
+    const std::string path = DATA_DIR "/test_catalog.snapshot";
+    std::remove(path.c_str());
+
+    const std::vector<OnlineBook> books = {
+        makeBook("The Hobbit", "J.R.R. Tolkien", "OL27482W"),
+        makeBook("Dune", "Frank Herbert", "OL893415W"),
+        makeBook("  the hobbit ", "Someone Else", "OL1W"), // Same normalized title: the first one wins
+        makeBook("Emma", "", "OL66554W"),
+        makeBook("   ", "Nobody", "OL2W"),                  // No title: left out
+    };
+    std::string error;
+
+    // Test Case 1: Write, map and look up, whatever the case and surrounding spaces
+    {
+        const bool written = CatalogSnapshot::write(path, books, error);
+        auto snapshot = CatalogSnapshot::open(path, error);
+        auto hobbit = snapshot ? snapshot->find(" THE HOBBIT\n") : std::nullopt;
+        allPassed &= printTestStatus("Test 1: Find by normalized title",
+            written && snapshot && snapshot->size() == 3 && hobbit && hobbit->title == "The Hobbit" &&
+            hobbit->author == "J.R.R. Tolkien" && hobbit->workKey == "OL27482W" && hobbit->coverId == 42 &&
+            snapshot->contains("dune") && snapshot->contains("Emma"));
+
+        // Test Case 2: Titles that are absent, prefixes of present ones, or empty
+        allPassed &= printTestStatus("Test 2: Misses",
+            !snapshot->contains("The Hobbi") && !snapshot->contains("The Hobbit 2") &&
+            !snapshot->contains("Aardvark") && !snapshot->contains("Zebra") && !snapshot->contains("  "));
+
+        // Test Case 3: Conversion fills the usual defaults
+        OnlineBook emma = snapshot->find("emma")->toOnlineBook();
+        allPassed &= printTestStatus("Test 3: Convert to OnlineBook",
+            emma.title == "Emma" && emma.author == "Unknown Author" && emma.workKey == "OL66554W");
+    }
+
+    // Test Case 4: Files that are missing, not snapshots, or cut short are refused
+    {
+        const std::string bad = DATA_DIR "/test_bad.snapshot";
+        { std::ofstream(bad) << "definitely not a snapshot file"; }
+        const bool notSnapshot = !CatalogSnapshot::open(bad, error);
+        std::filesystem::copy_file(path, bad, std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::resize_file(bad, std::filesystem::file_size(path) - 1);
+        const bool truncated = !CatalogSnapshot::open(bad, error) && error.find("truncated") != std::string::npos;
+        allPassed &= printTestStatus("Test 4: Reject bad files",
+            !CatalogSnapshot::open(DATA_DIR "/no_such.snapshot", error) && notSnapshot && truncated);
+        std::remove(bad.c_str());
+    }
+
+    // Test Case 5: A replaced file is swapped in; lookups holding the old one keep working
+    {
+        SnapshotWatcher watcher(path, std::chrono::hours(1)); // Reloads driven by hand below
+        auto before = watcher.current();
+        const bool unchanged = !watcher.reloadIfChanged();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20)); // A distinct modification time
+        CatalogSnapshot::write(path, {makeBook("Neuromancer", "William Gibson", "OL27258W")}, error);
+        const bool swapped = watcher.reloadIfChanged();
+        auto after = watcher.current();
+        allPassed &= printTestStatus("Test 5: Hot swap",
+            before && unchanged && swapped && watcher.loads() == 2 && after->contains("neuromancer") &&
+            !after->contains("dune") && before->find("dune")->author == "Frank Herbert");
+    }
+
+    // Test Case 6: Borrow checks answered by the snapshot; the network is unreachable
+    {
+        SnapshotWatcher watcher(path);
+        HttpClientOptions httpOptions;
+        httpOptions.baseUrl = "http://127.0.0.1:1";
+        HttpClient http(httpOptions);
+        OnlineBookService onlineSvc(nullptr, &http);
+
+        const std::string loanDbPath = DATA_DIR "/test_snapshot_loans.db";
+        std::remove(loanDbPath.c_str());
+        LoanService loans(onlineSvc, loanDbPath, {}, &watcher);
+        allPassed &= printTestStatus("Test 6: Borrow from the snapshot",
+            loans.borrowBook("Neuromancer").has_value() && !loans.borrowBook("Not In The Snapshot") &&
+            loans.catalogCacheStats().foundHits == 0);
+    }
+
+    std::remove(path.c_str());
+    std::cout << "\n--- Automated CatalogSnapshot Tests Complete ---\n";
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#include "CompactBook.h"            // Include the record types you want to test
+#include <iostream>
+#include <string>
+
+// Helper function to print a test status
+static bool printTestStatus(const std::string& testName, bool passed) {
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << std::endl;
+    return passed;
+}
+
+static OnlineBook makeBook(const std::string& title, const std::string& workKey, int64_t coverId) {
+    OnlineBook b;
+    b.title = title;
+    b.author = "J.R.R. Tolkien";
+    b.publishYear = "1937";
+    b.coverId = coverId;
+    b.workKey = workKey;
+    b.subjects = {"Fantasy", "Dragons"};
+    return b;
+}
+
+int main() {
+    std::cout << "--- Running Automated CompactBook Tests ---\n\n";
+    bool allPassed = true;
+
+    // Test Case 1: URLs are derived from the IDs, and empty without them
+    OnlineBook hobbit = makeBook("The Hobbit", "OL262758W", 14627509);
+    OnlineBook bare;
+    allPassed &= printTestStatus("Test 1: Lazy URLs",
+        hobbit.openLibraryUrl() == "https://openlibrary.org/works/OL262758W" &&
+        hobbit.coverUrl() == "https://covers.openlibrary.org/b/id/14627509-M.jpg" &&
+        bare.openLibraryUrl().empty() && bare.coverUrl().empty());
+
+    // Test Case 2: Saved URLs map back to work keys
+    allPassed &= printTestStatus("Test 2: Work key from URL",
+        OnlineBook::workKeyFromUrl("https://openlibrary.org/works/OL262758W") == "OL262758W" &&
+        OnlineBook::workKeyFromUrl("/works/OL1W") == "OL1W" &&
+        OnlineBook::workKeyFromUrl("") == "");
+
+    // Test Case 3: Repeated strings are stored once
+    StringPool pool;
+    uint32_t a = pool.intern("Fantasy");
+    uint32_t b = pool.intern(std::string("Fantasy"));
+    allPassed &= printTestStatus("Test 3: Interning deduplicates",
+        a == b && pool.size() == 1 && pool.at(a) == "Fantasy");
+
+    // Test Case 4: A list round-trips every field, sharing pool entries between books
+    std::vector<OnlineBook> books = {hobbit, makeBook("The Silmarillion", "OL27513W", 0), bare};
+    CompactBookList list(books, pool);
+    auto expanded = list.expand(pool);
+    bool same = expanded.size() == books.size();
+    for (size_t i = 0; same && i < books.size(); ++i) {
+        same = expanded[i].title == books[i].title && expanded[i].author == books[i].author &&
+               expanded[i].publishYear == books[i].publishYear && expanded[i].coverId == books[i].coverId &&
+               expanded[i].workKey == books[i].workKey && expanded[i].subjects == books[i].subjects;
+    }
+    // Pool: "Fantasy" (from test 3), "Dragons", "J.R.R. Tolkien", "1937", "" (bare author/year)
+    allPassed &= printTestStatus("Test 4: Round trip", same && pool.size() == 5);
+
+    // Test Case 5: Rebasing onto a new pool keeps the content and drops unused strings
+    pool.intern("Only in an evicted page");
+    StringPool fresh;
+    auto moved = list.rebased(pool, fresh).expand(fresh);
+    allPassed &= printTestStatus("Test 5: Rebase drops unused strings",
+        moved.size() == 3 && moved[1].title == "The Silmarillion" && moved[1].subjects[1] == "Dragons" &&
+        pool.size() == 6 && fresh.size() == 5);
+
+    std::cout << "\n--- Automated CompactBook Tests Complete ---\n";
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+#include "DumpIngester.h"     // Include the ingester you want to test
+#include "CatalogDB.h"
+#include "OnlineBookService.h"
+#include "LoanService.h"
+#include "HttpClient.h"
+#include <cstdio>            // For std::remove
+#include <filesystem>        // For creating the data folder
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <zlib.h>            // To write a gzipped dump
+
+// Define DATA_DIR macro if it's not picked up from CMake for standalone test
+#ifndef DATA_DIR
+#define DATA_DIR "data"
+#endif
+
+using Kind = DumpRecord::Kind;
+
+// Helper function to print a test status
+static bool printTestStatus(const std::string& testName, bool passed) {
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << std::endl;
+    return passed;
+}
+
+// Lines in the published dump format: type, key, revision, last_modified, JSON.
+static const char* kWorksDump =
+    "/type/work\t/works/OL27448W\t5\t2010-04-28T06:54:19\t"
+    "{\"key\": \"/works/OL27448W\", \"title\": \"The Lord of the Rings\", "
+    "\"authors\": [{\"type\": {\"key\": \"/type/author_role\"}, \"author\": {\"key\": \"/authors/OL26320A\"}}], "
+    "\"first_publish_date\": \"July 29, 1954\", \"covers\": [-1, 9255566], "
+    "\"subjects\": [\"Fantasy\", \"Middle Earth\", \"Hobbits\", \"Quests\", \"Wizards\"]}\n"
+    "/type/work\t/works/OL45804W\t3\t2009-12-01T00:00:00\t"
+    "{\"key\": \"/works/OL45804W\", \"title\": \"Fantastic Mr Fox\", \"authors\": [{\"key\": \"/authors/OL34184A\"}]}\n"
+    "/type/edition\t/books/OL1M\t1\t2008-04-01T03:28:50\t{\"key\": \"/books/OL1M\", \"title\": \"An edition\"}\n"
+    "/type/work\t/works/OL1W\t1\t2008-04-01T03:28:50\t{not json\n"
+    // A later revision of the same work, as a dump can carry: the last one wins.
+    "/type/work\t/works/OL45804W\t4\t2011-01-01T00:00:00\t"
+    "{\"key\": \"/works/OL45804W\", \"title\": \"Fantastic Mr. Fox\", \"authors\": [{\"key\": \"/authors/OL34184A\"}], "
+    "\"first_publish_date\": \"1970\"}";  // No trailing newline
+
+static const char* kAuthorsDump =
+    "/type/author\t/authors/OL26320A\t2\t2008-08-20T17:57:09\t{\"key\": \"/authors/OL26320A\", \"name\": \"J.R.R. Tolkien\"}\n"
+    "/type/author\t/authors/OL34184A\t4\t2008-08-20T17:57:09\t{\"key\": \"/authors/OL34184A\", \"name\": \"Roald Dahl\"}\n";
+
+int main() {
+    std::cout << "--- Running Automated DumpIngester Tests ---\n\n";
+    bool allPassed = true;
+    std::filesystem::create_directories(DATA_DIR);
+
+    // Test Case 1: A works dump line, with linked author, free-form date and too many subjects
+    {
+        std::string line = kWorksDump;
+        line.resize(line.find('\n'));
+        DumpRecord r = DumpIngester::parseLine(line);
+        allPassed &= printTestStatus("Test 1: Parse a work line",
+            r.kind == Kind::Work && r.key == "OL27448W" && r.title == "The Lord of the Rings" &&
+            r.authorName.empty() && r.authorKey == "OL26320A" && r.publishYear == "1954" &&
+            r.coverId == 9255566 && r.subjects.size() == CatalogDB::kMaxSubjects && r.subjects[0] == "Fantasy");
+    }
+
+    // Test Case 2: Authors, search-style JSONL, other types and broken lines
+    {
+        DumpRecord author = DumpIngester::parseLine(
+            "/type/author\t/authors/OL34184A\t4\t2008-08-20\t{\"key\": \"/authors/OL34184A\", \"name\": \"Roald Dahl\"}");
+        DumpRecord jsonl = DumpIngester::parseLine(
+            "{\"key\": \"/works/OL82563W\", \"title\": \"Harry Potter\", \"author_name\": [\"J. K. Rowling\"], "
+            "\"first_publish_year\": 1997, \"cover_i\": 10521270, \"subject\": [\"Magic\"]}\r\n");
+        allPassed &= printTestStatus("Test 2: Parse author and JSONL lines",
+            author.kind == Kind::Author && author.key == "OL34184A" && author.authorName == "Roald Dahl" &&
+            jsonl.kind == Kind::Work && jsonl.key == "OL82563W" && jsonl.authorName == "J. K. Rowling" &&
+            jsonl.publishYear == "1997" && jsonl.coverId == 10521270 && jsonl.subjects.size() == 1);
+
+        allPassed &= printTestStatus("Test 3: Skip editions, reject broken lines",
+            DumpIngester::parseLine("/type/edition\t/books/OL1M\t1\tx\t{\"key\": \"/books/OL1M\"}").kind == Kind::Other &&
+            DumpIngester::parseLine("/type/work\t/works/OL1W\t1\tx\t{not json").kind == Kind::Malformed &&
+            DumpIngester::parseLine("/type/work\t/works/OL1W\t1\tx\t{\"key\": \"/works/OL1W\"}").kind == Kind::Malformed &&
+            DumpIngester::parseLine("/type/work\tno json").kind == Kind::Malformed &&
+            DumpIngester::parseLine("").kind == Kind::Malformed);
+    }
+
+    const std::string catalogPath = DATA_DIR "/test_catalog.db";
+    std::remove(catalogPath.c_str());
+
+    // Test Case 4: Works before authors, tiny chunks and transactions, then finish()
+    {
+        IngestOptions options;
+        options.parserThreads = 2;
+        options.linesPerChunk = 2;
+        options.rowsPerTransaction = 2;
+        DumpIngester ingester(catalogPath, options);
+        std::istringstream works(kWorksDump), authors(kAuthorsDump);
+        const IngestStats w = ingester.ingest(works);
+        const IngestStats a = ingester.ingest(authors);
+        allPassed &= printTestStatus("Test 4: Ingest counts",
+            ingester.ok() && w.error.empty() && w.lines == 5 && w.works == 3 && w.skipped == 1 && w.malformed == 1 &&
+            a.authors == 2 && a.works == 0 && ingester.finish());
+    }
+    {
+        CatalogDB catalog(catalogPath);
+        auto lotr = catalog.search("lord rings");
+        auto fox = catalog.search("dahl fox");
+        auto fanta = catalog.search("fanta"); // "Fantastic" in a title, "Fantasy" in subjects
+        allPassed &= printTestStatus("Test 5: Catalog search after finish",
+            catalog.available() && catalog.countWorks() == 2 &&
+            lotr.size() == 1 && lotr[0].author == "J.R.R. Tolkien" && lotr[0].publishYear == "1954" &&
+            lotr[0].workKey == "OL27448W" && lotr[0].coverId == 9255566 && lotr[0].subjects.size() == 4 &&
+            fox.size() == 1 && fox[0].title == "Fantastic Mr. Fox" && fox[0].publishYear == "1970" &&
+            fanta.size() == 2 && fanta[0].workKey == "OL45804W" && // Title match ranks first
+            catalog.search("tolkien", 5, 1).empty() && catalog.search("nonexistentbookxyz").empty());
+    }
+
+    // Test Case 6: A gzipped dump adds to an existing catalog
+    {
+        const std::string gzPath = DATA_DIR "/test_dump.txt.gz";
+        gzFile gz = gzopen(gzPath.c_str(), "wb");
+        const std::string line = "{\"key\": \"/works/OL893415W\", \"title\": \"Dune\", \"author_name\": [\"Frank Herbert\"]}\n";
+        gzwrite(gz, line.data(), static_cast<unsigned>(line.size()));
+        gzclose(gz);
+
+        const IngestStats stats = DumpIngester(catalogPath).ingestFile(gzPath); // finish() runs on destruction
+        const bool missingFails = !DumpIngester(catalogPath).ingestFile(DATA_DIR "/no_such_dump.gz").error.empty();
+        CatalogDB catalog(catalogPath);
+        auto dune = catalog.search("dune");
+        allPassed &= printTestStatus("Test 6: Ingest a gzipped dump",
+            stats.error.empty() && stats.works == 1 && missingFails && catalog.countWorks() == 3 &&
+            dune.size() == 1 && dune[0].author == "Frank Herbert");
+        std::remove(gzPath.c_str());
+    }
+
+    // Test Case 7: Searches and borrow checks are answered by the catalog; the network is unreachable
+    {
+        CatalogDB catalog(catalogPath);
+        HttpClientOptions httpOptions;
+        httpOptions.baseUrl = "http://127.0.0.1:1";
+        HttpClient http(httpOptions);
+        OnlineBookService onlineSvc(nullptr, &http, &catalog);
+
+        auto found = onlineSvc.trySearch("Fantastic Mr Fox", 5, 0);
+        auto pastEnd = onlineSvc.trySearch("Fantastic Mr Fox", 5, 5);
+        auto unknown = onlineSvc.trySearch("Emma", 5, 0);
+
+        const std::string loanDbPath = DATA_DIR "/test_catalog_loans.db";
+        std::remove(loanDbPath.c_str());
+        LoanService loans(onlineSvc, loanDbPath);
+        allPassed &= printTestStatus("Test 7: Catalog answers before the network",
+            found && found->size() == 1 && (*found)[0].author == "Roald Dahl" &&
+            pastEnd && pastEnd->empty() && !unknown &&
+            loans.borrowBook("Dune").has_value() && !loans.borrowBook("Emma"));
+    }
+
+    std::cout << "\n--- Automated DumpIngester Tests Complete ---\n";
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,298 @@
+#include "FuzzyTitleIndex.h"  // Include the index you want to test
+#include "EditDistance.h"
+#include "CatalogSnapshot.h"
+#include "LoanService.h"
+#include "HttpClient.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>             // For std::remove
+#include <filesystem>         // For creating the data folder
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Define DATA_DIR macro if it's not picked up from CMake for standalone test
+#ifndef DATA_DIR
+#define DATA_DIR "data"
+#endif
+
+// Helper function to print a test status
+static bool printTestStatus(const std::string& testName, bool passed) {
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << std::endl;
+    return passed;
+}
+
+// Textbook O(n*m) Levenshtein distance, the reference for both fast versions.
+static int referenceDistance(const std::string& a, const std::string& b) {
+    std::vector<std::vector<int>> d(a.size() + 1, std::vector<int>(b.size() + 1));
+    for (size_t i = 0; i <= a.size(); ++i) d[i][0] = static_cast<int>(i);
+    for (size_t j = 0; j <= b.size(); ++j) d[0][j] = static_cast<int>(j);
+    for (size_t i = 1; i <= a.size(); ++i) {
+        for (size_t j = 1; j <= b.size(); ++j) {
+            d[i][j] = std::min({d[i - 1][j] + 1, d[i][j - 1] + 1, d[i - 1][j - 1] + (a[i - 1] != b[j - 1])});
+        }
+    }
+    return d[a.size()][b.size()];
+}
+
+static std::string randomWord(std::mt19937& rng, size_t minLength, size_t maxLength) {
+    std::uniform_int_distribution<size_t> length(minLength, maxLength);
+    std::uniform_int_distribution<int> letter(0, 3); // Small alphabet: many near matches
+    std::string s(length(rng), 'a');
+    for (auto& c : s) c = static_cast<char>('a' + letter(rng));
+    return s;
+}
+
+// Local search.json server that knows only the given titles (matched on the
+// exact "q=" value, spaces as '+'): a stand-in for Open Library.
+class TitleServer {
+public:
+    explicit TitleServer(std::set<std::string> titles) : titles_(std::move(titles)) {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        listen(fd_, 16);
+        socklen_t len = sizeof(addr);
+        getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        acceptor_ = std::thread([this]() { serve(); });
+    }
+    ~TitleServer() {
+        shutdown(fd_, SHUT_RDWR); // Wakes the blocked accept()
+        acceptor_.join();
+        close(fd_);
+    }
+
+    std::string baseUrl() const { return "http://127.0.0.1:" + std::to_string(port_); }
+
+private:
+    std::set<std::string> titles_;
+    int fd_ = -1;
+    unsigned short port_ = 0;
+    std::thread acceptor_;
+
+    void serve() {
+        int client;
+        while ((client = accept(fd_, nullptr, nullptr)) >= 0) {
+            std::string request;
+            char buf[1024];
+            ssize_t n;
+            while (request.find("\r\n\r\n") == std::string::npos && (n = read(client, buf, sizeof(buf))) > 0) {
+                request.append(buf, static_cast<size_t>(n));
+            }
+            const size_t q = request.find("?q=") + 3;
+            std::string title = request.substr(q, request.find('&', q) - q);
+            std::replace(title.begin(), title.end(), '+', ' ');
+            const std::string body = titles_.count(title)
+                ? R"({"docs":[{"key":"/works/OL1W","title":")" + title + R"("}]})"
+                : R"({"docs":[]})";
+            const std::string response = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nConnection: close\r\n"
+                                         "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+            send(client, response.data(), response.size(), MSG_NOSIGNAL);
+            close(client);
+        }
+    }
+};
+
+int main() {
+    std::cout << "--- Running Automated FuzzyTitleIndex Tests ---\n\n";
+    bool allPassed = true;
+    std::mt19937 rng(20240611);
+
+    // Test Case 1: Both edit distances agree with the textbook one, cap included
+    {
+        bool agree = true;
+        for (int i = 0; i < 2000 && agree; ++i) {
+            const std::string a = randomWord(rng, 0, 70), b = randomWord(rng, 0, 70); // Some past the 64-byte word
+            const int expected = referenceDistance(a, b);
+            for (int cap : {0, 1, 3, 100}) {
+                const int want = std::min(expected, cap + 1);
+                agree &= fuzzy::editDistance(a, b, cap) == want &&
+                         fuzzy::BitParallelPattern(a).distance(b, cap) == want;
+            }
+        }
+        allPassed &= printTestStatus("Test 1: Edit distance matches reference",
+            agree && fuzzy::BitParallelPattern("kitten").distance("sitting", 5) == 3);
+    }
+
+    // Test Case 2: Normalization
+    allPassed &= printTestStatus("Test 2: Normalize titles",
+        FuzzyTitleIndex::normalize("  The Lord of the Rings: Return of the King!  ") ==
+            "the lord of the rings return of the king" &&
+        FuzzyTitleIndex::normalize("Harry  Potter -- 1") == "harry potter 1" &&
+        FuzzyTitleIndex::normalize("...").empty());
+
+    FuzzyTitleIndex index({"The Hobbit", "The Lord of the Rings", "Dune", "Dune Messiah", "Emma",
+                           "The Hobbit: An Unexpected Journey", "Neuromancer", "Hobbit"});
+
+    // Test Case 3: Typical front-desk typos find the right title first
+    {
+        auto hobbit = index.match("teh hobbit"); // A transposition costs two edits
+        auto rings = index.match("the lord of the rigns");
+        auto exact = index.match("NEUROMANCER");
+        allPassed &= printTestStatus("Test 3: Typos",
+            !hobbit.empty() && index.title(hobbit[0].id) == "The Hobbit" && hobbit[0].distance == 2 &&
+            !rings.empty() && index.title(rings[0].id) == "The Lord of the Rings" &&
+            exact.size() == 1 && exact[0].score == 1.0 && exact[0].distance == 0);
+    }
+
+    // Test Case 4: Short queries get a smaller budget; unrelated ones match nothing
+    {
+        auto dune = index.match("dnue");     // Two edits from "dune": over a third of four letters
+        auto dine = index.match("dine");     // One edit
+        FuzzyMatchOptions top1;
+        top1.limit = 1;
+        allPassed &= printTestStatus("Test 4: Budget and misses",
+            dune.empty() && dine.size() == 1 && index.title(dine[0].id) == "Dune" &&
+            index.match("quantum chromodynamics").empty() && index.match("").empty() &&
+            index.match("hobbit", top1).size() == 1);
+    }
+
+    // Test Case 5: The trigram filter loses nothing: same answers as checking every title
+    {
+        std::vector<std::string> titles;
+        for (int i = 0; i < 3000; ++i) titles.push_back(randomWord(rng, 4, 14));
+        FuzzyTitleIndex random(titles);
+        FuzzyMatchOptions options;
+        options.limit = titles.size();
+        options.minScore = 0;
+        bool same = true;
+        for (int i = 0; i < 200 && same; ++i) {
+            const std::string query = randomWord(rng, 6, 14); // Long enough for the full 2-edit budget
+            std::vector<uint32_t> expected, actual;
+            for (uint32_t id = 0; id < titles.size(); ++id) {
+                if (referenceDistance(query, titles[id]) <= options.maxEdits) expected.push_back(id);
+            }
+            for (const auto& m : random.match(query, options)) actual.push_back(m.id);
+            std::sort(actual.begin(), actual.end());
+            same &= actual == expected;
+        }
+        allPassed &= printTestStatus("Test 5: No false negatives", same);
+    }
+
+    // Test Case 6: Borrows with typos are answered from the snapshot; the network is unreachable
+    {
+        std::filesystem::create_directories(DATA_DIR);
+        const std::string path = DATA_DIR "/test_fuzzy.snapshot";
+        std::vector<OnlineBook> books(3);
+        books[0].title = "The Hobbit";
+        books[1].title = "Dune Messiah";
+        books[2].title = "Neuromancer";
+        std::string error;
+        CatalogSnapshot::write(path, books, error);
+
+        SnapshotWatcher watcher(path, std::chrono::seconds(5), true);
+        for (int i = 0; i < 200 && !watcher.fuzzyIndex(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10)); // Built on the watcher's thread
+        }
+        HttpClientOptions httpOptions;
+        httpOptions.baseUrl = "http://127.0.0.1:1";
+        HttpClient http(httpOptions);
+        OnlineBookService onlineSvc(nullptr, &http);
+        const std::string loanDbPath = DATA_DIR "/test_fuzzy_loans.db";
+        std::remove(loanDbPath.c_str());
+        LoanService loans(onlineSvc, loanDbPath, {}, &watcher);
+
+        auto suggestions = loans.suggestTitles("nueromancr");
+        const bool borrowed = watcher.fuzzyIndex() && loans.borrowBook("The Hobit").has_value() &&
+                              loans.borrowBooks({"dune mesiah"})[0].has_value();
+        allPassed &= printTestStatus("Test 6: Borrow despite typos",
+            borrowed && !suggestions.empty() && suggestions[0].title == "Neuromancer" && suggestions[0].score < 1.0);
+
+        // ...and the ledger records the catalog's titles, not the typos
+        std::vector<std::string> ledger;
+        for (const auto& loan : LoanRequestDB(loanDbPath).getActiveLoans(10).loans) ledger.push_back(loan.bookTitle);
+        std::sort(ledger.begin(), ledger.end());
+        allPassed &= printTestStatus("Test 6b: Loans stored under the matched title",
+            ledger == std::vector<std::string>{"Dune Messiah", "The Hobbit"});
+        std::remove(path.c_str());
+    }
+
+    // Test Case 7: Every replaced snapshot gets its own index, even when two
+    // reloads land between index builds and the newest snapshot is allocated
+    // where the indexed one was
+    {
+        const std::string path = DATA_DIR "/test_fuzzy_reload.snapshot";
+        std::vector<OnlineBook> books(1);
+        std::string error;
+        books[0].title = "Title 0";
+        CatalogSnapshot::write(path, books, error);
+        SnapshotWatcher watcher(path, std::chrono::milliseconds(100), true);
+
+        bool followed = true;
+        for (int round = 1; followed && round <= 5; ++round) {
+            for (int reload = 0; reload < 2; ++reload) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20)); // A new modification time
+                books[0].title = "Title " + std::to_string(round) + "." + std::to_string(reload);
+                CatalogSnapshot::write(path, books, error);
+                watcher.reloadIfChanged();
+            }
+            followed = false;
+            for (int i = 0; i < 100 && !followed; ++i) {
+                auto index = watcher.fuzzyIndex();
+                followed = index && index->title(0) == books[0].title;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+        allPassed &= printTestStatus("Test 7: Fuzzy index follows snapshot reloads", followed);
+        std::remove(path.c_str());
+    }
+
+    // Test Case 8: Near matches are not lent in place of a real title. A title
+    // Open Library has is lent as typed; one tied between two snapshot titles
+    // is only suggested
+    {
+        const std::string path = DATA_DIR "/test_fuzzy_neighbours.snapshot";
+        std::vector<OnlineBook> books(4);
+        books[0].title = "Harry Potter 1";
+        books[1].title = "Harry Potter 3";
+        books[2].title = "Gemma";
+        books[3].title = "The Hobbit";
+        std::string error;
+        CatalogSnapshot::write(path, books, error);
+        SnapshotWatcher watcher(path, std::chrono::seconds(5), true);
+        for (int i = 0; i < 200 && !watcher.fuzzyIndex(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        TitleServer server({"Emma", "Harry Potter 2"}); // Newer than the snapshot
+        HttpClientOptions httpOptions;
+        httpOptions.baseUrl = server.baseUrl();
+        httpOptions.http2 = false;
+        httpOptions.rateLimit.requestsPerSecond = 0;
+        httpOptions.retry.maxRetries = 0;
+        HttpClient http(httpOptions);
+        OnlineBookService onlineSvc(nullptr, &http);
+        const std::string loanDbPath = DATA_DIR "/test_fuzzy_neighbour_loans.db";
+        std::remove(loanDbPath.c_str());
+        LoanService loans(onlineSvc, loanDbPath, {}, &watcher);
+
+        const bool online = loans.borrowBook("Emma").has_value() && loans.borrowBook("Harry Potter 2").has_value();
+        const bool tieRefused = !loans.borrowBook("Harry Potter 4"); // One edit from both 1 and 3
+        const auto suggestions = loans.suggestTitles("Harry Potter 4");
+        std::set<std::string> suggested;
+        for (const auto& suggestion : suggestions) suggested.insert(suggestion.title);
+        const bool typoFixed = loans.borrowBook("The Hobit").has_value(); // Unknown online, one clear match
+
+        std::vector<std::string> ledger;
+        for (const auto& loan : LoanRequestDB(loanDbPath).getActiveLoans(10).loans) ledger.push_back(loan.bookTitle);
+        std::sort(ledger.begin(), ledger.end());
+        allPassed &= printTestStatus("Test 8: Online titles and ties are not replaced by neighbours",
+            watcher.fuzzyIndex() && online && tieRefused && typoFixed &&
+            suggested.count("Harry Potter 1") && suggested.count("Harry Potter 3") &&
+            ledger == std::vector<std::string>{"Emma", "Harry Potter 2", "The Hobbit"});
+        std::remove(path.c_str());
+    }
+
+    std::cout << "\n--- Automated FuzzyTitleIndex Tests Complete ---\n";
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,317 @@
+#include "HttpClient.h"             // Include the client you want to test
+#include "RateControl.h"
+#include "OnlineBookService.h"
+#include "OpenLibraryParser.h"
+#include "SearchCache.h"
+#include <zlib.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helper function to print a test status
+static bool printTestStatus(const std::string& testName, bool passed) {
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << std::endl;
+    return passed;
+}
+
+static const char* const kDuneBody = R"({"docs":[{"key":"/works/OL1W","title":"Dune"}]})";
+
+// gzip-compressed `data`, as a server would send it with Content-Encoding: gzip.
+static std::string gzip(const std::string& data) {
+    z_stream zs{};
+    deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY); // +16: gzip wrapper
+    std::string out(deflateBound(&zs, static_cast<uLong>(data.size())), '\0');
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zs.avail_in = static_cast<uInt>(data.size());
+    zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    zs.avail_out = static_cast<uInt>(out.size());
+    deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    return out;
+}
+
+// A search.json body with `count` docs.
+static std::string manyDocs(int count) {
+    std::string body = R"({"numFound":)" + std::to_string(count) + R"(,"docs":[)";
+    for (int i = 0; i < count; ++i) {
+        if (i > 0) body += ',';
+        body += R"({"key":"/works/OL)" + std::to_string(i) + R"(W","title":"Book )" + std::to_string(i) +
+                R"(","author_name":["Some Author"],"first_publish_year":1999,"subject":["Fiction","Novels"]})";
+    }
+    return body + "]}";
+}
+
+// Local server that answers request N with the Nth scripted status (the last
+// one repeating), one request per connection: a stand-in for a struggling Open Library.
+// With `compress`, a 200 body goes out gzipped, in small chunks, to clients that accept gzip.
+class ScriptedServer {
+public:
+    explicit ScriptedServer(std::vector<int> statuses, std::string body = kDuneBody, bool compress = false)
+        : statuses_(std::move(statuses)), body_(std::move(body)), compress_(compress) {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        listen(fd_, 16);
+        socklen_t len = sizeof(addr);
+        getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        acceptor_ = std::thread([this]() { serve(); });
+    }
+    ~ScriptedServer() {
+        shutdown(fd_, SHUT_RDWR); // Wakes the blocked accept()
+        acceptor_.join();
+        close(fd_);
+    }
+
+    std::string baseUrl() const { return "http://127.0.0.1:" + std::to_string(port_); }
+    int requests() const { return requests_.load(); }
+    bool sawGzip() const { return sawGzip_.load(); }     // Some request accepted gzip
+    size_t bodyBytesSent() const { return sent_.load(); } // On the wire, for the last response
+
+private:
+    std::vector<int> statuses_;
+    std::string body_;
+    bool compress_;
+    std::atomic<bool> sawGzip_{false};
+    std::atomic<size_t> sent_{0};
+    int fd_ = -1;
+    unsigned short port_ = 0;
+    std::atomic<int> requests_{0};
+    std::thread acceptor_;
+
+    static bool sendAll(int fd, const std::string& data) {
+        return send(fd, data.data(), data.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(data.size());
+    }
+
+    void serve() {
+        int client;
+        while ((client = accept(fd_, nullptr, nullptr)) >= 0) {
+            std::string request;
+            char buf[1024];
+            ssize_t n;
+            while (request.find("\r\n\r\n") == std::string::npos && (n = read(client, buf, sizeof(buf))) > 0) {
+                request.append(buf, static_cast<size_t>(n));
+            }
+            const size_t i = static_cast<size_t>(requests_++);
+            const int status = statuses_[std::min(i, statuses_.size() - 1)];
+            std::string lowered = request;
+            for (auto& c : lowered) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            const size_t accept = lowered.find("\r\naccept-encoding:");
+            const bool gzipOk = accept != std::string::npos &&
+                                lowered.substr(accept, lowered.find("\r\n", accept + 2) - accept).find("gzip") != std::string::npos;
+            sawGzip_ = sawGzip_ || gzipOk;
+
+            const std::string body = status == 200 ? body_ : "{}";
+            std::string head = "HTTP/1.1 " + std::to_string(status) + " Scripted\r\n"
+                               "Content-Type: application/json\r\nConnection: close\r\n";
+            if (compress_ && gzipOk && status == 200) {
+                const std::string packed = gzip(body);
+                sent_ = packed.size();
+                sendAll(client, head + "Content-Encoding: gzip\r\nTransfer-Encoding: chunked\r\n\r\n");
+                for (size_t at = 0; at < packed.size(); at += 512) {
+                    const std::string piece = packed.substr(at, 512);
+                    char size[16];
+                    std::snprintf(size, sizeof(size), "%zx\r\n", piece.size());
+                    if (!sendAll(client, size + piece + "\r\n")) break; // The client stopped reading
+                }
+                sendAll(client, "0\r\n\r\n");
+            } else {
+                sent_ = body.size();
+                sendAll(client, head + "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body);
+            }
+            close(client);
+        }
+    }
+};
+
+static HttpClientOptions optionsFor(const ScriptedServer& server) {
+    HttpClientOptions options;
+    options.baseUrl = server.baseUrl();
+    options.http2 = false;
+    options.rateLimit.requestsPerSecond = 0;
+    options.retry.baseDelay = std::chrono::milliseconds(10); // Keep the test quick
+    return options;
+}
+
+int main() {
+    std::cout << "--- Running Automated HttpClient Tests ---\n\n";
+    bool allPassed = true;
+
+    // Test Case 1: The bucket allows a burst, then spaces requests at the rate;
+    // a 429 halves the rate and successes win it back
+    {
+        RateLimitOptions options;
+        options.requestsPerSecond = 10;
+        options.burst = 2;
+        TokenBucket bucket(options);
+        const bool burst = bucket.reserve().count() == 0 && bucket.reserve().count() == 0;
+        const auto third = bucket.reserve();
+        bucket.onThrottled();
+        const bool halved = bucket.currentRate() == 5.0;
+        for (int i = 0; i < 20; ++i) bucket.onSuccess();
+        allPassed &= printTestStatus("Test 1: Adaptive token bucket",
+            burst && third.count() >= 90 && third.count() <= 100 && halved && bucket.currentRate() == 10.0);
+    }
+
+    // Test Case 2: Backoff waits are random but stay under the doubling ceiling
+    {
+        RetryOptions options;
+        options.baseDelay = std::chrono::milliseconds(100);
+        options.maxDelay = std::chrono::milliseconds(1000);
+        std::mt19937_64 rng(42);
+        bool bounded = true, varied = false;
+        auto first = jitteredBackoff(options, 2, rng);
+        for (int i = 0; i < 200; ++i) {
+            auto d0 = jitteredBackoff(options, 0, rng);
+            auto d2 = jitteredBackoff(options, 2, rng);
+            auto d9 = jitteredBackoff(options, 9, rng);
+            bounded &= d0.count() <= 100 && d2.count() <= 400 && d9.count() <= 1000;
+            varied |= d2 != first;
+        }
+        allPassed &= printTestStatus("Test 2: Jittered exponential backoff", bounded && varied);
+    }
+
+    // Test Case 3: The breaker opens after repeated failures and lets one probe through later
+    {
+        CircuitBreakerOptions options;
+        options.failureThreshold = 2;
+        options.openDuration = std::chrono::milliseconds(50);
+        CircuitBreaker breaker(options);
+        breaker.onFailure();
+        const bool stillClosed = breaker.allow();
+        breaker.onFailure();
+        const bool open = !breaker.allow() && breaker.state() == CircuitBreaker::State::Open;
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+        const bool probe = breaker.allow() && !breaker.allow(); // Only one probe at a time
+        breaker.onSuccess();
+        allPassed &= printTestStatus("Test 3: Circuit breaker",
+            stillClosed && open && probe && breaker.state() == CircuitBreaker::State::Closed && breaker.allow());
+    }
+
+    // Test Case 4: Throttling and server errors are retried until a success
+    {
+        ScriptedServer server({503, 429, 200});
+        HttpClient http(optionsFor(server));
+        HttpResponse resp = http.get("/search.json?q=dune");
+        auto stats = http.stats();
+        allPassed &= printTestStatus("Test 4: Retries 429 and 5xx",
+            resp.status == 200 && resp.attempts == 3 && server.requests() == 3 &&
+            stats.retries == 2 && stats.throttled == 1);
+    }
+
+    // Test Case 5: Client errors are final, and retries stop at maxRetries
+    {
+        ScriptedServer notFound({404});
+        HttpClient http404(optionsFor(notFound));
+        HttpResponse missing = http404.get("/nothing");
+
+        ScriptedServer failing({500});
+        HttpClient http500(optionsFor(failing));
+        HttpResponse failed = http500.get("/search.json?q=dune");
+        allPassed &= printTestStatus("Test 5: Retry limits",
+            missing.status == 404 && notFound.requests() == 1 &&
+            failed.status == 500 && failing.requests() == 4); // 1 + RetryOptions::maxRetries
+    }
+
+    // Test Case 6: With the circuit open, calls fail fast and a search falls back to stale cache
+    {
+        ScriptedServer server({200, 503});
+        HttpClientOptions options = optionsFor(server);
+        options.retry.maxRetries = 0;
+        options.circuitBreaker.failureThreshold = 2;
+        HttpClient http(options);
+
+        SearchCacheOptions cacheOptions;
+        cacheOptions.ttl = std::chrono::seconds(0); // Everything is stale at once
+        SearchCache cache("", cacheOptions);
+        OnlineBookService svc(&cache, &http);
+
+        auto fresh = svc.trySearch("dune", 5, 0);  // 200: fetched and cached
+        auto stale = svc.trySearch("dune", 5, 0);  // 503: stale copy served
+        svc.trySearch("emma", 5, 0);               // 503: circuit opens
+        auto fastFail = http.get("/search.json?q=dune");
+        allPassed &= printTestStatus("Test 6: Circuit breaker and stale fallback",
+            fresh && fresh->size() == 1 && stale && (*stale)[0].title == "Dune" &&
+            fastFail.circuitOpen && server.requests() == 3 && http.stats().rejected == 1 &&
+            cache.stats().staleHits == 1);
+    }
+
+    // Test Case 7: Bodies come gzipped and are parsed while they download, never held whole
+    {
+        const std::string body = manyDocs(3000);
+        ScriptedServer server({200}, body, true);
+        HttpClient http(optionsFor(server));
+        static const OpenLibraryParser parser(4);
+        std::vector<OnlineBook> books;
+        bool parsed = false;
+        HttpResponse resp = http.get("/search.json?q=book", CancellationToken(),
+                                     [&](std::istream& in) { parsed = parser.parse(in, books); });
+        const size_t wireBytes = server.bodyBytesSent();
+
+        OnlineBookService svc(nullptr, &http);
+        auto viaService = svc.trySearch("book", 3000, 0);
+
+        HttpClientOptions plainOptions = optionsFor(server);
+        plainOptions.compression = false;
+        ScriptedServer plainServer({200}, body, true);
+        plainOptions.baseUrl = plainServer.baseUrl();
+        HttpClient plain(plainOptions);
+        auto uncompressed = OnlineBookService(nullptr, &plain).trySearch("book", 3000, 0);
+
+        allPassed &= printTestStatus("Test 7: Compressed, streamed bodies",
+            resp.status == 200 && resp.streamed && resp.body.empty() && parsed && books.size() == 3000 &&
+            books[2999].title == "Book 2999" && server.sawGzip() && wireBytes * 10 < body.size() &&
+            viaService && viaService->size() == 3000 &&
+            !plainServer.sawGzip() && uncompressed && uncompressed->size() == 3000);
+    }
+
+    // Test Case 8: Only final 2xx responses reach the reader, which may stop early or throw
+    {
+        ScriptedServer server({503, 200});
+        HttpClient http(optionsFor(server));
+        int calls = 0;
+        std::string seen;
+        HttpResponse retried = http.get("/search.json?q=dune", CancellationToken(), [&](std::istream& in) {
+            ++calls;
+            seen.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        });
+
+        ScriptedServer missing({404});
+        HttpClient http404(optionsFor(missing));
+        HttpResponse notFound = http404.get("/nothing", CancellationToken(), [&](std::istream&) { ++calls; });
+
+        ScriptedServer big({200}, manyDocs(3000), true);
+        HttpClient bigHttp(optionsFor(big));
+        HttpResponse early = bigHttp.get("/search.json?q=book", CancellationToken(), [](std::istream& in) {
+            char first[10];
+            in.read(first, sizeof(first)); // Then stop: the rest is not needed
+        });
+        bool rethrown = false;
+        try {
+            bigHttp.get("/search.json?q=book", CancellationToken(), [](std::istream&) { throw std::runtime_error("bad"); });
+        } catch (const std::runtime_error&) {
+            rethrown = true;
+        }
+        allPassed &= printTestStatus("Test 8: Reader sees final responses only",
+            retried.status == 200 && calls == 1 && seen == kDuneBody && retried.body.empty() &&
+            notFound.status == 404 && notFound.body == "{}" && !notFound.streamed &&
+            early.status == 200 && early.streamed && early.error.empty() && rethrown);
+    }
+
+    std::cout << "\n--- Automated HttpClient Tests Complete ---\n";
+    return allPassed ? 0 : 1;
+}
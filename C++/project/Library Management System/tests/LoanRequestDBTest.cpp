@@ -0,0 +1,105 @@
+#include "LoanRequestDB.h"         // Include the database class you want to test
+#include <iostream>
+#include <string>
+#include <cstdio>                  // For std::remove
+#include <filesystem>              // For creating the data folder
+
+// Define DATA_DIR macro if it's not picked up from CMake for standalone test
+#ifndef DATA_DIR
+#define DATA_DIR "data"
+#endif
+
+// Helper function to print a test status
+static bool printTestStatus(const std::string& testName, bool passed) {
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << std::endl;
+    return passed;
+}
+
+static LoanRecord makeLoan(const std::string& title, util::EpochDay dueDay) {
+    LoanRecord record;
+    record.bookTitle = title;
+    record.borrowDay = dueDay - 21;
+    record.dueDay = dueDay;
+    return record;
+}
+
+int main() {
+    std::cout << "--- Running Automated LoanRequestDB Tests ---\n\n";
+    bool allPassed = true;
+
+    // Test Case 1: Epoch-day conversion round-trips and rejects invalid dates
+    allPassed &= printTestStatus("Test 1: Epoch days",
+        util::toEpochDay(1970, 1, 1) == 0 && util::toEpochDay(2000, 3, 1) == 11017 &&
+        util::formatEpochDay(util::toEpochDay(2024, 2, 29)) == "2024-02-29" &&
+        util::parseEpochDay("2024-03-01") == util::toEpochDay(2024, 3, 1) &&
+        !util::parseEpochDay("2023-02-29") && !util::parseEpochDay("soon"));
+
+    std::filesystem::create_directories(DATA_DIR);
+    const std::string dbPath = DATA_DIR "/test_loan_ledger.db";
+    std::remove(dbPath.c_str()); // Start from an empty database
+
+    const util::EpochDay day = util::toEpochDay(2024, 6, 1);
+    LoanRequestDB db(dbPath);
+    db.insertLoans({makeLoan("Dune", day + 10), makeLoan("Emma", day - 5), makeLoan("Ulysses", day),
+                    makeLoan("Beloved", day - 5), makeLoan("Middlemarch", day + 40)});
+
+    // Test Case 2: Active loans come back soonest due first, ties by id
+    LoanPage page = db.getActiveLoans(10);
+    allPassed &= printTestStatus("Test 2: Active loans ordered by due day",
+        page.loans.size() == 5 && !page.next && page.loans[0].bookTitle == "Emma" &&
+        page.loans[1].bookTitle == "Beloved" && page.loans[4].bookTitle == "Middlemarch");
+
+    // Test Case 3: Cursor paging visits every loan once
+    std::vector<std::string> titles;
+    std::optional<LoanCursor> cursor;
+    size_t pages = 0;
+    do {
+        page = db.getActiveLoans(2, cursor);
+        for (const auto& loan : page.loans) titles.push_back(loan.bookTitle);
+        cursor = page.next;
+        ++pages;
+    } while (cursor);
+    allPassed &= printTestStatus("Test 3: Cursor paging",
+        pages == 3 && titles == std::vector<std::string>{"Emma", "Beloved", "Ulysses", "Dune", "Middlemarch"});
+
+    // Test Case 4: Due-date range is inclusive on both ends
+    page = db.getLoansDueBetween(day, day + 10, 10);
+    allPassed &= printTestStatus("Test 4: Loans due in range",
+        page.loans.size() == 2 && page.loans[0].bookTitle == "Ulysses" && page.loans[1].bookTitle == "Dune");
+
+    // Test Case 5: Overdue means due strictly before the given day
+    page = db.getOverdueLoans(day, 10);
+    allPassed &= printTestStatus("Test 5: Overdue loans",
+        page.loans.size() == 2 && db.countOverdue(day) == 2 && db.countOverdue(day + 1) == 3);
+
+    // Test Case 6: Returned loans drop out of every listing
+    const int64_t emmaId = page.loans[0].id;
+    bool returned = db.markReturned(emmaId, day);
+    allPassed &= printTestStatus("Test 6: Returned loan no longer overdue",
+        returned && !db.markReturned(emmaId, day) && db.countOverdue(day) == 1 &&
+        db.getActiveLoans(10).loans.size() == 4);
+
+    // Test Case 7: A version 1 file (TEXT dates) is converted on open
+    {
+        const std::string legacyPath = DATA_DIR "/test_loan_ledger_v1.db";
+        std::remove(legacyPath.c_str());
+        sqlite3* raw = nullptr;
+        sqlite3_open(legacyPath.c_str(), &raw);
+        sqlite3_exec(raw, R"(
+            CREATE TABLE loan_requests (id INTEGER PRIMARY KEY AUTOINCREMENT, book_title TEXT NOT NULL,
+                                        borrow_date TEXT, due_date TEXT);
+            INSERT INTO loan_requests (book_title, borrow_date, due_date)
+                VALUES ('Dune', '2024-05-11', '2024-06-01');
+        )", nullptr, nullptr, nullptr);
+        sqlite3_close(raw);
+
+        LoanRequestDB legacy(legacyPath);
+        LoanPage converted = legacy.getActiveLoans(10);
+        allPassed &= printTestStatus("Test 7: Version 1 migration",
+            converted.loans.size() == 1 && converted.loans[0].dueDay == day &&
+            converted.loans[0].borrowDay == util::toEpochDay(2024, 5, 11));
+    }
+
+    std::cout << "\n--- Automated LoanRequestDB Tests Complete ---\n";
+    return allPassed ? 0 : 1;
+}
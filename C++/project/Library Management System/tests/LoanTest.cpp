@@ -53,6 +53,15 @@ int main() {
     }
     std::cout << "\n";
 
+    // Test Case 4: Batch borrow mixing existing and non-existent titles
+    std::vector<std::string> batch = {"Dune", "NonExistentBookXYZ123", "Emma"};
+    std::cout << "Test 4: Batch borrowing " << batch.size() << " titles\n";
+    auto batchResults = loanService.borrowBooks(batch);
+    printTestStatus("Test 4: Batch borrow keeps input order",
+                    batchResults.size() == batch.size() &&
+                    batchResults[0].has_value() && !batchResults[1].has_value() && batchResults[2].has_value());
+    std::cout << "\n";
+
     std::cout << "--- Automated LoanService Tests Complete ---\n";
 
     // You can manually inspect 'data/test_loan_requests.db' using a SQLite browser
@@ -0,0 +1,137 @@
+#include "Logger.h"                 // Include the logger you want to test
+#include "RingBuffer.h"
+#include <atomic>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helper function to print a test status
+static bool printTestStatus(const std::string& testName, bool passed) {
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << std::endl;
+    return passed;
+}
+
+static bool contains(const std::string& text, const std::string& part) {
+    return text.find(part) != std::string::npos;
+}
+
+int main() {
+    std::cout << "--- Running Automated Logger Tests ---\n\n";
+    bool allPassed = true;
+
+    // Test Case 1: The ring buffer is FIFO and refuses pushes when full
+    {
+        RingBuffer<int> ring(4);
+        int pushed = 0;
+        for (int i = 0; i < 6; ++i) {
+            pushed += ring.tryPush([i](int& slot) { slot = i; });
+        }
+        std::vector<int> popped;
+        int value;
+        while (ring.tryPop(value)) popped.push_back(value);
+        const bool refilled = ring.tryPush([](int& slot) { slot = 9; }) && ring.tryPop(value) && value == 9;
+        allPassed &= printTestStatus("Test 1: Ring buffer order and capacity",
+            ring.capacity() == 4 && pushed == 4 && popped == std::vector<int>({0, 1, 2, 3}) && refilled);
+    }
+
+    // Test Case 2: Concurrent producers and a consumer lose and duplicate nothing
+    {
+        RingBuffer<int> ring(64);
+        constexpr int kProducers = 4, kPerProducer = 5000;
+        std::atomic<int> producersDone{0};
+        std::vector<std::thread> producers;
+        for (int p = 0; p < kProducers; ++p) {
+            producers.emplace_back([&, p]() {
+                for (int i = 0; i < kPerProducer; ++i) {
+                    const int v = p * kPerProducer + i;
+                    while (!ring.tryPush([v](int& slot) { slot = v; })) std::this_thread::yield();
+                }
+                ++producersDone;
+            });
+        }
+        std::set<int> seen;
+        int value;
+        while (producersDone.load() < kProducers) {
+            if (ring.tryPop(value)) {
+                seen.insert(value);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        for (auto& t : producers) t.join();
+        while (ring.tryPop(value)) seen.insert(value); // Whatever was left after the last push
+        allPassed &= printTestStatus("Test 2: Concurrent producers",
+            seen.size() == kProducers * kPerProducer && *seen.begin() == 0 &&
+            *seen.rbegin() == kProducers * kPerProducer - 1);
+    }
+
+    // Test Case 3: Records come out as logfmt lines, in order, once flushed
+    {
+        std::ostringstream sink;
+        Logger logger(sink);
+        logger.log(LogLevel::Info, "ReadListDB", "Book added to read list", "Dune");
+        logger.log(LogLevel::Error, "LoanRequestDB", "Loan records added", int64_t{42});
+        logger.flush();
+        const std::string text = sink.str();
+        const size_t first = text.find("msg=\"Book added to read list\" detail=Dune\n");
+        const size_t second = text.find("level=error component=LoanRequestDB msg=\"Loan records added\" value=42\n");
+        allPassed &= printTestStatus("Test 3: Structured lines",
+            text.compare(0, 3, "ts=") == 0 && contains(text, "Z level=info component=ReadListDB ") &&
+            first != std::string::npos && second != std::string::npos && first < second &&
+            logger.stats().written == 2);
+    }
+
+    // Test Case 4: Details are quoted and escaped, and cut at kDetailBytes
+    {
+        std::ostringstream sink;
+        Logger logger(sink);
+        logger.log(LogLevel::Warn, "Test", "Quoted", "say \"hi\"\nthen leave");
+        logger.log(LogLevel::Warn, "Test", "Long", std::string(500, 'x'));
+        logger.flush();
+        const std::string text = sink.str();
+        allPassed &= printTestStatus("Test 4: Escaping and truncation",
+            contains(text, "detail=\"say \\\"hi\\\"\\nthen leave\"\n") &&
+            contains(text, "detail=" + std::string(Logger::kDetailBytes, 'x') + " truncated=true\n"));
+    }
+
+    // Test Case 5: The runtime level filters records before they are queued
+    {
+        std::ostringstream sink;
+        Logger logger(sink);
+        logger.setLevel(LogLevel::Warn);
+        logger.log(LogLevel::Info, "Test", "Hidden");
+        logger.log(LogLevel::Error, "Test", "Shown");
+        logger.flush();
+        allPassed &= printTestStatus("Test 5: Runtime level",
+            !contains(sink.str(), "Hidden") && contains(sink.str(), "Shown") && logger.stats().written == 1);
+    }
+
+    // Test Case 6: Calls below the compile-time level don't even evaluate their arguments
+    {
+        int evaluated = 0;
+        auto detail = [&evaluated]() { ++evaluated; return std::string("side effect"); };
+        LOG_DEBUG("Test", "Compiled out unless LIBRARY_LOG_LEVEL=DEBUG", detail());
+        LOG_ERROR("Test", "Always compiled in", detail());
+        Logger::global().flush();
+        const int expected = kMinLogLevel <= LogLevel::Debug ? 2 : 1;
+        allPassed &= printTestStatus("Test 6: Compile-time level", evaluated == expected);
+    }
+
+    // Test Case 7: Everything queued is written when the logger is destroyed
+    {
+        std::ostringstream sink;
+        {
+            Logger logger(sink, 8192);
+            for (int i = 0; i < 5000; ++i) {
+                logger.log(LogLevel::Info, "Test", "Bulk", int64_t{i});
+            }
+        }
+        allPassed &= printTestStatus("Test 7: Drained on shutdown", contains(sink.str(), " value=4999\n"));
+    }
+
+    std::cout << "\n--- Automated Logger Tests Complete ---\n";
+    return allPassed ? 0 : 1;
+}
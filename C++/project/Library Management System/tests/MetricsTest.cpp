@@ -0,0 +1,141 @@
+#include "Metrics.h"                // Include the metrics you want to test
+#include "MetricsDumper.h"
+#include "ReadListDB.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>                   // For std::remove
+#include <filesystem>               // For creating the data folder
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Define DATA_DIR macro if it's not picked up from CMake for standalone test
+#ifndef DATA_DIR
+#define DATA_DIR "data"
+#endif
+
+using namespace std::chrono_literals;
+
+// Helper function to print a test status
+static bool printTestStatus(const std::string& testName, bool passed) {
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << std::endl;
+    return passed;
+}
+
+static std::string readFile(const std::string& path) {
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+int main() {
+    std::cout << "--- Running Automated Metrics Tests ---\n\n";
+    bool allPassed = true;
+
+    // Test Case 1: Buckets tile the number line and are at most 25% wide
+    {
+        bool ok = true;
+        for (size_t b = 0; b + 1 < LatencyHistogram::kBuckets; ++b) {
+            ok &= LatencyHistogram::bucketUpperNs(b) == LatencyHistogram::bucketLowerNs(b + 1);
+            ok &= LatencyHistogram::bucketOf(LatencyHistogram::bucketLowerNs(b)) == b;
+            ok &= LatencyHistogram::bucketOf(LatencyHistogram::bucketUpperNs(b) - 1) == b;
+            if (b >= 4) {
+                ok &= (LatencyHistogram::bucketUpperNs(b) - LatencyHistogram::bucketLowerNs(b)) * 4 <=
+                      LatencyHistogram::bucketLowerNs(b);
+            }
+        }
+        ok &= LatencyHistogram::bucketOf(UINT64_MAX) == LatencyHistogram::kBuckets - 1;
+        allPassed &= printTestStatus("Test 1: Bucket layout", ok);
+    }
+
+    // Test Case 2: Quantiles land within a bucket's width of the true value
+    {
+        LatencyHistogram h;
+        for (int i = 1; i <= 1000; ++i) {
+            h.record(std::chrono::microseconds(i)); // Uniform 1..1000 µs
+        }
+        auto s = h.snapshot();
+        auto near = [](uint64_t got, double want) { return got >= want * 0.75 && got <= want * 1.25; };
+        allPassed &= printTestStatus("Test 2: Quantile estimates",
+            s.count == 1000 && near(s.quantileNs(0.5), 500e3) && near(s.quantileNs(0.99), 990e3) &&
+            s.quantileNs(1.0) <= 1000000 && s.maxNs == 1000000 && s.meanNs() == 500500.0);
+    }
+
+    // Test Case 3: Concurrent recording loses nothing
+    {
+        LatencyHistogram h;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&h, t]() {
+                for (int i = 0; i < 10000; ++i) h.record(std::chrono::nanoseconds(100 * (t + 1)));
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        auto s = h.snapshot();
+        allPassed &= printTestStatus("Test 3: Concurrent recording",
+            s.count == 80000 && s.sumNs == 100ull * 10000 * 36 && s.maxNs == 800);
+    }
+
+    // Test Case 4: Database work is timed per prepare and per step
+    {
+        metrics::resetAll();
+        std::filesystem::create_directories(DATA_DIR);
+        const std::string dbPath = DATA_DIR "/test_metrics_readlist.db";
+        std::remove(dbPath.c_str());
+        {
+            ReadListDB db(dbPath);
+            OnlineBook dune;
+            dune.title = "Dune";
+            dune.workKey = "OL893415W";
+            db.insertBook(dune);
+            db.exists("OL893415W");
+        }
+        std::remove(dbPath.c_str());
+        allPassed &= printTestStatus("Test 4: Database stages recorded",
+            metrics::snapshot(Stage::DbPrepare).count > 0 && metrics::snapshot(Stage::DbStep).count >= 2);
+    }
+
+    // Test Case 5: Prometheus export has cumulative buckets, sum, count and quantiles per stage
+    {
+        metrics::resetAll();
+        metrics::histogram(Stage::Http).record(3ms);
+        metrics::histogram(Stage::Http).record(200ms);
+        std::ostringstream out;
+        metrics::writePrometheus(out);
+        const std::string text = out.str();
+        allPassed &= printTestStatus("Test 5: Prometheus text format",
+            text.find("# TYPE library_stage_latency_seconds histogram") != std::string::npos &&
+            text.find("library_stage_latency_seconds_bucket{stage=\"http\",le=\"0.004194304\"} 1\n") != std::string::npos &&
+            text.find("library_stage_latency_seconds_bucket{stage=\"http\",le=\"+Inf\"} 2\n") != std::string::npos &&
+            text.find("library_stage_latency_seconds_count{stage=\"http\"} 2\n") != std::string::npos &&
+            text.find("library_stage_latency_seconds_sum{stage=\"http\"} 0.203\n") != std::string::npos &&
+            text.find("library_stage_latency_seconds_count{stage=\"borrow_book\"} 0\n") != std::string::npos &&
+            text.find("library_stage_latency_quantile_seconds{stage=\"http\",quantile=\"0.99\"}") != std::string::npos);
+    }
+
+    // Test Case 6: The dumper writes on SIGUSR1 and once more when it goes away
+    {
+        std::filesystem::create_directories(DATA_DIR);
+        const std::string path = DATA_DIR "/test_metrics.prom";
+        std::remove(path.c_str());
+        bool dumpedOnSignal = false;
+        {
+            MetricsDumper dumper(path);
+            std::raise(SIGUSR1);
+            for (int i = 0; i < 50 && dumper.dumps() == 0; ++i) std::this_thread::sleep_for(20ms);
+            dumpedOnSignal = dumper.dumps() == 1 && std::filesystem::exists(path);
+            metrics::histogram(Stage::Search).record(1ms);
+        }
+        const std::string text = readFile(path);
+        std::remove(path.c_str());
+        allPassed &= printTestStatus("Test 6: Dump on signal and at exit",
+            dumpedOnSignal && text.find("library_stage_latency_seconds_count{stage=\"search\"} 1\n") != std::string::npos);
+    }
+
+    std::cout << "\n--- Automated Metrics Tests Complete ---\n";
+    return allPassed ? 0 : 1;
+}
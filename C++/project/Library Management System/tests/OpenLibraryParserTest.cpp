@@ -0,0 +1,77 @@
+#include "OpenLibraryParser.h"     // Include the parser you want to test
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Helper function to print a test status
+static bool printTestStatus(const std::string& testName, bool passed) {
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << std::endl;
+    return passed;
+}
+
+// A trimmed-down search.json response, including fields the parser must skip.
+static const char* kSearchResponse = R"({
+  "numFound": 2,
+  "start": 0,
+  "docs": [
+    {
+      "key": "/works/OL262758W",
+      "title": "The Hobbit",
+      "author_name": ["J.R.R. Tolkien", "Someone Else"],
+      "first_publish_year": 1937,
+      "cover_i": 14627509,
+      "subject": ["Fantasy", "Dragons", "Wizards", "Dwarves", "Elves", "Trolls"],
+      "ratings": {"average": 4.2, "counts": [1, 2, 3]},
+      "ia": [["nested", "array"]]
+    },
+    {
+      "title": "Untitled Manuscript",
+      "author_name": []
+    }
+  ],
+  "q": "the hobbit"
+})";
+
+int main() {
+    std::cout << "--- Running Automated OpenLibraryParser Tests ---\n\n";
+    bool allPassed = true;
+
+    OpenLibraryParser parser(4);
+
+    // Test Case 1: Fields are mapped and limits applied
+    std::vector<OnlineBook> books;
+    bool ok = parser.parse(std::string(kSearchResponse), books);
+    allPassed &= printTestStatus("Test 1: Parses docs array", ok && books.size() == 2);
+    if (books.size() == 2) {
+        const auto& b = books[0];
+        allPassed &= printTestStatus("Test 2: Maps fields of a full doc",
+            b.title == "The Hobbit" && b.author == "J.R.R. Tolkien" && b.publishYear == "1937" &&
+            b.coverId == 14627509 && b.workKey == "OL262758W");
+        allPassed &= printTestStatus("Test 2b: URLs built from the IDs",
+            b.coverUrl() == "https://covers.openlibrary.org/b/id/14627509-M.jpg" &&
+            b.openLibraryUrl() == "https://openlibrary.org/works/OL262758W");
+        allPassed &= printTestStatus("Test 3: Keeps only the first 4 subjects",
+            b.subjects.size() == 4 && b.subjects[3] == "Dwarves");
+
+        // Test Case 4: Missing fields fall back to the usual defaults
+        const auto& m = books[1];
+        allPassed &= printTestStatus("Test 4: Defaults for missing fields",
+            m.author == "Unknown Author" && m.publishYear == "N/A" && m.coverUrl().empty() && m.subjects.empty());
+    }
+
+    // Test Case 5: Stream input gives the same result
+    std::istringstream stream(kSearchResponse);
+    std::vector<OnlineBook> streamed;
+    allPassed &= printTestStatus("Test 5: Parses from a stream",
+        parser.parse(stream, streamed) && streamed.size() == 2 && streamed[0].title == "The Hobbit");
+
+    // Test Case 6: Invalid or unexpected bodies are rejected without output
+    std::vector<OnlineBook> none;
+    allPassed &= printTestStatus("Test 6: Rejects truncated JSON",
+        !parser.parse(std::string(R"({"docs": [{"title": "Cut)"), none) && none.empty());
+    allPassed &= printTestStatus("Test 7: Rejects body without docs",
+        !parser.parse(std::string(R"({"error": "rate limited"})"), none) && none.empty());
+
+    std::cout << "\n--- Automated OpenLibraryParser Tests Complete ---\n";
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+#include "ReadListDB.h"            // Include the database class you want to test
+#include <iostream>
+#include <sstream>                 // For capturing exports
+#include <string>
+#include <cstdio>                  // For std::remove
+#include <filesystem>              // For creating the data folder
+
+// Define DATA_DIR macro if it's not picked up from CMake for standalone test
+#ifndef DATA_DIR
+#define DATA_DIR "data"
+#endif
+
+// Helper function to print a test status
+static bool printTestStatus(const std::string& testName, bool passed) {
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << std::endl;
+    return passed;
+}
+
+static OnlineBook makeBook(const std::string& title, const std::string& author,
+                           std::vector<std::string> subjects) {
+    OnlineBook b;
+    b.title = title;
+    b.author = author;
+    b.publishYear = "1950";
+    b.subjects = std::move(subjects);
+    static int nextKey = 1;
+    b.workKey = "OL" + std::to_string(nextKey++) + "W";
+    return b;
+}
+
+// Builds a read list in the version 1 layout (comma-joined genres, no
+// uniqueness), including one book saved twice.
+static void writeVersion1File(const std::string& path) {
+    std::remove(path.c_str());
+    sqlite3* db = nullptr;
+    sqlite3_open(path.c_str(), &db);
+    sqlite3_exec(db, R"(
+        CREATE TABLE read_list (id INTEGER PRIMARY KEY AUTOINCREMENT, title TEXT NOT NULL,
+                                author TEXT, publish_year TEXT, genres TEXT, url TEXT);
+        INSERT INTO read_list (title, author, publish_year, genres, url) VALUES
+            ('The Hobbit', 'J.R.R. Tolkien', '1937', 'Fantasy, Dragons', 'https://openlibrary.org/works/OL262758W'),
+            ('Dune', 'Frank Herbert', '1965', 'Science Fiction', 'https://openlibrary.org/works/OL893415W'),
+            ('The Hobbit', 'J.R.R. Tolkien', '1937', 'Fantasy, Dragons', 'https://openlibrary.org/works/OL262758W');
+    )", nullptr, nullptr, nullptr);
+    sqlite3_close(db);
+}
+
+int main() {
+    std::cout << "--- Running Automated ReadListDB Tests ---\n\n";
+    bool allPassed = true;
+
+    std::filesystem::create_directories(DATA_DIR);
+    const std::string dbPath = DATA_DIR "/test_readlist_unit.db";
+    std::remove(dbPath.c_str()); // Start from an empty database
+
+    ReadListDB db(dbPath);
+
+    db.beginBatch();
+    OnlineBook hobbit = makeBook("The Hobbit", "J.R.R. Tolkien", {"Fantasy", "Adventure"});
+    db.insertBook(hobbit);
+    db.insertBook(makeBook("Dune", "Frank Herbert", {"Science Fiction"}));
+    db.insertBook(makeBook("Tolkien: A Biography", "Humphrey Carpenter", {"Biography"}));
+    db.commitBatch();
+
+    if (db.hasLocalSearch()) {
+        // Test Case 1: Word prefixes match, case-insensitively
+        auto hits = db.searchLocal("hob");
+        allPassed &= printTestStatus("Test 1: Prefix search",
+            hits.size() == 1 && hits[0].title == "The Hobbit" && hits[0].subjects.size() == 2);
+
+        // Test Case 2: Title matches outrank author matches
+        hits = db.searchLocal("tolkien");
+        allPassed &= printTestStatus("Test 2: Title match ranked first",
+            hits.size() == 2 && hits[0].title == "Tolkien: A Biography");
+
+        // Test Case 3: Genres are searchable
+        hits = db.searchLocal("science");
+        allPassed &= printTestStatus("Test 3: Genre search", hits.size() == 1 && hits[0].title == "Dune");
+
+        // Test Case 4: Paging with limit/offset
+        auto page2 = db.searchLocal("tolkien", 1, 1);
+        allPassed &= printTestStatus("Test 4: Paging", page2.size() == 1 && page2[0].title == "The Hobbit");
+
+        // Test Case 5: FTS5 syntax in user input is treated as plain text
+        hits = db.searchLocal("\"dune OR (");
+        allPassed &= printTestStatus("Test 5: Query syntax is escaped", hits.empty());
+        hits = db.searchLocal("   ");
+        allPassed &= printTestStatus("Test 6: Blank query matches nothing", hits.empty());
+    } else {
+        std::cout << "This SQLite build has no FTS5; skipping local search tests.\n";
+    }
+
+    // Test Case 7: The same work can only be saved once
+    allPassed &= printTestStatus("Test 7: Duplicate work key rejected",
+        db.exists(hobbit.workKey) && !db.insertBook(hobbit) && db.countBooks() == 3 && !db.exists("OL0W"));
+
+    // Test Case 8: Newest first, paged, with subjects in their saved order
+    auto books = db.getBooks(2, 0);
+    auto rest = db.getBooks(2, 2);
+    allPassed &= printTestStatus("Test 8: getBooks paging",
+        books.size() == 2 && books[0].title == "Tolkien: A Biography" && books[1].title == "Dune" &&
+        rest.size() == 1 && rest[0].subjects == std::vector<std::string>{"Fantasy", "Adventure"});
+
+    // Test Case 9: Subject lookup ignores case
+    books = db.getBooksBySubject("science fiction");
+    allPassed &= printTestStatus("Test 9: getBooksBySubject",
+        books.size() == 1 && books[0].title == "Dune" && db.getBooksBySubject("Horror").empty());
+
+    // Test Case 10: Exports stream every row with its subjects
+    std::ostringstream csv, json;
+    bool exported = db.exportCsv(csv) && db.exportJson(json);
+    allPassed &= printTestStatus("Test 10: CSV and JSON export",
+        exported &&
+        csv.str().find("\nThe Hobbit,J.R.R. Tolkien,1950,Fantasy; Adventure,OL") != std::string::npos &&
+        csv.str().find("\"Tolkien: A Biography\"") == std::string::npos &&
+        json.str().find("\"subjects\":[\"Science Fiction\"]") != std::string::npos);
+
+    // Test Case 11: A version 1 file is migrated in place and deduplicated
+    {
+        const std::string legacyPath = DATA_DIR "/test_readlist_v1.db";
+        writeVersion1File(legacyPath);
+        ReadListDB legacy(legacyPath);
+        auto migrated = legacy.getBooksBySubject("Dragons");
+        allPassed &= printTestStatus("Test 11: Version 1 migration",
+            legacy.countBooks() == 2 && legacy.exists("OL262758W") &&
+            migrated.size() == 1 && migrated[0].subjects == std::vector<std::string>{"Fantasy", "Dragons"} &&
+            (!legacy.hasLocalSearch() || legacy.searchLocal("dragons").size() == 1));
+    }
+
+    std::cout << "\n--- Automated ReadListDB Tests Complete ---\n";
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+#include "RecommenderService.h"     // Include the service you want to test
+#include "HttpClient.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <iostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Helper function to print a test status
+static bool printTestStatus(const std::string& testName, bool passed) {
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << std::endl;
+    return passed;
+}
+
+// A search.json body listing the given works, in order. Work i is "/works/OL<i>W"
+// with first_publish_year years[i].
+static std::string docsBody(const std::vector<std::pair<int, int>>& worksAndYears) {
+    std::string body = R"({"docs":[)";
+    for (size_t i = 0; i < worksAndYears.size(); ++i) {
+        if (i > 0) body += ',';
+        const std::string id = std::to_string(worksAndYears[i].first);
+        body += R"({"key":"/works/OL)" + id + R"(W","title":"Book )" + id +
+                R"(","author_name":["Some Author"],"first_publish_year":)" +
+                std::to_string(worksAndYears[i].second) + "}";
+    }
+    return body + "]}";
+}
+
+// Local server answering a request whose path contains a subject's name with
+// that subject's body, one request per connection: a stand-in for Open Library.
+class SubjectServer {
+public:
+    explicit SubjectServer(std::vector<std::pair<std::string, std::string>> bodies) : bodies_(std::move(bodies)) {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        listen(fd_, 16);
+        socklen_t len = sizeof(addr);
+        getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        acceptor_ = std::thread([this]() { serve(); });
+    }
+    ~SubjectServer() {
+        shutdown(fd_, SHUT_RDWR); // Wakes the blocked accept()
+        acceptor_.join();
+        close(fd_);
+    }
+
+    std::string baseUrl() const { return "http://127.0.0.1:" + std::to_string(port_); }
+    int requests() const { return requests_.load(); }
+
+private:
+    std::vector<std::pair<std::string, std::string>> bodies_;
+    int fd_ = -1;
+    unsigned short port_ = 0;
+    std::atomic<int> requests_{0};
+    std::thread acceptor_;
+
+    void serve() {
+        int client;
+        while ((client = accept(fd_, nullptr, nullptr)) >= 0) {
+            std::string request;
+            char buf[1024];
+            ssize_t n;
+            while (request.find("\r\n\r\n") == std::string::npos && (n = read(client, buf, sizeof(buf))) > 0) {
+                request.append(buf, static_cast<size_t>(n));
+            }
+            ++requests_;
+            const std::string path = request.substr(0, request.find("\r\n"));
+            std::string status = "404 Not Found", body = "{}";
+            for (const auto& [subject, subjectBody] : bodies_) {
+                if (path.find(subject) != std::string::npos) {
+                    status = "200 OK";
+                    body = subjectBody;
+                }
+            }
+            const std::string response = "HTTP/1.1 " + status + "\r\nContent-Type: application/json\r\n"
+                                         "Connection: close\r\nContent-Length: " + std::to_string(body.size()) +
+                                         "\r\n\r\n" + body;
+            send(client, response.data(), response.size(), MSG_NOSIGNAL);
+            close(client);
+        }
+    }
+};
+
+static HttpClientOptions optionsFor(const SubjectServer& server) {
+    HttpClientOptions options;
+    options.baseUrl = server.baseUrl();
+    options.http2 = false;
+    options.rateLimit.requestsPerSecond = 0;
+    options.retry.maxRetries = 0;
+    return options;
+}
+
+// Every page of `subjects` in AnySubject mode, `limit` at a time, back to back.
+static std::vector<OnlineBook> allPages(const RecommenderService& recommender, const std::vector<std::string>& subjects,
+                                        size_t limit) {
+    std::vector<OnlineBook> books;
+    for (size_t offset = 0;; offset += limit) {
+        auto page = recommender.recommend(subjects, limit, offset, RecommendMode::AnySubject);
+        if (page.empty()) return books;
+        books.insert(books.end(), page.begin(), page.end());
+    }
+}
+
+int main() {
+    std::cout << "--- Running Automated RecommenderService Tests ---\n\n";
+    bool allPassed = true;
+
+    // Alpha lists works 0-29, Beta works 20-49, so works 20-29 match both.
+    // Deeper ranks are newer, the case where a ranking over a growing window
+    // let later pages pull books ahead of ones already shown.
+    std::vector<std::pair<int, int>> alpha, beta;
+    for (int i = 0; i < 30; ++i) alpha.emplace_back(i, 1900 + i);
+    for (int i = 20; i < 50; ++i) beta.emplace_back(i, 1900 + i);
+
+    // Test Case 1: Paging an AnySubject query shows every merged book exactly
+    // once, shared books first, and fetches each subject once
+    {
+        SubjectServer server({{"Alpha", docsBody(alpha)}, {"Beta", docsBody(beta)}});
+        HttpClient http(optionsFor(server));
+        RecommenderService recommender(&http);
+        const auto books = allPages(recommender, {"Alpha", "Beta"}, 7);
+
+        std::set<std::string> seen;
+        bool noDuplicates = true;
+        for (const auto& b : books) noDuplicates &= seen.insert(b.workKey).second;
+        bool sharedFirst = books.size() == 50;
+        for (size_t i = 0; sharedFirst && i < 10; ++i) sharedFirst = books[i].workKey == "OL" + std::to_string(29 - i) + "W";
+        allPassed &= printTestStatus("Test 1: AnySubject pages have no duplicates or gaps",
+            noDuplicates && seen.size() == 50 && sharedFirst && server.requests() == 2);
+    }
+
+    // Test Case 2: The merged ranking is kept per subject list, so paging a
+    // second list fetches again and the first list's pages stay as they were
+    {
+        SubjectServer server({{"Alpha", docsBody(alpha)}, {"Beta", docsBody(beta)}, {"Gamma", docsBody({{7, 2001}})}});
+        HttpClient http(optionsFor(server));
+        RecommenderService recommender(&http);
+        const auto first = recommender.recommend({"Alpha", "Beta"}, 5, 5, RecommendMode::AnySubject);
+        const auto other = recommender.recommend({"Alpha", "Gamma"}, 5, 0, RecommendMode::AnySubject);
+        const auto again = recommender.recommend({"Alpha", "Beta"}, 5, 5, RecommendMode::AnySubject);
+        bool same = first.size() == 5 && again.size() == 5;
+        for (size_t i = 0; same && i < first.size(); ++i) same = first[i].workKey == again[i].workKey;
+        allPassed &= printTestStatus("Test 2: Rankings cached per subject list",
+            same && !other.empty() && other[0].workKey == "OL7W" && server.requests() == 4);
+    }
+
+    // Test Case 3: A ranking missing a subject (its request failed) is not
+    // kept, so the next page asks again
+    {
+        SubjectServer server({{"Alpha", docsBody(alpha)}}); // Beta answers 404
+        HttpClient http(optionsFor(server));
+        RecommenderService recommender(&http);
+        const auto page1 = recommender.recommend({"Alpha", "Beta"}, 5, 0, RecommendMode::AnySubject);
+        const auto page2 = recommender.recommend({"Alpha", "Beta"}, 5, 5, RecommendMode::AnySubject);
+        allPassed &= printTestStatus("Test 3: Partial rankings are not cached",
+            page1.size() == 5 && page2.size() == 5 && server.requests() == 4);
+    }
+
+    // Test Case 4: A 200 whose body is not JSON, or is cut off mid-document,
+    // counts as a failed request rather than a short list
+    {
+        const std::string full = docsBody(beta);
+        SubjectServer server({{"Alpha", docsBody(alpha)}, {"Garbled", "<html>Service Unavailable</html>"},
+                              {"Truncated", full.substr(0, full.size() / 2)}});
+        HttpClient http(optionsFor(server));
+        RecommenderService recommender(&http);
+        const bool allModeEmpty = recommender.recommend({"Garbled"}).empty() &&
+                                  recommender.recommend({"Truncated"}).empty();
+        const auto page1 = recommender.recommend({"Alpha", "Truncated"}, 5, 0, RecommendMode::AnySubject);
+        const auto page2 = recommender.recommend({"Alpha", "Truncated"}, 5, 5, RecommendMode::AnySubject);
+        allPassed &= printTestStatus("Test 4: Unreadable bodies are failures",
+            allModeEmpty && page1.size() == 5 && page1[0].workKey == "OL29W" && page2.size() == 5 &&
+            server.requests() == 6); // The partial ranking was not kept
+    }
+
+    std::cout << "\n--- Automated RecommenderService Tests Complete ---\n";
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+#include "SearchCache.h"          // Include the cache you want to test
+#include <iostream>
+#include <string>
+#include <cstdio>                  // For std::remove
+#include <filesystem>              // For creating the data folder
+
+// Define DATA_DIR macro if it's not picked up from CMake for standalone test
+#ifndef DATA_DIR
+#define DATA_DIR "data"
+#endif
+
+// Helper function to print a test status
+static bool printTestStatus(const std::string& testName, bool passed) {
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << std::endl;
+    return passed;
+}
+
+static std::vector<OnlineBook> sampleBooks() {
+    OnlineBook b;
+    b.title = "The Hobbit";
+    b.author = "J.R.R. Tolkien";
+    b.publishYear = "1937";
+    b.subjects = {"Fantasy", "Adventure"};
+    b.coverId = 14627509;
+    b.workKey = "OL262758W";
+    return {b};
+}
+
+int main() {
+    std::cout << "--- Running Automated SearchCache Tests ---\n\n";
+    bool allPassed = true;
+
+    std::filesystem::create_directories(DATA_DIR);
+    const std::string cacheDbPath = DATA_DIR "/test_search_cache.db";
+    std::remove(cacheDbPath.c_str()); // Start from an empty on-disk tier
+
+    // Test Case 1: Keys are normalized, so spacing and case do not matter
+    allPassed &= printTestStatus("Test 1: Key normalization",
+        SearchCache::makeKey("  The   Hobbit ", 5, 0) == SearchCache::makeKey("the hobbit", 5, 0) &&
+        SearchCache::makeKey("the hobbit", 5, 0) != SearchCache::makeKey("the hobbit", 5, 5));
+
+    const std::string key = SearchCache::makeKey("The Hobbit", 5, 0);
+    {
+        SearchCache cache(cacheDbPath);
+
+        // Test Case 2: An empty cache misses
+        allPassed &= printTestStatus("Test 2: Miss on empty cache",
+            !cache.get(key).has_value() && cache.stats().misses == 1);
+
+        // Test Case 3: A stored entry is served from memory
+        cache.put(key, sampleBooks());
+        auto hit = cache.get(key);
+        allPassed &= printTestStatus("Test 3: Memory hit after put",
+            hit && hit->size() == 1 && (*hit)[0].subjects.size() == 2 && cache.stats().memoryHits == 1);
+    }
+
+    // Test Case 4: A fresh cache on the same file is served from disk
+    {
+        SearchCache cache(cacheDbPath);
+        auto hit = cache.get(key);
+        allPassed &= printTestStatus("Test 4: Disk hit survives restart",
+            hit && (*hit)[0].title == "The Hobbit" && cache.stats().diskHits == 1);
+
+        // The disk hit was promoted, so the next lookup stays in memory.
+        cache.get(key);
+        allPassed &= printTestStatus("Test 5: Disk hit promoted to memory", cache.stats().memoryHits == 1);
+    }
+
+    // Test Case 6: The LRU evicts the least recently used entry when full
+    {
+        SearchCacheOptions options;
+        options.memoryCapacity = 2;
+        SearchCache cache("", options); // Memory-only
+        cache.put("a", sampleBooks());
+        cache.put("b", sampleBooks());
+        cache.get("a");                 // "b" is now least recently used
+        cache.put("c", sampleBooks());
+        allPassed &= printTestStatus("Test 6: LRU eviction",
+            cache.get("a").has_value() && !cache.get("b").has_value() && cache.stats().evictions == 1);
+    }
+
+    // Test Case 7: Entries past their TTL are treated as misses
+    {
+        SearchCacheOptions options;
+        options.ttl = std::chrono::seconds(0);
+        SearchCache cache("", options);
+        cache.put(key, sampleBooks());
+        allPassed &= printTestStatus("Test 7: Expired entry misses", !cache.get(key).has_value());
+
+        // Test Case 9: ...but is still there as a fallback for when Open Library is down
+        auto stale = cache.getStale(key);
+        allPassed &= printTestStatus("Test 9: Expired entry served as stale fallback",
+            stale && (*stale)[0].title == "The Hobbit" && cache.stats().staleHits == 1 &&
+            !cache.getStale("never stored"));
+    }
+
+    // Test Case 8: Results stay intact after evictions force the string pool to be rebuilt
+    {
+        SearchCacheOptions options;
+        options.memoryCapacity = 2;
+        SearchCache cache("", options);
+        for (int i = 0; i < 100; ++i) {
+            auto books = sampleBooks();
+            for (int s = 0; s < 100; ++s) {
+                books[0].subjects.push_back("Subject " + std::to_string(i) + "." + std::to_string(s));
+            }
+            cache.put("page" + std::to_string(i), books);
+        }
+        auto hit = cache.get("page99");
+        allPassed &= printTestStatus("Test 8: Entries survive pool compaction",
+            hit && (*hit)[0].author == "J.R.R. Tolkien" && (*hit)[0].subjects.size() == 102 &&
+            (*hit)[0].subjects.back() == "Subject 99.99" && (*hit)[0].workKey == "OL262758W");
+    }
+
+    // Test Case 10: Opening the cache purges disk rows past the stale retention,
+    // but keeps expired rows still inside it for getStale()
+    {
+        const std::string purgeDbPath = DATA_DIR "/test_search_cache_purge.db";
+        std::remove(purgeDbPath.c_str());
+        SearchCacheOptions options;
+        options.ttl = std::chrono::seconds(0);
+        {
+            SearchCache cache(purgeDbPath, options);
+            cache.put("kept", sampleBooks());
+        }
+        bool keptWithinRetention = false;
+        {
+            SearchCache cache(purgeDbPath, options); // Default retention: a week
+            keptWithinRetention = cache.getStale("kept").has_value();
+        }
+        options.staleRetention = std::chrono::seconds(0);
+        {
+            SearchCache cache(purgeDbPath, options);
+        }
+        options.staleRetention = std::chrono::hours(24 * 7);
+        SearchCache cache(purgeDbPath, options); // Would serve the row if it were still there
+        allPassed &= printTestStatus("Test 10: Old rows purged on open, recent ones kept for stale use",
+            keptWithinRetention && !cache.getStale("kept").has_value());
+    }
+
+    std::cout << "\n--- Automated SearchCache Tests Complete ---\n";
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+#include "StringUtils.h"  // Include the kernels you want to test
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Helper function to print a test status
+static bool printTestStatus(const std::string& testName, bool passed) {
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << std::endl;
+    return passed;
+}
+
+// Byte-at-a-time references the kernels must agree with.
+static std::string referenceTitle(const std::string& s) {
+    std::string out;
+    for (unsigned char c : s) {
+        if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) {
+            out += static_cast<char>(c);
+        } else if (c >= 'A' && c <= 'Z') {
+            out += static_cast<char>(c - 'A' + 'a');
+        } else if (!out.empty() && out.back() != ' ') {
+            out += ' ';
+        }
+    }
+    if (!out.empty() && out.back() == ' ') out.pop_back();
+    return out;
+}
+
+static std::string referenceQuery(const std::string& s) {
+    std::string lowered = s;
+    for (auto& c : lowered) c = util::toLowerAscii(c);
+    std::istringstream iss(lowered);
+    std::string word, out;
+    while (iss >> word) {
+        if (!out.empty()) out += ' ';
+        out += word;
+    }
+    return out;
+}
+
+// Mostly letters, with the bytes that matter to the kernels mixed in.
+static std::string randomText(std::mt19937& rng, size_t maxLength) {
+    static const std::string kBytes = "aZ09 \t\n\v\f\r:;-!@[`{~\x7f\x80\xc3\xa9\xff";
+    std::uniform_int_distribution<size_t> length(0, maxLength), pick(0, kBytes.size() - 1);
+    std::uniform_int_distribution<int> letter(0, 51), kind(0, 3);
+    std::string s(length(rng), ' ');
+    for (auto& c : s) {
+        if (kind(rng) == 0) {
+            c = kBytes[pick(rng)];
+        } else {
+            const int l = letter(rng);
+            c = static_cast<char>(l < 26 ? 'a' + l : 'A' + l - 26);
+        }
+    }
+    return s;
+}
+
+int main() {
+    std::cout << "--- Running Automated StringUtils Tests ---\n\n";
+    bool allPassed = true;
+    std::mt19937 rng(424242);
+
+    const util::SimdLevel best = util::simdLevel();
+    std::cout << "Widest kernel on this CPU: " << util::simdLevelName(best) << "\n";
+    const std::vector<util::SimdLevel> levels = {util::SimdLevel::Scalar, util::SimdLevel::SSE2, util::SimdLevel::AVX2};
+
+    // Test Case 1: Every kernel width gives the reference results, on texts
+    // around and past the 16/32-byte blocks, in place and copied
+    {
+        std::vector<std::string> texts;
+        for (int i = 0; i < 3000; ++i) texts.push_back(randomText(rng, 100));
+        texts.push_back(std::string(64, 'A') + "  " + std::string(40, 'b')); // Whole-word blocks
+        texts.push_back("   ---   ");
+        bool same = true;
+        for (auto level : levels) {
+            util::setSimdLevel(level);
+            for (const auto& text : texts) {
+                std::string lowered = text, title = text, query = text;
+                util::toLowerAsciiInPlace(lowered.data(), lowered.size());
+                const std::string_view titleView = util::normalizeTitleInPlace(title.data(), title.size());
+                const std::string_view queryView = util::normalizeQueryInPlace(query.data(), query.size());
+                std::string expectedLower = text;
+                for (auto& c : expectedLower) c = util::toLowerAscii(c);
+                same &= lowered == expectedLower && titleView == referenceTitle(text) &&
+                        titleView.data() == title.data() && queryView == referenceQuery(text) &&
+                        util::normalizeTitle(text) == referenceTitle(text);
+            }
+        }
+        util::setSimdLevel(best);
+        allPassed &= printTestStatus("Test 1: Kernels match the byte loop at every width", same);
+    }
+
+    // Test Case 2: Trim and lowercase keep their old behavior, ASCII only
+    allPassed &= printTestStatus("Test 2: trim and toLower",
+        util::trim("  The Hobbit\n") == "The Hobbit" && util::trim(" \t ").empty() &&
+        util::trimView("\rDune ") == "Dune" && util::toLower("Émile ZOLA") == "Émile zola" &&
+        util::normalizeTitle("  The Lord of the Rings: Return of the King!  ") == "the lord of the rings return of the king");
+
+    // Test Case 3: Unicode case folding
+    allPassed &= printTestStatus("Test 3: Case folding",
+        util::foldCase("ÉMILE ZOLA") == "émile zola" &&
+        util::foldCase("Die Straße") == "die strasse" &&
+        util::foldCase("ΟΔΥΣΣΕΙΑ Ὀδύσσεια") == "οδυσσεια Ὀδύσσεια" &&   // Polytonic letters are left alone
+        util::foldCase("ΟΔΎΣΣΕΙΑΣ") == util::foldCase("οδύσσειας") &&      // ς and Σ both fold to σ
+        util::foldCase("ВОЙНА И МИР, ЁЖ") == "война и мир, ёж" &&
+        util::foldCase("ŁÓDŹ ĲSSEL Ÿ") == "łódź ĳssel ÿ" &&
+        util::foldCase("日本 ABC \xff\xc3") == "日本 abc \xff\xc3" &&          // Other scripts and bad bytes pass through
+        util::foldCase(std::string(100, 'Q')) == std::string(100, 'q'));
+
+    // Test Case 4: Batch normalization matches one title at a time
+    {
+        std::vector<std::string> titles;
+        for (int i = 0; i < 500; ++i) titles.push_back(randomText(rng, 60));
+        titles.push_back("");
+        const util::NormalizedTitles batch = util::normalizeTitles(titles);
+        bool same = batch.size() == titles.size();
+        for (size_t i = 0; same && i < titles.size(); ++i) same &= batch[i] == referenceTitle(titles[i]);
+        allPassed &= printTestStatus("Test 4: Batch normalization", same && util::normalizeTitles({}).size() == 0);
+    }
+
+    // Test Case 5: Forcing a width is capped at what the CPU has
+    {
+        const bool capped = util::setSimdLevel(util::SimdLevel::AVX2) == best &&
+                            util::setSimdLevel(util::SimdLevel::Scalar) == util::SimdLevel::Scalar &&
+                            util::simdLevel() == util::SimdLevel::Scalar;
+        util::setSimdLevel(best);
+        allPassed &= printTestStatus("Test 5: Dispatch", capped && util::simdLevel() == best);
+    }
+
+    std::cout << "\n--- Automated StringUtils Tests Complete ---\n";
+    return allPassed ? 0 : 1;
+}